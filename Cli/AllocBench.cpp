@@ -0,0 +1,176 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../Engine/Allocations.h"
+#include "../Engine/Board.h"
+#include "../Engine/DirtyCells.h"
+#include "../Engine/Input.h"
+#include "../Engine/TileLod.h"
+#include "../Engine/TileMap.h"
+#include "Commands.h"
+
+namespace {
+   auto constexpr CELL_SIZE = 32;
+   // the first games grow the scratch to what a game needs; the rest must
+   // not allocate at all
+   auto constexpr WARM_UP_GAMES = 1;
+   auto constexpr GAMES = 4;
+
+   struct Step {
+      MouseButton button;
+      Pos cell;
+   };
+
+   // Opens the centre, flags every mine, then chords each number and clicks
+   // whatever is left, so the game is won through every kind of action.
+   std::vector<Step> Script(Board const& board) {
+      std::vector<Step> steps;
+      steps.push_back({ MouseButton::Left, { board.Width() / 2, board.Height() / 2 } });
+      for (auto y = 0; y < board.Height(); y++) {
+         for (auto x = 0; x < board.Width(); x++) {
+            if (board.At(x, y).IsMined()) steps.push_back({ MouseButton::Right, { x, y } });
+         }
+      }
+      for (auto y = 0; y < board.Height(); y++) {
+         for (auto x = 0; x < board.Width(); x++) {
+            if (!board.At(x, y).IsMined()) steps.push_back({ MouseButton::Left, { x, y } });
+         }
+      }
+      return steps;
+   }
+
+   // What the game keeps from frame to frame and game to game.
+   struct Frames {
+      DirtyCells dirty;
+      TileMap tiles;
+      TileLod lod;
+      InputQueue input;
+      InputDispatcher dispatcher;
+      std::vector<InputAction> actions;
+      std::vector<Pos> pressed;
+      std::vector<Pos> pressedBefore;
+      // instances a frame would copy to the device
+      std::size_t uploaded = 0;
+
+      explicit Frames(BoardSize size) :
+         dirty(size.width, size.height),
+         tiles(size.width, size.height),
+         lod(size.width, size.height) {}
+
+      // One update and one redraw, as Game::Update and Game::RenderFrame
+      // make them.
+      void Run(Board& board) {
+         pressedBefore.assign(pressed.begin(), pressed.end());
+         actions.clear();
+         InputEvent event;
+         while (input.Pop(event)) dispatcher.Apply(event, actions);
+         for (auto const& action : actions) {
+            auto cell = Pos{ action.x / CELL_SIZE, action.y / CELL_SIZE };
+            if (board.State() != GameState::Play || !board.Contains(cell.x, cell.y)) continue;
+            if (action.kind == InputActionKind::Click) dirty.Mark(board.Click(cell.x, cell.y).changed);
+            if (action.kind == InputActionKind::Mark) dirty.Mark(board.Flag(cell.x, cell.y).changed);
+         }
+
+         pressed.clear();
+         auto x = dispatcher.X() / CELL_SIZE;
+         auto y = dispatcher.Y() / CELL_SIZE;
+         if (dispatcher.Held(MouseButton::Left) && board.Contains(x, y)) {
+            board.IterateNear(x, y, [this, &board](int nearX, int nearY) {
+               if (!board.At(nearX, nearY).IsMarked()) pressed.push_back({ nearX, nearY });
+               });
+         }
+         dirty.Mark(pressedBefore);
+         dirty.Mark(pressed);
+
+         if (dirty.Empty()) return;
+         TileView view = { pressed, nullptr };
+         if (dirty.All()) {
+            tiles.Build(board, view);
+            lod.Build(tiles);
+         }
+         else {
+            tiles.Update(board, dirty.Cells(), view);
+            lod.Update(tiles, dirty.Cells());
+         }
+         dirty.Clear();
+         for (auto range : tiles.Changed()) uploaded += range.last - range.first;
+         for (auto level = 1; level <= lod.Levels(); level++) {
+            for (auto range : lod.Changed(level)) uploaded += range.last - range.first;
+         }
+         tiles.ClearChanged();
+         lod.ClearChanged();
+      }
+   };
+
+   struct GameAllocations {
+      std::size_t frames = 0;
+      std::size_t allocatingFrames = 0;
+      std::size_t uploaded = 0;
+      std::uint64_t allocations = 0;
+      GameState state = GameState::Play;
+   };
+
+   // Each step is two frames: the pointer moves over the cell and the
+   // button goes down, then it comes up and acts.
+   GameAllocations PlayScript(Frames& frames, Board& board, std::vector<Step> const& steps) {
+      GameAllocations result;
+      auto frame = [&] {
+         auto before = Allocations::ThisThread();
+         frames.Run(board);
+         auto made = Allocations::ThisThread() - before;
+         result.frames++;
+         result.allocations += made;
+         result.allocatingFrames += made > 0 ? 1 : 0;
+      };
+      frames.dirty.MarkAll();
+      frames.uploaded = 0;
+      for (auto const& step : steps) {
+         if (board.State() != GameState::Play) break;
+         auto x = step.cell.x * CELL_SIZE + CELL_SIZE / 2;
+         auto y = step.cell.y * CELL_SIZE + CELL_SIZE / 2;
+         auto code = std::uint8_t(step.button);
+         auto now = InputEvent::Clock::now();
+         frames.input.Push({ InputKind::PointerMove, 0, x, y, 0, now });
+         frames.input.Push({ InputKind::ButtonDown, code, x, y, 0, now });
+         frame();
+         frames.input.Push({ InputKind::ButtonUp, code, x, y, 0, InputEvent::Clock::now() });
+         frame();
+      }
+      result.state = board.State();
+      result.uploaded = frames.uploaded;
+      return result;
+   }
+}
+
+int RunAllocBench(std::span<char* const> args) {
+   if (!Allocations::Counting()) {
+      std::fprintf(stderr, "allocations are counted only in builds with MINESWEEPER_PROFILE defined\n");
+      return 1;
+   }
+   BoardSize size = { 30, 16, 99 };
+   if (args.size() >= 2) {
+      size.width = std::atoi(args[0]);
+      size.height = std::atoi(args[1]);
+      size.mines = args.size() >= 3 ? std::atoi(args[2]) : MinesFor(size.width, size.height, Difficulty::Medium);
+   }
+
+   Frames frames(size);
+   auto steady = std::uint64_t(0);
+   for (auto game = 0; game < GAMES; game++) {
+      // boards come prepared from the pool, off the frame
+      Board board(size, SafeZone::Cell, SplitMix64(game)());
+      board.Prepare();
+      auto steps = Script(board);
+      auto result = PlayScript(frames, board, steps);
+      auto warmUp = game < WARM_UP_GAMES;
+      if (!warmUp) steady += result.allocations;
+      std::printf("game %d %s: %zu frames, %zu instances uploaded, %llu allocations in %zu frames%s\n", game + 1,
+         result.state == GameState::Win ? "won" : "NOT WON", result.frames, result.uploaded,
+         static_cast<unsigned long long>(result.allocations), result.allocatingFrames, warmUp ? ", warming up" : "");
+      if (result.state != GameState::Win) return 1;
+   }
+   std::printf("%dx%d %d mines: %s\n", size.width, size.height, size.mines,
+      steady == 0 ? "no allocations after warming up  ok" : "ALLOCATES IN STEADY STATE");
+   return steady == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../Engine/AssetLoader.h"
+#include "../Engine/TaskPool.h"
+#include "../Engine/Wave.h"
+#include "Commands.h"
+
+namespace {
+   double Ms(AssetTiming::Duration duration) {
+      return std::chrono::duration<double, std::milli>(duration).count();
+   }
+
+   // The game's assets, the texture first as the game submits it.
+   std::vector<std::filesystem::path> Files(std::filesystem::path const& directory) {
+      std::vector<std::filesystem::path> files = { directory / "img/texture.png", directory / "sounds/defeat.wav", directory / "sounds/win.wav" };
+      for (auto i = 1; i <= 9; i++) files.push_back(directory / "sounds" / ("pig" + std::to_string(i) + ".wav"));
+      return files;
+   }
+
+   struct Run {
+      double criticalMs = 0;
+      double allMs = 0;
+      unsigned threads = 0;
+      double seconds = 0; // of sound decoded
+      std::vector<AssetTiming> timings;
+   };
+
+   // Loads everything the way Game::Init does: the texture is critical and
+   // only read here, the sounds are deferred and parsed.
+   Run Load(std::vector<std::filesystem::path> const& files, unsigned threads) {
+      TaskPool pool(threads);
+      std::vector<WaveFile> waves(files.size());
+      Run run;
+      run.threads = pool.Threads();
+      auto start = std::chrono::steady_clock::now();
+      {
+         AssetLoader loader(pool);
+         for (std::size_t i = 0; i < files.size(); i++) {
+            auto isSound = files[i].extension() == ".wav";
+            loader.Load(files[i].filename().string(), files[i], isSound ? AssetPriority::Deferred : AssetPriority::Critical,
+               [&wave = waves[i], isSound](FileBytes&& file) {
+                  if (isSound) wave = ParseWave(std::move(file.data), file.size);
+               });
+         }
+         loader.Wait(AssetPriority::Critical);
+         run.criticalMs = Ms(std::chrono::steady_clock::now() - start);
+         loader.Wait(AssetPriority::Deferred);
+         run.allMs = Ms(std::chrono::steady_clock::now() - start);
+         run.timings = loader.Timings();
+      }
+      for (auto const& wave : waves) run.seconds += wave.Seconds();
+      return run;
+   }
+
+   // Files that must be refused rather than read past their end.
+   bool CheckBadWaves() {
+      auto refused = 0;
+      std::vector<std::string> const bad = {
+         "",
+         std::string("RIFF\x04\0\0\0WAVE", 12),
+         std::string("RIFF\x24\0\0\0WAVEfmt \x10\0\0\0\x01\0\x02\0", 24),
+         std::string("RIFF\x24\0\0\0WAVEfmt \x10\0\0\0\x02\0\x02\0\x44\xac\0\0\x10\xb1\x02\0\x04\0\x10\0data\0\0\0\0", 44),
+         std::string("RIFF\x24\0\0\0WAVEfmt \x10\0\0\0\x01\0\x02\0\x44\xac\0\0\x10\xb1\x02\0\x03\0\x10\0data\0\0\0\0", 44),
+      };
+      for (auto const& bytes : bad) {
+         auto data = std::make_unique<std::uint8_t[]>(bytes.size());
+         std::copy(bytes.begin(), bytes.end(), data.get());
+         try {
+            ParseWave(std::move(data), bytes.size());
+         }
+         catch (std::runtime_error const&) {
+            refused++;
+         }
+      }
+      auto ok = refused == int(bad.size());
+      std::printf("%d of %zu broken files refused  %s\n", refused, bad.size(), ok ? "ok" : "ACCEPTED");
+      return ok;
+   }
+}
+
+int RunAssetBench(std::span<char* const> args) {
+   std::filesystem::path directory = args.size() >= 1 ? args[0] : ".";
+   auto threads = args.size() >= 2 ? unsigned(std::atoi(args[1])) : 0u;
+   auto files = Files(directory);
+   for (auto const& file : files) {
+      if (!std::filesystem::exists(file)) {
+         std::fprintf(stderr, "%s not found; run from the game's directory or pass it\n", file.string().c_str());
+         return 1;
+      }
+   }
+
+   auto ok = CheckBadWaves();
+   // once to warm the file cache, so the runs compare decoding and scheduling
+   Load(files, 1);
+   auto serial = Load(files, 1);
+   auto parallel = Load(files, threads);
+
+   std::printf("   %-12s %8s %9s %9s %9s %9s\n", "asset", "KiB", "queued", "read", "decoded", "ready");
+   for (auto const& timing : parallel.timings) {
+      if (!timing.error.empty()) {
+         std::printf("   %-12s failed: %s\n", timing.name.c_str(), timing.error.c_str());
+         ok = false;
+         continue;
+      }
+      std::printf("   %-12s %8zu %6.2f ms %6.2f ms %6.2f ms %6.2f ms\n", timing.name.c_str(), timing.bytes / 1024,
+         Ms(timing.waited), Ms(timing.read), Ms(timing.decoded), Ms(timing.done));
+   }
+   std::printf("1 worker: first frame's assets after %.2f ms, all after %.2f ms\n", serial.criticalMs, serial.allMs);
+   std::printf("%u workers: first frame's assets after %.2f ms, all after %.2f ms, %.1f s of sound\n",
+      parallel.threads, parallel.criticalMs, parallel.allMs, parallel.seconds);
+   return ok ? 0 : 1;
+}
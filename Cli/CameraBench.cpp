@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../Engine/Camera.h"
+#include "../Engine/Random.h"
+#include "../Engine/TileLod.h"
+#include "../Engine/TileMap.h"
+#include "Commands.h"
+
+namespace {
+   // the game's cell and its largest field, see UI in game.cpp
+   auto constexpr CELL_SIZE = 32.0f;
+   auto constexpr VIEW_WIDTH = 1280.0f;
+   auto constexpr VIEW_HEIGHT = 800.0f;
+
+   double Seconds(std::chrono::steady_clock::time_point since) {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+   }
+
+   // Clicks and flags at random, keeping the blocks up to date the way the
+   // game does, and counts the blocks that differ from a full build after.
+   void CheckLod(Board& board, TileMap& tiles, TileLod& lod) {
+      auto size = BoardSize{ board.Width(), board.Height(), board.Mines() };
+      Xoshiro256 rng(11);
+      auto actions = std::size_t(0);
+      auto updated = std::size_t(0);
+      auto updateSeconds = 0.0;
+      while (board.State() == GameState::Play && actions < 2000) {
+         Pos pos = { int(Bounded(rng, size.width)), int(Bounded(rng, size.height)) };
+         auto result = Bounded(rng, 4) == 0 ? board.Flag(pos.x, pos.y) : board.Click(pos.x, pos.y);
+         actions++;
+         if (result.state != GameState::Play) {
+            tiles.Build(board, {});
+            lod.Build(tiles);
+            continue;
+         }
+         auto start = std::chrono::steady_clock::now();
+         tiles.Update(board, result.changed, {});
+         lod.Update(tiles, result.changed);
+         updateSeconds += Seconds(start);
+         updated += result.changed.size();
+      }
+
+      TileLod reference(size.width, size.height);
+      reference.Build(tiles);
+      auto mismatches = std::size_t(0);
+      for (auto level = 1; level <= lod.Levels(); level++) {
+         auto blocks = lod.Instances(level);
+         auto expected = reference.Instances(level);
+         for (std::size_t i = 0; i < blocks.size(); i++) mismatches += blocks[i] == expected[i] ? 0 : 1;
+      }
+      std::printf("   %d levels, %zu actions over %zu cells, %.3f us per changed cell, blocks %s\n",
+         lod.Levels(), actions, updated, updated ? updateSeconds * 1e6 / updated : 0.0,
+         mismatches == 0 ? "match a full build" : "MISMATCH");
+   }
+
+   // Zooms from the closest view out to the whole board and reports what a
+   // frame would draw at each step. Checks that the instances drawn stay
+   // within what the view can show, and that the cell under a point is the
+   // one drawn there.
+   bool CheckCamera(BoardSize size, TileLod const& lod) {
+      Camera camera(size.width, size.height, CELL_SIZE, VIEW_WIDTH, VIEW_HEIGHT);
+      camera.ZoomAt(Camera::MAX_ZOOM, VIEW_WIDTH / 2, VIEW_HEIGHT / 2);
+      Xoshiro256 rng(5);
+      auto ok = true;
+      std::printf("   %8s %8s %6s %10s %10s %s\n", "zoom", "cell px", "level", "instances", "bound", "");
+      while (true) {
+         auto level = camera.LodLevel(lod.Levels());
+         auto block = 1 << level;
+         auto blockPixels = camera.CellPixels() * block;
+         auto visible = camera.Visible(block);
+         auto instances = std::size_t(visible.Width()) * visible.Height();
+         // a partly shown block at each edge
+         auto bound = std::size_t(std::ceil(VIEW_WIDTH / blockPixels) + 1) * std::size_t(std::ceil(VIEW_HEIGHT / blockPixels) + 1);
+
+         auto misses = 0;
+         for (auto i = 0; i < 1000; i++) {
+            auto x = float(Bounded(rng, std::uint64_t(VIEW_WIDTH)));
+            auto y = float(Bounded(rng, std::uint64_t(VIEW_HEIGHT)));
+            auto cell = camera.CellAt(x, y);
+            auto left = camera.OriginX() + cell.x * camera.CellPixels();
+            auto top = camera.OriginY() + cell.y * camera.CellPixels();
+            auto inside = x >= left - 1e-2f && x < left + camera.CellPixels() + 1e-2f &&
+               y >= top - 1e-2f && y < top + camera.CellPixels() + 1e-2f;
+            auto onBoard = cell.x >= 0 && cell.y >= 0 && cell.x < size.width && cell.y < size.height;
+            auto drawn = camera.Visible();
+            auto culled = onBoard && (cell.x < drawn.x0 || cell.x >= drawn.x1 || cell.y < drawn.y0 || cell.y >= drawn.y1);
+            if (!inside || culled) misses++;
+         }
+
+         auto fine = instances <= bound && misses == 0;
+         ok = ok && fine;
+         std::printf("   %8.4f %8.2f %6d %10zu %10zu %s\n", camera.Zoom(), camera.CellPixels(), level, instances, bound,
+            fine ? "" : "FAILED");
+
+         auto zoom = camera.Zoom();
+         camera.ZoomAt(.5f, VIEW_WIDTH / 3, VIEW_HEIGHT / 3);
+         if (camera.Zoom() == zoom) break;
+      }
+      return ok;
+   }
+
+   bool Run(BoardSize size) {
+      std::printf("%dx%d, %d mines, %.0fx%.0f view\n", size.width, size.height, size.mines, VIEW_WIDTH, VIEW_HEIGHT);
+      Board board(size, SafeZone::Block, 1);
+      TileMap tiles(size.width, size.height);
+      TileLod lod(size.width, size.height);
+      tiles.Build(board, {});
+      auto start = std::chrono::steady_clock::now();
+      lod.Build(tiles);
+      std::printf("   blocks built in %.2f ns per cell\n", Seconds(start) * 1e9 / (double(size.width) * size.height));
+      CheckLod(board, tiles, lod);
+      return CheckCamera(size, lod);
+   }
+}
+
+int RunCameraBench(std::span<char* const> args) {
+   if (args.size() >= 2) {
+      auto width = std::atoi(args[0]);
+      auto height = std::atoi(args[1]);
+      auto mines = args.size() >= 3 ? std::atoi(args[2]) : MinesFor(width, height, Difficulty::Medium);
+      return Run({ width, height, mines }) ? 0 : 1;
+   }
+
+   auto ok = Run({ 30, 16, 99 });
+   ok = Run({ 1000, 1000, MinesFor(1000, 1000, Difficulty::Easy) }) && ok;
+   ok = Run({ 4000, 3000, MinesFor(4000, 3000, Difficulty::Easy) }) && ok;
+   return ok ? 0 : 1;
+}
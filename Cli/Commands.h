@@ -0,0 +1,86 @@
+#pragma once
+//
+// Commands.h
+// Entry points of the headless command line tools.
+//
+
+#include <span>
+
+// Plays scripted games through the input, board and tile map paths of a
+// frame and fails if any frame allocates once the first game is over.
+// Needs a build with MINESWEEPER_PROFILE defined.
+int RunAllocBench(std::span<char* const> args);
+
+// Loads the game's textures and sounds on a task pool the way the game starts
+// up and reports per-asset timings; checks broken WAVE files are refused.
+int RunAssetBench(std::span<char* const> args);
+
+// Zooms a camera over large boards, checking the cells drawn and the cell
+// under the mouse, and checks the zoomed out blocks against full builds.
+int RunCameraBench(std::span<char* const> args);
+
+// Times the flood fill of a single click against the old recursive fill,
+// and fails if the two open different cells where both run.
+int RunFloodBench(std::span<char* const> args);
+
+// Runs the frame scheduler against the null renderer in every mode, on a
+// simulated clock for frame counts and in real time for CPU use.
+int RunFrameBench(std::span<char* const> args);
+
+// Times mine placement and the neighbour count pass of a new board.
+int RunGenerateBench(std::span<char* const> args);
+
+// Feeds fast clicks and pointer storms through the input queue and checks
+// every click reaches the board in order; reports click to board latency.
+int RunInputBench(std::span<char* const> args);
+
+// Compares the byte per cell and the bitplane board layouts.
+int RunLayoutBench(std::span<char* const> args);
+
+// Logs from one and several threads through the asynchronous logger, with
+// entries formatted by the writer and, for comparison, by the caller, and
+// checks every entry reached the rotated files, through the crash flush too.
+// "log crash" crashes with entries queued, to check the file by hand.
+int RunLogBench(std::span<char* const> args);
+
+// Times the search for boards that need no guess, on one and on all threads.
+int RunNoGuessBench(std::span<char* const> args);
+
+// Measures what a profiler scope costs and writes a trace of bot games
+// played on every thread, checking no event went missing.
+int RunProfileBench(std::span<char* const> args);
+
+// Compares an asset pack with the files it was cooked from, then times
+// startup from the loose files against mapping the pack, cold and warm.
+int RunPackBench(std::span<char* const> args);
+
+// Compares a new game on a board built on the spot with one from the pool,
+// and the first click of a no-guess game searched for on the spot with one
+// searched for by the pool. Fails if a pooled no-guess board needs a guess,
+// if the pool finds fewer than asked for, or if its click waits longer.
+int RunPoolBench(std::span<char* const> args);
+
+// Compares mine probabilities with brute force on small stuck boards, on
+// the exact and the sampled path, then times them on boards of every size,
+// optionally writing the grids out. Fails if either path is out of tolerance.
+int RunProbabilityBench(std::span<char* const> args);
+
+// Plays recorded games and checks each ends as recorded; without files,
+// records and checks random games in memory.
+int RunReplay(std::span<char* const> args);
+
+// Plays many games with the bot on all threads and reports win rate, clicks,
+// 3BV and games per second; the totals depend only on the seed.
+int RunSimBench(std::span<char* const> args);
+
+// Solves boards by logic alone from a first click and reports boards per second.
+int RunSolveBench(std::span<char* const> args);
+
+// Checks the tile map kept up to date action by action against full builds
+// and times building and updating it.
+int RunTileBench(std::span<char* const> args);
+
+// Checks the mine counts and safe zone of every topology against its
+// definition, and that actions outside the board change nothing, then times
+// boards sized at run time against the presets.
+int RunTopologyBench(std::span<char* const> args);
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#include "../Engine/Board.h"
+#include "Commands.h"
+
+namespace {
+   // The old recursive ExploreMap also recursed once per cell of an empty
+   // area, so it is only run on boards that fit in a default thread stack.
+   auto constexpr RECURSIVE_LIMIT = std::size_t(200 * 200);
+
+   // The fill as Game used to do it: column-major cells, a bounds-clamped
+   // std::function neighbourhood and one recursive call per neighbour.
+   struct RecursiveFill {
+      int width;
+      int height;
+      std::vector<Cell> cells;
+      std::size_t opened = 0;
+
+      explicit RecursiveFill(Board const& board) :
+         width(board.Width()),
+         height(board.Height()),
+         cells(std::size_t(board.Width()) * board.Height(), Cell{}) {
+         for (auto x = 0; x < width; x++) {
+            for (auto y = 0; y < height; y++) {
+               GetCell(x, y)->SetMined(board.At(x, y).IsMined());
+            }
+         }
+      }
+
+      Cell* GetCell(int x, int y) {
+         return &cells[std::size_t(x) * height + y];
+      }
+
+      void IterateNear(int originX, int originY, std::function<void(int, int)> cb) {
+         auto minX = std::max(0, originX - 1);
+         auto minY = std::max(0, originY - 1);
+         auto maxX = std::min(width - 1, originX + 1);
+         auto maxY = std::min(height - 1, originY + 1);
+         for (auto x = minX; x <= maxX; x++) {
+            for (auto y = minY; y <= maxY; y++) {
+               cb(x, y);
+            }
+         }
+      }
+
+      void OpenAt(int x, int y) {
+         auto cell = GetCell(x, y);
+         cell->Open();
+         auto mines = 0;
+         IterateNear(x, y, [this, &mines](int x, int y) {
+            mines += GetCell(x, y)->IsMined() ? 1 : 0;
+            });
+         cell->SetMinesNear(mines);
+         opened++;
+      }
+
+      void ExploreMap(int originX, int originY) {
+         auto cell = GetCell(originX, originY);
+         if (cell->IsOpened() || cell->IsMined()) return;
+         OpenAt(originX, originY);
+         if (cell->MinesNear() == 0) {
+            IterateNear(originX, originY, [this](int x, int y) {
+               ExploreMap(x, y);
+               });
+         }
+      }
+   };
+
+   double Seconds(std::chrono::steady_clock::time_point since) {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+   }
+
+   // The same cells opened, with the same counts.
+   bool SameCells(Board const& board, RecursiveFill& reference) {
+      for (auto y = 0; y < reference.height; y++) {
+         for (auto x = 0; x < reference.width; x++) {
+            auto cell = board.At(x, y);
+            auto expected = *reference.GetCell(x, y);
+            if (cell.IsOpened() != expected.IsOpened()) return false;
+            if (expected.IsOpened() && cell.MinesNear() != expected.MinesNear()) return false;
+         }
+      }
+      return true;
+   }
+
+   // False if the queue fill and the recursive one disagree.
+   bool Run(BoardSize size) {
+      Board board(size);
+      auto x = size.width / 2;
+      auto y = size.height / 2;
+      board.Start(x, y);
+
+      auto start = std::chrono::steady_clock::now();
+      auto result = board.Click(x, y);
+      auto queueSeconds = Seconds(start);
+      auto opened = result.changed.size();
+
+      std::printf("%6dx%-6d %9d mines  queue: %10zu cells %9.3f ms %8.1f Mcells/s",
+         size.width, size.height, size.mines, opened, queueSeconds * 1e3, opened / queueSeconds / 1e6);
+
+      if (std::size_t(size.width) * size.height > RECURSIVE_LIMIT) {
+         std::printf("  recursive: skipped, would overflow the stack\n");
+         return true;
+      }
+
+      RecursiveFill reference(board);
+      start = std::chrono::steady_clock::now();
+      reference.ExploreMap(x, y);
+      auto recursiveSeconds = Seconds(start);
+      auto same = reference.opened == opened && SameCells(board, reference);
+      std::printf("  recursive: %10zu cells %9.3f ms %8.1f Mcells/s  %s\n",
+         reference.opened, recursiveSeconds * 1e3, reference.opened / recursiveSeconds / 1e6, same ? "same cells" : "MISMATCH");
+      return same;
+   }
+}
+
+int RunFloodBench(std::span<char* const> args) {
+   if (args.size() >= 2) {
+      auto width = std::atoi(args[0]);
+      auto height = std::atoi(args[1]);
+      auto mines = args.size() >= 3 ? std::atoi(args[2]) : int(std::size_t(width) * height / 1000);
+      return Run({ width, height, mines }) ? 0 : 1;
+   }
+
+   // sparse boards, one mine per thousand cells, so a single click opens most of the board
+   auto ok = true;
+   for (auto side : { 50, 100, 200, 500, 1000, 2000, 5000 }) {
+      ok = Run({ side, side, int(std::size_t(side) * side / 1000) }) && ok;
+   }
+   return ok ? 0 : 1;
+}
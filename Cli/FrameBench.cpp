@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "../Engine/FrameScheduler.h"
+#include "Commands.h"
+
+namespace {
+   using Clock = FrameScheduler::Clock;
+
+   struct Scenario {
+      char const* name;
+      // mouse moves per second over the first half, 0 for none
+      int moves;
+      bool timer;
+   };
+
+   Scenario constexpr SCENARIOS[] = {
+      { "idle", 0, false },
+      { "timer running", 0, true },
+      { "mouse moving", 1000, true },
+   };
+
+   // Steps a simulated clock from wake-up to wake-up as the main loop would
+   // sleep, so many seconds run in no time and the counts are exact.
+   void Simulate(FrameMode mode, Clock::duration interval, Scenario const& scenario, std::chrono::seconds length) {
+      FrameScheduler frames(mode, interval);
+      NullRenderer renderer;
+      auto start = Clock::time_point{};
+      auto end = start + length;
+      auto moveEvery = scenario.moves > 0 ? Clock::duration(std::chrono::seconds(1)) / scenario.moves : Clock::duration::max();
+      auto nextMove = scenario.moves > 0 ? start : Clock::time_point::max();
+      auto nextSecond = start + std::chrono::seconds(1);
+
+      auto turns = std::uint64_t(0);
+      for (auto now = start; now < end; turns++) {
+         // the update: input and the timer invalidate what they change
+         if (now >= nextMove) {
+            frames.Invalidate(Dirty::HoverChanged);
+            nextMove += moveEvery;
+            if (nextMove >= start + length / 2) nextMove = Clock::time_point::max();
+         }
+         if (scenario.timer) {
+            if (now >= nextSecond) {
+               frames.Invalidate(Dirty::TimerChanged);
+               nextSecond += std::chrono::seconds(1);
+            }
+            frames.WakeAt(nextSecond);
+         }
+         frames.Frame(renderer, now);
+
+         // the wait: until the scheduler's deadline or the next input; in
+         // vsync mode the presentation blocks for an interval instead
+         auto wake = end;
+         if (mode == FrameMode::VSync) wake = now + interval;
+         else if (auto idle = frames.Idle(now); idle != Clock::duration::max()) wake = std::min({ now + idle, nextMove, end });
+         else wake = std::min(nextMove, end);
+         now = std::max(now + Clock::duration(1), wake);
+      }
+      auto seconds = std::chrono::duration<double>(length).count();
+      std::printf("   %-14s %8llu frames  %8.1f frames/s  %8llu loop turns\n", scenario.name,
+         static_cast<unsigned long long>(renderer.frames), renderer.frames / seconds, static_cast<unsigned long long>(turns));
+   }
+
+   // Runs a real loop with the null renderer, sleeping as the game does, and
+   // reports how much of a core it used.
+   void Measure(FrameMode mode, Clock::duration interval, std::chrono::milliseconds length) {
+      FrameScheduler frames(mode, interval);
+      NullRenderer renderer;
+      auto end = Clock::now() + length;
+      for (auto now = Clock::now(); now < end; now = Clock::now()) {
+         frames.Frame(renderer, now);
+         auto idle = std::min(frames.Idle(now), Clock::duration(end - now));
+         if (idle > Clock::duration::zero()) std::this_thread::sleep_for(idle);
+      }
+      auto& stats = frames.Stats();
+      std::printf("   %8llu frames  %10llu idle turns  %8.4f ms CPU per frame  %6.2f%% of a core\n",
+         static_cast<unsigned long long>(stats.frames), static_cast<unsigned long long>(stats.skipped),
+         stats.CpuPerFrameMs(), 100 * stats.CpuShare());
+   }
+}
+
+int RunFrameBench(std::span<char* const> args) {
+   auto fps = args.size() >= 1 ? std::atoi(args[0]) : 60;
+   auto seconds = std::chrono::seconds(args.size() >= 2 ? std::atoi(args[1]) : 60);
+   if (fps <= 0 || seconds.count() <= 0) {
+      std::printf("frames per second and seconds must be positive\n");
+      return 1;
+   }
+   auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+
+   struct Mode {
+      char const* name;
+      FrameMode mode;
+   };
+   Mode constexpr MODES[] = {
+      { "vsync", FrameMode::VSync },
+      { "capped", FrameMode::Capped },
+      { "on demand", FrameMode::OnDemand },
+   };
+   for (auto& mode : MODES) {
+      std::printf("%s at %d frames/s, %lld s simulated\n", mode.name, fps, static_cast<long long>(seconds.count()));
+      for (auto& scenario : SCENARIOS) Simulate(mode.mode, interval, scenario, seconds);
+   }
+   for (auto& mode : MODES) {
+      std::printf("%s, idle, 1 s in real time\n", mode.name);
+      Measure(mode.mode, interval, std::chrono::milliseconds(1000));
+   }
+   return 0;
+}
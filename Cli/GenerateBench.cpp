@@ -0,0 +1,42 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "../Engine/Board.h"
+#include "Commands.h"
+
+namespace {
+   template <typename Rng>
+   void Time(char const* name, BoardSize size, Rng& rng) {
+      Board board(size, SafeZone::Block);
+      auto start = std::chrono::steady_clock::now();
+      board.Start(size.width / 2, size.height / 2, rng);
+      auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      auto cells = double(size.width) * size.height;
+      std::printf("%6dx%-6d %10d mines  %-11s %10.3f ms %8.1f Mcells/s\n",
+         size.width, size.height, size.mines, name, seconds * 1e3, cells / seconds / 1e6);
+   }
+
+   void Run(BoardSize size) {
+      Xoshiro256 xoshiro(1);
+      Time("xoshiro256", size, xoshiro);
+      std::mt19937_64 mt(1);
+      Time("mt19937_64", size, mt);
+   }
+}
+
+int RunGenerateBench(std::span<char* const> args) {
+   if (args.size() >= 2) {
+      auto width = std::atoi(args[0]);
+      auto height = std::atoi(args[1]);
+      auto mines = args.size() >= 3 ? std::atoi(args[2]) : MinesFor(width, height, Difficulty::Hard);
+      Run({ width, height, mines });
+      return 0;
+   }
+
+   for (auto side : { 100, 1000, 3000, 10000 }) {
+      Run({ side, side, MinesFor(side, side, Difficulty::Hard) });
+   }
+   return 0;
+}
@@ -0,0 +1,213 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../Engine/Board.h"
+#include "../Engine/Camera.h"
+#include "../Engine/Input.h"
+#include "../Engine/Random.h"
+#include "Commands.h"
+
+namespace {
+   // the game's cell and its frame at 60 Hz
+   auto constexpr CELL_SIZE = 32.0f;
+   auto constexpr FRAME = std::chrono::microseconds(16'667);
+
+   struct Applied {
+      InputActionKind kind;
+      int x;
+      int y;
+      bool operator==(Applied const&) const = default;
+   };
+
+   // A board that starts over with the next seed whenever a game ends, so a
+   // long stream of clicks keeps changing something.
+   struct Player {
+      BoardSize size;
+      std::uint64_t seed;
+      Board board;
+      std::vector<Applied> applied;
+
+      Player(BoardSize size, std::uint64_t seed) : size(size), seed(seed), board(size, SafeZone::Cell, seed) {}
+
+      void Apply(InputActionKind kind, Pos cell) {
+         if (!board.Contains(cell.x, cell.y)) return;
+         if (board.State() != GameState::Play) board = Board(size, SafeZone::Cell, ++seed);
+         if (kind == InputActionKind::Click) board.Click(cell.x, cell.y);
+         else board.Flag(cell.x, cell.y);
+         applied.push_back({ kind, cell.x, cell.y });
+      }
+   };
+
+   struct Stream {
+      InputEvent::Clock::time_point start;
+      std::vector<std::vector<InputEvent>> frames;
+      // every click and mark in the order made, with the cell it was made on
+      std::vector<Applied> made;
+      std::size_t events = 0;
+   };
+
+   // Each frame has a few hundred pointer moves and up to `clicksPerFrame`
+   // press and release pairs, spread over the frame as a fast player would.
+   Stream MakeStream(Camera const& camera, BoardSize size, int frames, int clicksPerFrame, std::uint64_t seed) {
+      Xoshiro256 rng(seed);
+      Stream stream;
+      auto start = stream.start = InputEvent::Clock::now();
+      for (auto f = 0; f < frames; f++) {
+         auto& events = stream.frames.emplace_back();
+         auto frameStart = start + f * FRAME;
+         auto clicks = int(Bounded(rng, clicksPerFrame + 1));
+         auto moves = 100 + int(Bounded(rng, 300));
+         auto steps = moves + 2 * clicks;
+         auto at = [&](int step) { return frameStart + FRAME * step / steps; };
+         auto step = 0;
+         for (auto c = 0; c <= clicks; c++) {
+            for (auto m = 0; m < moves / (clicks + 1); m++) {
+               auto x = int(Bounded(rng, std::uint64_t(size.width * CELL_SIZE)));
+               auto y = int(Bounded(rng, std::uint64_t(size.height * CELL_SIZE)));
+               events.push_back({ InputKind::PointerMove, 0, x, y, 0, at(step++) });
+            }
+            if (c == clicks) break;
+            Pos cell = { int(Bounded(rng, size.width)), int(Bounded(rng, size.height)) };
+            auto x = int(camera.OriginX() + (cell.x + 0.5f) * camera.CellPixels());
+            auto y = int(camera.OriginY() + (cell.y + 0.5f) * camera.CellPixels());
+            auto mark = Bounded(rng, 4) == 0;
+            auto button = std::uint8_t(mark ? MouseButton::Right : MouseButton::Left);
+            events.push_back({ InputKind::ButtonDown, button, x, y, 0, at(step++) });
+            events.push_back({ InputKind::ButtonUp, button, x, y, 0, at(step++) });
+            stream.made.push_back({ mark ? InputActionKind::Mark : InputActionKind::Click, cell.x, cell.y });
+         }
+         stream.events += events.size();
+      }
+      return stream;
+   }
+
+   // The game's way: queue everything, apply it all in order at the end of
+   // the frame.
+   Player PlayQueued(Stream const& stream, Camera const& camera, BoardSize size, InputQueue& queue, LatencyStats& latency) {
+      Player player(size, 1);
+      InputDispatcher dispatcher;
+      std::vector<InputAction> actions;
+      for (std::size_t f = 0; f < stream.frames.size(); f++) {
+         for (auto const& event : stream.frames[f]) queue.Push(event);
+         auto frameEnd = stream.start + FRAME * (f + 1);
+         actions.clear();
+         InputEvent event;
+         while (queue.Pop(event)) dispatcher.Apply(event, actions);
+         for (auto const& action : actions) {
+            if (action.kind != InputActionKind::Click && action.kind != InputActionKind::Mark) continue;
+            player.Apply(action.kind, camera.CellAt(float(action.x), float(action.y)));
+            latency.Add(frameEnd - action.time);
+         }
+      }
+      return player;
+   }
+
+   // The way it was done before: look at the buttons once a frame and act
+   // on the ones that were down last frame and are up now. A press and
+   // release within one frame is never seen.
+   Player PlayPolled(Stream const& stream, Camera const& camera, BoardSize size) {
+      Player player(size, 1);
+      bool held[2] = {};
+      for (auto const& frame : stream.frames) {
+         bool now[2] = { held[0], held[1] };
+         auto x = 0;
+         auto y = 0;
+         for (auto const& event : frame) {
+            x = event.x;
+            y = event.y;
+            if (event.kind == InputKind::ButtonDown || event.kind == InputKind::ButtonUp) now[event.code] = event.kind == InputKind::ButtonDown;
+         }
+         auto cell = camera.CellAt(float(x), float(y));
+         if (held[0] && !now[0]) player.Apply(InputActionKind::Click, cell);
+         if (held[1] && !now[1]) player.Apply(InputActionKind::Mark, cell);
+         held[0] = now[0];
+         held[1] = now[1];
+      }
+      return player;
+   }
+
+   bool SameBoard(Board const& a, Board const& b) {
+      if (a.State() != b.State()) return false;
+      for (auto y = 0; y < a.Height(); y++) {
+         for (auto x = 0; x < a.Width(); x++) {
+            if (a.At(x, y).bits != b.At(x, y).bits) return false;
+         }
+      }
+      return true;
+   }
+
+   // Releases that must not act: one without a press, and one after the
+   // window lost focus with the button held.
+   bool CheckEdges() {
+      auto now = InputEvent::Clock::now();
+      InputDispatcher dispatcher;
+      std::vector<InputAction> actions;
+      dispatcher.Apply({ InputKind::ButtonUp, std::uint8_t(MouseButton::Left), 5, 5, 0, now }, actions);
+      dispatcher.Apply({ InputKind::ButtonDown, std::uint8_t(MouseButton::Right), 5, 5, 0, now }, actions);
+      dispatcher.Apply({ InputKind::Cancel, 0, 0, 0, 0, now }, actions);
+      dispatcher.Apply({ InputKind::ButtonUp, std::uint8_t(MouseButton::Right), 5, 5, 0, now }, actions);
+      dispatcher.Apply({ InputKind::KeyUp, 'P', 0, 0, 0, now }, actions);
+      auto stray = 0;
+      for (auto const& action : actions) stray += action.kind == InputActionKind::Hover ? 0 : 1;
+
+      // moves merge, a press between them does not
+      InputQueue queue;
+      for (auto i = 0; i < 10; i++) queue.Push({ InputKind::PointerMove, 0, i, i, 0, now });
+      queue.Push({ InputKind::ButtonDown, std::uint8_t(MouseButton::Middle), 9, 9, 0, now });
+      for (auto i = 0; i < 10; i++) queue.Push({ InputKind::PointerMove, 0, 9 + i, 9, 0, now });
+      for (auto i = 0; i < 3; i++) queue.Push({ InputKind::Wheel, 0, 9, 9, 120, now });
+      actions.clear();
+      InputEvent event;
+      auto popped = 0;
+      while (queue.Pop(event)) {
+         popped++;
+         dispatcher.Apply(event, actions);
+      }
+      auto panned = 0;
+      auto notches = 0.0f;
+      for (auto const& action : actions) {
+         if (action.kind == InputActionKind::Pan) panned += action.dx;
+         if (action.kind == InputActionKind::Zoom) notches += action.notches;
+      }
+
+      auto ok = stray == 0 && popped == 4 && panned == 9 && notches == 3;
+      std::printf("stray actions %d, 33 events queued as %d, panned %d px, zoomed %.0f notches  %s\n",
+         stray, popped, panned, notches, ok ? "ok" : "WRONG");
+      return ok;
+   }
+}
+
+int RunInputBench(std::span<char* const> args) {
+   auto frames = args.size() >= 1 ? std::atoi(args[0]) : 3600;
+   auto clicksPerFrame = args.size() >= 2 ? std::atoi(args[1]) : 3;
+   if (frames <= 0 || clicksPerFrame < 0) {
+      std::fprintf(stderr, "frames must be positive and clicks per frame not negative\n");
+      return 1;
+   }
+
+   auto size = BoardSize{ 30, 16, 99 };
+   Camera camera(size.width, size.height, CELL_SIZE, size.width * CELL_SIZE, size.height * CELL_SIZE);
+   auto stream = MakeStream(camera, size, frames, clicksPerFrame, 7);
+
+   auto ok = CheckEdges();
+
+   InputQueue queue;
+   LatencyStats latency;
+   auto start = std::chrono::steady_clock::now();
+   auto queued = PlayQueued(stream, camera, size, queue, latency);
+   auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+   Player direct(size, 1);
+   for (auto const& made : stream.made) direct.Apply(made.kind, { made.x, made.y });
+   auto complete = queued.applied == direct.applied && SameBoard(queued.board, direct.board);
+   ok = ok && complete;
+   std::printf("queued: %zu events in %d frames, %zu merged, %zu of %zu clicks and marks applied in order  %s\n",
+      queue.Pushed(), frames, queue.Coalesced(), queued.applied.size(), stream.made.size(), complete ? "complete" : "LOST OR REORDERED");
+   std::printf("   %.1f ns per event, click to board %.2f ms on average and %.2f ms at most at %.0f fps\n",
+      seconds * 1e9 / double(stream.events), latency.MeanMs(), latency.MaxMs(), 1e6 / double(FRAME.count()));
+
+   auto polled = PlayPolled(stream, camera, size);
+   std::printf("polled once a frame: %zu of %zu clicks and marks applied\n", polled.applied.size(), stream.made.size());
+   return ok ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../Engine/Board.h"
+#include "Commands.h"
+
+namespace {
+   double Seconds(std::chrono::steady_clock::time_point since) {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+   }
+
+   template <typename Store>
+   void Run(char const* name, BoardSize size) {
+      BasicBoard<Store> board(size);
+      auto x = size.width / 2;
+      auto y = size.height / 2;
+      auto cells = double(size.width) * size.height;
+
+      auto start = std::chrono::steady_clock::now();
+      board.Start(x, y);
+      auto generate = Seconds(start);
+
+      start = std::chrono::steady_clock::now();
+      auto opened = board.Click(x, y).changed.size();
+      auto click = Seconds(start);
+
+      start = std::chrono::steady_clock::now();
+      auto counted = board.Cells().CountOpened() + board.Cells().CountFlagged();
+      auto count = Seconds(start);
+
+      std::printf("%-5s %5.2f bytes/cell  generate %9.3f ms  click %9.3f ms (%zu cells)  count %8.3f ms (%zu)\n",
+         name, board.Cells().Bytes() / cells, generate * 1e3, click * 1e3, opened, count * 1e3, counted);
+   }
+
+   void Compare(BoardSize size) {
+      std::printf("%dx%d, %d mines\n", size.width, size.height, size.mines);
+      Run<CellStore>("cells", size);
+      Run<BitStore>("bits", size);
+   }
+}
+
+int RunLayoutBench(std::span<char* const> args) {
+   if (args.size() >= 2) {
+      auto width = std::atoi(args[0]);
+      auto height = std::atoi(args[1]);
+      auto mines = args.size() >= 3 ? std::atoi(args[2]) : int(std::size_t(width) * height / 1000);
+      Compare({ width, height, mines });
+      return 0;
+   }
+
+   for (auto side : { 100, 1000, 4000 }) {
+      Compare({ side, side, int(std::size_t(side) * side / 1000) });
+   }
+   return 0;
+}
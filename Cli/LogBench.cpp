@@ -0,0 +1,143 @@
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Engine/FrameScheduler.h"
+#include "../Engine/Logger.h"
+#include "Commands.h"
+
+namespace {
+   auto constexpr DIRECTORY = "log-bench";
+
+   // Counts the "thread <t> entry <i>" lines in every file of the log, and
+   // the lines that are out of order for their thread.
+   struct Lines {
+      std::size_t entries = 0;
+      std::size_t outOfOrder = 0;
+      std::size_t files = 0;
+   };
+
+   Lines ReadBack(std::filesystem::path const& path, int keepFiles, int threads) {
+      Lines lines;
+      std::vector<long> last(threads, -1);
+      for (auto index = keepFiles; index >= 0; index--) {
+         auto name = path.stem();
+         if (index > 0) {
+            name += ".";
+            name += std::to_string(index);
+         }
+         name += path.extension();
+         std::ifstream file(path.parent_path() / name);
+         if (!file) continue;
+         lines.files++;
+         std::string line;
+         while (std::getline(file, line)) {
+            auto at = line.find("thread ");
+            int thread;
+            long entry;
+            if (at == std::string::npos || std::sscanf(line.c_str() + at, "thread %d entry %ld", &thread, &entry) != 2) continue;
+            lines.entries++;
+            if (entry <= last[thread]) lines.outOfOrder++;
+            last[thread] = entry;
+         }
+      }
+      return lines;
+   }
+
+   // `threads` threads log `entries` between them while the writer rotates
+   // the files; every entry must be on disk or counted as dropped, in order.
+   // A burst that fits the queue times the logging alone, a larger one the
+   // queue filling up. Entries are formatted by the writer unless `onCaller`.
+   bool Run(int threads, int entries, std::size_t capacity, std::chrono::milliseconds flushInterval, bool crashFlush, bool onCaller = false) {
+      std::filesystem::remove_all(DIRECTORY);
+      std::filesystem::create_directories(DIRECTORY);
+      LoggerOptions options;
+      options.path = std::filesystem::path(DIRECTORY) / "log.txt";
+      options.maxBytes = 512 * 1024;
+      // enough files to keep everything
+      options.keepFiles = 64;
+      options.capacity = capacity;
+      options.flushInterval = flushInterval;
+
+      auto perThread = entries / threads;
+      std::vector<double> seconds(threads);
+      std::size_t dropped;
+      {
+         Logger logger(options);
+         std::vector<std::thread> workers;
+         for (auto t = 0; t < threads; t++) {
+            workers.emplace_back([&logger, &seconds, t, perThread, onCaller] {
+               // CPU time, so time the other threads and the writer run in is not counted
+               auto start = ThreadCpuTime();
+               for (auto i = 0; i < perThread; i++) {
+                  auto fill = [t, i](char* buffer, std::size_t size) {
+                     return std::size_t(std::snprintf(buffer, size, "thread %d entry %d", t, i));
+                  };
+                  if (onCaller) logger.Emplace(LogLevel::Info, fill);
+                  else logger.Defer(LogLevel::Info, fill);
+               }
+               seconds[t] = std::chrono::duration<double>(ThreadCpuTime() - start).count();
+               });
+         }
+         for (auto& worker : workers) worker.join();
+         dropped = logger.Dropped();
+         // the writer sleeps for an hour here, so this is all the crash path
+         if (crashFlush) logger.FlushFromCrash();
+         else logger.Flush();
+
+         if (crashFlush) {
+            auto lines = ReadBack(options.path, options.keepFiles, threads);
+            auto ok = lines.entries + dropped == std::size_t(perThread) * threads && lines.outOfOrder == 0;
+            std::printf("crash flush: %zu entries on disk, %zu dropped  %s\n", lines.entries, dropped, ok ? "none lost" : "LOST ENTRIES");
+            if (!ok) return false;
+         }
+      }
+
+      auto lines = ReadBack(options.path, options.keepFiles, threads);
+      auto ok = lines.entries + dropped == std::size_t(perThread) * threads && lines.outOfOrder == 0;
+      std::printf("%d threads, formatted by the %s: %.1f ns per entry, %zu entries in %zu files, %zu dropped, %zu out of order  %s\n",
+         threads, onCaller ? "caller" : "writer", std::accumulate(seconds.begin(), seconds.end(), 0.0) * 1e9 / (double(perThread) * threads), lines.entries, lines.files, dropped,
+         lines.outOfOrder, ok ? "complete" : "LOST ENTRIES");
+      return ok;
+   }
+
+   // Logs, then crashes with entries still queued, for checking by hand
+   // that they reach the file.
+   int Crash() {
+      std::filesystem::create_directories(DIRECTORY);
+      LoggerOptions options;
+      options.path = std::filesystem::path(DIRECTORY) / "crash.txt";
+      options.flushInterval = std::chrono::hours(1);
+      static Logger logger(options);
+      FlushOnCrash(&logger);
+      for (auto i = 0; i < 100; i++) {
+         logger.Emplace(LogLevel::Info, [i](char* buffer, std::size_t size) {
+            return std::size_t(std::snprintf(buffer, size, "thread 0 entry %d", i));
+            });
+      }
+      std::printf("crashing with 100 entries queued, see %s\n", options.path.string().c_str());
+      std::fflush(stdout);
+      std::raise(SIGSEGV);
+      return 1;
+   }
+}
+
+int RunLogBench(std::span<char* const> args) {
+   if (args.size() >= 1 && std::strcmp(args[0], "crash") == 0) return Crash();
+
+   auto ok = Run(1, 50'000, 1 << 16, std::chrono::milliseconds(100), false);
+   ok = Run(4, 50'000, 1 << 16, std::chrono::milliseconds(100), false) && ok;
+   ok = Run(4, 50'000, 1 << 16, std::chrono::milliseconds(100), false, true) && ok;
+   ok = Run(4, 200'000, 1 << 12, std::chrono::milliseconds(100), false) && ok;
+   ok = Run(4, 50'000, 1 << 16, std::chrono::hours(1), true) && ok;
+   std::filesystem::remove_all(DIRECTORY);
+   return ok ? 0 : 1;
+}
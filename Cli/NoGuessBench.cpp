@@ -0,0 +1,52 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../Engine/NoGuess.h"
+#include "Commands.h"
+
+namespace {
+   double Seconds(std::chrono::steady_clock::time_point since) {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+   }
+
+   void Run(BoardSize size, std::size_t count) {
+      Pos first = { size.width / 2, size.height / 2 };
+
+      auto start = std::chrono::steady_clock::now();
+      auto single = FindNoGuessSeeds(size, first, 1, count, 1);
+      auto singleSeconds = Seconds(start);
+
+      start = std::chrono::steady_clock::now();
+      auto batch = FindNoGuessSeeds(size, first, 1, count);
+      auto batchSeconds = Seconds(start);
+
+      auto found = std::size_t(0);
+      auto attempts = std::size_t(0);
+      for (std::size_t i = 0; i < count; i++) {
+         found += single[i].seed ? 1 : 0;
+         attempts += single[i].attempts;
+         // the batch must find the same boards whatever the thread count
+         if (single[i].seed != batch[i].seed) std::printf("board %zu differs between thread counts\n", i);
+      }
+      std::printf("%6dx%-6d %9d mines  %6zu/%-6zu found  %7.1f attempts each  %8.3f ms per board  %9.1f boards/s on all threads\n",
+         size.width, size.height, size.mines, found, count, double(attempts) / count,
+         singleSeconds * 1e3 / count, count / batchSeconds);
+   }
+}
+
+int RunNoGuessBench(std::span<char* const> args) {
+   if (args.size() >= 2) {
+      auto width = std::atoi(args[0]);
+      auto height = std::atoi(args[1]);
+      auto mines = args.size() >= 3 ? std::atoi(args[2]) : MinesFor(width, height, Difficulty::Hard);
+      auto count = args.size() >= 4 ? std::size_t(std::atoll(args[3])) : std::size_t(100);
+      Run({ width, height, mines }, count);
+      return 0;
+   }
+
+   Run({ 9, 9, 10 }, 10000);
+   Run({ 16, 16, 40 }, 2000);
+   Run({ 30, 16, 99 }, 500);
+   return 0;
+}
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "../Engine/AssetLoader.h"
+#include "../Engine/AssetPack.h"
+#include "../Engine/Png.h"
+#include "../Engine/Wave.h"
+#include "Commands.h"
+
+namespace {
+   auto constexpr RUNS = 5;
+   auto constexpr PAGE = std::size_t(4096);
+
+   // Drops the file from the page cache, so the next read comes from disk.
+   // Linux only; elsewhere every run is warm.
+   bool Evict(std::filesystem::path const& path) {
+#ifdef __linux__
+      auto descriptor = open(path.c_str(), O_RDONLY);
+      if (descriptor < 0) return false;
+      auto evicted = posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED) == 0;
+      close(descriptor);
+      return evicted;
+#else
+      (void)path;
+      return false;
+#endif
+   }
+
+   // so the page touches are not optimized away
+   std::uint32_t volatile touched = 0;
+
+   std::vector<std::string> Sources(std::span<PackEntry const> entries) {
+      std::vector<std::string> names;
+      for (auto const& entry : entries) {
+         if (entry.kind == PackKind::Texture || entry.kind == PackKind::Sound) names.emplace_back(entry.Name());
+      }
+      return names;
+   }
+
+   // What startup did before the pack: read and decode every file.
+   void LoadLoose(std::filesystem::path const& directory, std::vector<std::string> const& names) {
+      for (auto const& name : names) {
+         auto file = ReadFile(directory / name);
+         if (name.ends_with(".png")) DecodePng({ file.data.get(), file.size });
+         else ParseWave(std::move(file.data), file.size);
+      }
+   }
+
+   // What startup does with it: map, check the index, and let the device
+   // and the audio engine read the pages, which is touching each once.
+   void LoadPacked(std::filesystem::path const& path) {
+      AssetPack pack(path);
+      auto sum = 0u;
+      for (auto const& entry : pack.Entries()) {
+         if (entry.kind != PackKind::Texture && entry.kind != PackKind::SoundData) continue;
+         auto data = pack.Data(entry);
+         for (std::size_t at = 0; at < data.size(); at += PAGE) sum += data[at];
+      }
+      touched = sum;
+   }
+
+   // The pack must hold exactly what the loose files decode to.
+   bool Compare(AssetPack const& pack, std::filesystem::path const& directory) {
+      auto mismatches = 0;
+      auto compared = 0;
+      for (auto const& entry : pack.Entries()) {
+         if (entry.kind != PackKind::Texture && entry.kind != PackKind::Sound) continue;
+         auto file = ReadFile(directory / std::string(entry.Name()));
+         auto data = pack.Data(entry);
+         if (entry.kind == PackKind::Texture) {
+            auto image = DecodePng({ file.data.get(), file.size });
+            auto top = std::span(data).first(std::min(data.size(), image.pixels.size()));
+            auto same = image.width == entry.width && image.height == entry.height &&
+               std::equal(top.begin(), top.end(), image.pixels.begin(), image.pixels.end()) &&
+               (entry.format == PackFormat::Rgba8Srgb) == image.srgb;
+            mismatches += same ? 0 : 1;
+         }
+         else {
+            auto wave = ParseWave(std::move(file.data), file.size);
+            auto same = data.size() == wave.samplesSize && std::memcmp(data.data(), wave.Samples(), data.size()) == 0 &&
+               std::memcmp(pack.At(entry.waveFormat), wave.Format(), sizeof(WaveFormat)) == 0;
+            mismatches += same ? 0 : 1;
+         }
+         compared++;
+      }
+      std::printf("%d assets compared with their sources, %d differ  %s\n", compared, mismatches, mismatches == 0 ? "ok" : "STALE OR BROKEN");
+      return mismatches == 0;
+   }
+
+   template <typename Load>
+   double Best(Load const& load, std::vector<std::filesystem::path> const& files, bool cold, bool& evicted) {
+      auto best = 1e30;
+      for (auto run = 0; run < RUNS; run++) {
+         if (cold) {
+            for (auto const& file : files) evicted = Evict(file) && evicted;
+         }
+         auto start = std::chrono::steady_clock::now();
+         load();
+         best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+      }
+      return best;
+   }
+}
+
+int RunPackBench(std::span<char* const> args) {
+   std::filesystem::path path = args.size() >= 1 ? args[0] : "assets.pack";
+   std::filesystem::path directory = args.size() >= 2 ? args[1] : ".";
+   if (!std::filesystem::exists(path)) {
+      std::fprintf(stderr, "%s not found; cook it with MinesweeperCooker first\n", path.string().c_str());
+      return 1;
+   }
+
+   try {
+      std::vector<std::string> names;
+      {
+         AssetPack pack(path);
+         if (!Compare(pack, directory)) return 1;
+         names = Sources(pack.Entries());
+      }
+      std::vector<std::filesystem::path> looseFiles;
+      for (auto const& name : names) looseFiles.push_back(directory / name);
+
+      auto loose = [&] { LoadLoose(directory, names); };
+      auto packed = [&] { LoadPacked(path); };
+      auto evicted = true;
+      auto looseCold = Best(loose, looseFiles, true, evicted);
+      auto packedCold = Best(packed, { path }, true, evicted);
+      auto looseWarm = Best(loose, looseFiles, false, evicted);
+      auto packedWarm = Best(packed, { path }, false, evicted);
+
+      std::printf("   %-28s %10s %10s\n", "", evicted ? "cold" : "not cold", "warm");
+      std::printf("   %-28s %7.2f ms %7.2f ms\n", "loose files, read and decoded", looseCold, looseWarm);
+      std::printf("   %-28s %7.2f ms %7.2f ms\n", "pack, mapped", packedCold, packedWarm);
+      if (!evicted) std::printf("the page cache could not be dropped, so no run was cold\n");
+      return 0;
+   }
+   catch (std::exception const& exc) {
+      std::fprintf(stderr, "%s\n", exc.what());
+      return 1;
+   }
+}
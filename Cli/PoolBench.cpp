@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "../Engine/BoardPool.h"
+#include "Commands.h"
+
+namespace {
+   auto constexpr ROUNDS = 5;
+   // the direct searches start from the seeds the pool's worker draws, so
+   // both try the same boards
+   auto constexpr NO_GUESS_SEED = std::uint64_t(1);
+   // between the button going down and coming up, about as long as a click
+   auto constexpr PRESS = std::chrono::milliseconds(100);
+
+   double Milliseconds(std::chrono::steady_clock::time_point since) {
+      return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+   }
+
+   // A new game as the game starts one: a board for the restart, then the first click.
+   void Run(BoardSize size) {
+      PoolKey key = { size, SafeZone::Cell };
+      Pos first = { size.width / 3, size.height / 3 };
+
+      auto direct = 0.0;
+      for (auto round = 0; round < ROUNDS; round++) {
+         auto start = std::chrono::steady_clock::now();
+         Board board(size);
+         board.Click(first.x, first.y);
+         direct += Milliseconds(start);
+      }
+
+      BoardPool pool({ key }, 1);
+      auto pooled = 0.0;
+      for (auto round = 0; round < ROUNDS; round++) {
+         // give the worker time to refill, as a player would
+         while (pool.Ready(key) == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+         auto start = std::chrono::steady_clock::now();
+         auto board = pool.Take(key);
+         board->Click(first.x, first.y);
+         pooled += Milliseconds(start);
+         pool.Recycle(std::move(board));
+      }
+
+      std::printf("%6dx%-6d %10d mines  direct %10.3f ms  pooled %8.3f ms\n",
+         size.width, size.height, size.mines, direct / ROUNDS, pooled / ROUNDS);
+   }
+
+   // The first click of a no-guess game: searched for on the clicking thread,
+   // or on the pool's worker from when the button goes down, the click then
+   // waiting for what is left. Pooled boards must solve from the click, as
+   // must the boards their seeds make, which replays rebuild. Fails when the
+   // pool finds fewer boards than asked for, or makes the click wait longer
+   // than searching on the spot.
+   bool RunNoGuess(BoardSize size) {
+      Pos first = { size.width / 3, size.height / 3 };
+
+      auto direct = 0.0;
+      auto directFound = 0;
+      SplitMix64 seeds(NO_GUESS_SEED);
+      for (auto round = 0; round < ROUNDS; round++) {
+         auto start = std::chrono::steady_clock::now();
+         directFound += FindNoGuessSeed(size, first, seeds(), BoardPool::MAX_NO_GUESS_ATTEMPTS).seed ? 1 : 0;
+         direct += Milliseconds(start);
+      }
+
+      BoardPool pool({}, 1, NO_GUESS_SEED);
+      auto waited = 0.0;
+      auto worst = 0.0;
+      auto found = 0;
+      auto ok = true;
+      for (auto round = 0; round < ROUNDS; round++) {
+         pool.RequestNoGuess(size, first);
+         std::this_thread::sleep_for(PRESS);
+         auto start = std::chrono::steady_clock::now();
+         auto board = pool.TakeNoGuess();
+         // sleeping, as the game polls, so the worker has the core to itself
+         while (!board) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            board = pool.TakeNoGuess();
+         }
+         auto wait = Milliseconds(start);
+         waited += wait;
+         worst = std::max(worst, wait);
+         if (!*board) continue;
+         found++;
+         Board rebuilt(size, NO_GUESS_ZONE, (*board)->Seed());
+         ok = SolvesWithoutGuess(**board, first) && SolvesWithoutGuess(rebuilt, first) && ok;
+      }
+
+      auto all = found == ROUNDS;
+      auto faster = waited <= direct;
+      std::printf("%6dx%-6d %10d mines  no guess: direct %8.3f ms, %d found  pooled, after a %lld ms press, %8.3f ms (at most %.3f), %d found"
+         "  of %d  %s%s%s\n",
+         size.width, size.height, size.mines, direct / ROUNDS, directFound, static_cast<long long>(PRESS.count()), waited / ROUNDS, worst,
+         found, ROUNDS, ok ? "solve without guessing" : "GUESS NEEDED", all ? "" : "  SHORT: attempts ran out",
+         faster ? "" : "  SLOWER THAN DIRECT");
+      return ok && all && faster;
+   }
+}
+
+int RunPoolBench(std::span<char* const> args) {
+   if (args.size() >= 2) {
+      auto width = std::atoi(args[0]);
+      auto height = std::atoi(args[1]);
+      auto mines = args.size() >= 3 ? std::atoi(args[2]) : MinesFor(width, height, Difficulty::Hard);
+      Run({ width, height, mines });
+      return RunNoGuess({ width, height, mines }) ? 0 : 1;
+   }
+
+   for (auto side : { 30, 300, 1000, 3000 }) {
+      Run({ side, side, MinesFor(side, side, Difficulty::Hard) });
+   }
+   auto ok = true;
+   for (auto size : { BEGINNER, INTERMEDIATE, EXPERT }) ok = RunNoGuess(size) && ok;
+   return ok ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#include "../Engine/Probability.h"
+#include "Commands.h"
+
+namespace {
+   // Boards with more placements than this are left out of the brute-force check.
+   auto constexpr BRUTE_FORCE_PLACEMENTS = 1 << 20;
+   // Grids are floats, so the exact path can be no closer than their rounding.
+   auto constexpr EXACT_TOLERANCE = 1e-6;
+   // The sampled path is off by the noise of its walks: on average over the
+   // undecided cells, and for the worst cell of any board.
+   auto constexpr SAMPLED_MEAN_TOLERANCE = 0.003;
+   auto constexpr SAMPLED_WORST_TOLERANCE = 0.05;
+
+   // Plays by logic alone from the centre until the solver has nothing more.
+   void PlayUntilStuck(Board& board, Solver& solver) {
+      while (board.State() == GameState::Play) {
+         auto result = solver.Solve();
+         if (result.safe.empty()) break;
+         for (auto pos : result.safe) {
+            if (!board.At(pos.x, pos.y).IsOpened()) solver.Update(board.Click(pos.x, pos.y).changed);
+         }
+      }
+   }
+
+   // Grids go out as width and height (u32) then one float per cell, row-major.
+   void Dump(std::ofstream& out, ProbabilityGrid const& grid) {
+      std::uint32_t size[2] = { std::uint32_t(grid.width), std::uint32_t(grid.height) };
+      out.write(reinterpret_cast<char const*>(size), sizeof(size));
+      out.write(reinterpret_cast<char const*>(grid.mine.data()), std::streamsize(grid.mine.size() * sizeof(float)));
+   }
+
+   // Mine chance of every cell from every placement of the board's mines on
+   // its covered cells that fits the opened numbers; empty if there are too
+   // many placements. Knows nothing of the solver or the frontier.
+   std::vector<double> BruteForce(Board const& board) {
+      auto width = board.Width();
+      auto height = board.Height();
+      std::vector<Pos> covered;
+      std::vector<Pos> numbers;
+      for (auto y = 0; y < height; y++) {
+         for (auto x = 0; x < width; x++) {
+            auto cell = board.At(x, y);
+            if (!cell.IsOpened()) covered.push_back({ x, y });
+            else if (cell.MinesNear() > 0) numbers.push_back({ x, y });
+         }
+      }
+      auto mines = std::size_t(board.Mines());
+      if (mines > covered.size()) return {};
+      auto placements = 1.0;
+      for (std::size_t i = 0; i < mines; i++) placements = placements * double(covered.size() - i) / double(i + 1);
+      if (placements > BRUTE_FORCE_PLACEMENTS) return {};
+
+      std::vector<int> near(std::size_t(width) * height, 0);
+      std::vector<double> mined(near.size(), 0.0);
+      std::vector<std::size_t> chosen(mines);
+      auto fitting = 0.0;
+      auto place = [&](Pos pos, int change) {
+         for (auto y = std::max(0, pos.y - 1); y <= std::min(height - 1, pos.y + 1); y++) {
+            for (auto x = std::max(0, pos.x - 1); x <= std::min(width - 1, pos.x + 1); x++) {
+               near[std::size_t(y) * width + x] += change;
+            }
+         }
+      };
+      auto fits = [&] {
+         return std::all_of(numbers.begin(), numbers.end(), [&](Pos pos) {
+            return near[std::size_t(pos.y) * width + pos.x] == board.At(pos.x, pos.y).MinesNear();
+            });
+      };
+      // every way to choose `mines` of the covered cells, in increasing order
+      auto visit = [&](auto& self, std::size_t depth, std::size_t first) -> void {
+         if (depth == mines) {
+            if (!fits()) return;
+            fitting++;
+            for (auto i : chosen) mined[std::size_t(covered[i].y) * width + covered[i].x]++;
+            return;
+         }
+         for (auto i = first; i + (mines - depth) <= covered.size(); i++) {
+            chosen[depth] = i;
+            place(covered[i], 1);
+            self(self, depth + 1, i + 1);
+            place(covered[i], -1);
+         }
+      };
+      visit(visit, 0, 0);
+      if (fitting == 0) return {};
+      for (auto& chance : mined) chance /= fitting;
+      return mined;
+   }
+
+   struct Errors {
+      double worst = 0;
+      double sum = 0;     // over the cells brute force left undecided
+      std::size_t cells = 0;
+
+      void Add(ProbabilityGrid const& grid, std::vector<double> const& expected) {
+         for (std::size_t i = 0; i < expected.size(); i++) {
+            auto error = std::abs(double(grid.mine[i]) - expected[i]);
+            worst = std::max(worst, error);
+            if (expected[i] > 0 && expected[i] < 1) {
+               sum += error;
+               cells++;
+            }
+         }
+      }
+
+      double Mean() const { return cells ? sum / double(cells) : 0.0; }
+   };
+
+   // Compares the grids on stuck boards small enough to brute force, once as
+   // usual and once with every component forced onto the sampled path.
+   bool Check(BoardSize size, int boards) {
+      auto checked = 0;
+      Errors exactErrors;
+      Errors sampledErrors;
+      // a fixed split of the walks, so the errors do not depend on the machine
+      ProbabilityOptions sampling;
+      sampling.exactCells = 0;
+      sampling.threads = 4;
+      for (auto seed = 0; seed < boards; seed++) {
+         Board board(size, SafeZone::Block, seed);
+         board.Click(size.width / 2, size.height / 2);
+         Solver solver(board);
+         PlayUntilStuck(board, solver);
+         if (board.State() != GameState::Play) continue;
+         auto expected = BruteForce(board);
+         if (expected.empty()) continue;
+
+         checked++;
+         auto exact = MineProbabilities(board, solver);
+         auto sampled = MineProbabilities(board, solver, sampling);
+         exactErrors.Add(exact, expected);
+         sampledErrors.Add(sampled, expected);
+      }
+      auto passed = checked > 0 && exactErrors.worst <= EXACT_TOLERANCE &&
+         sampledErrors.Mean() <= SAMPLED_MEAN_TOLERANCE && sampledErrors.worst <= SAMPLED_WORST_TOLERANCE;
+      std::printf("%6dx%-6d %9d mines  %6d boards brute-forced  exact error %.1e  sampled error %.4f mean %.4f worst  %s\n",
+         size.width, size.height, size.mines, checked, exactErrors.worst,
+         sampledErrors.Mean(), sampledErrors.worst, passed ? "ok" : "FAILED");
+      return passed;
+   }
+
+   void Run(BoardSize size, int boards, std::ofstream* dump) {
+      auto stuck = 0;
+      auto seconds = 0.0;
+      auto frontier = std::size_t(0);
+      auto components = std::size_t(0);
+      auto sampled = std::size_t(0);
+      for (auto seed = 0; seed < boards; seed++) {
+         Board board(size, SafeZone::Block, seed);
+         board.Click(size.width / 2, size.height / 2);
+         Solver solver(board);
+         PlayUntilStuck(board, solver);
+         if (board.State() != GameState::Play) continue;
+
+         auto start = std::chrono::steady_clock::now();
+         auto grid = MineProbabilities(board, solver);
+         seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+         stuck++;
+         frontier += grid.frontier;
+         components += grid.components;
+         sampled += grid.sampled;
+         if (dump) Dump(*dump, grid);
+      }
+      if (stuck == 0) {
+         std::printf("%6dx%-6d %9d mines  every board solved by logic\n", size.width, size.height, size.mines);
+         return;
+      }
+      std::printf("%6dx%-6d %9d mines  %6d stuck boards  frontier %8.1f  components %7.1f  sampled %5.2f  %9.3f ms per grid\n",
+         size.width, size.height, size.mines, stuck, double(frontier) / stuck, double(components) / stuck,
+         double(sampled) / stuck, seconds * 1e3 / stuck);
+   }
+}
+
+int RunProbabilityBench(std::span<char* const> args) {
+   if (args.size() >= 2) {
+      auto width = std::atoi(args[0]);
+      auto height = std::atoi(args[1]);
+      auto mines = args.size() >= 3 ? std::atoi(args[2]) : MinesFor(width, height, Difficulty::Hard);
+      std::ofstream dump;
+      if (args.size() >= 4) dump.open(args[3], std::ios::binary);
+      Run({ width, height, mines }, 100, dump.is_open() ? &dump : nullptr);
+      return 0;
+   }
+
+   auto passed = true;
+   passed &= Check({ 6, 6, 6 }, 1000);
+   passed &= Check({ 8, 8, 10 }, 1000);
+   passed &= Check({ 9, 9, 10 }, 1000);
+   passed &= Check({ 16, 4, 10 }, 1000);
+
+   Run({ 9, 9, 10 }, 10000, nullptr);
+   Run({ 16, 16, 40 }, 5000, nullptr);
+   Run({ 30, 16, 99 }, 5000, nullptr);
+   Run({ 200, 200, MinesFor(200, 200, Difficulty::Hard) }, 20, nullptr);
+   Run({ 1000, 1000, MinesFor(1000, 1000, Difficulty::Medium) }, 3, nullptr);
+   return passed ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../Engine/Bot.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/TaskPool.h"
+#include "Commands.h"
+
+namespace {
+   auto constexpr OVERHEAD_SCOPES = 1'000'000;
+
+   double Seconds(std::chrono::steady_clock::time_point since) {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+   }
+
+   std::size_t Occurrences(std::string const& text, char const* pattern) {
+      auto count = std::size_t(0);
+      for (auto at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) count++;
+      return count;
+   }
+
+   // What a scope and a counter cost when recording, ring wrapping included.
+   void Overhead() {
+      Profile::Reset();
+      auto start = std::chrono::steady_clock::now();
+      for (auto i = 0; i < OVERHEAD_SCOPES; i++) {
+         Profile::ScopedTimer timer("overhead");
+      }
+      auto scopeSeconds = Seconds(start);
+      start = std::chrono::steady_clock::now();
+      for (auto i = 0; i < OVERHEAD_SCOPES; i++) Profile::Count("overhead", i);
+      auto countSeconds = Seconds(start);
+      std::printf("scope %.1f ns, counter %.1f ns, %zu events dropped by the ring of %zu\n",
+         scopeSeconds * 1e9 / OVERHEAD_SCOPES, countSeconds * 1e9 / OVERHEAD_SCOPES,
+         Profile::ThisThread().Dropped(), Profile::EventRing::CAPACITY);
+   }
+
+   // Bot games on every thread, a scope and a clicks counter per game, and
+   // the board's own scopes when MINESWEEPER_PROFILE is defined. Checks the
+   // trace holds every event recorded, or counts it as dropped.
+   bool Trace(std::size_t games, char const* path) {
+      Profile::Reset();
+      TaskPool pool;
+      BoardSize size = { 30, 16, 99 };
+      for (std::size_t i = 0; i < games; i++) {
+         pool.Submit([size, i] {
+            Profile::ScopedTimer timer("game");
+            Board board(size, SafeZone::Cell, SplitMix64(i)());
+            auto result = PlayBot(board, { size.width / 2, size.height / 2 });
+            Profile::Count("clicks", std::int64_t(result.clicks));
+            });
+      }
+      pool.Wait();
+
+      std::ostringstream json;
+      auto start = std::chrono::steady_clock::now();
+      auto stats = Profile::WriteChromeTrace(json);
+      auto writeSeconds = Seconds(start);
+      auto text = json.str();
+      auto scopes = Occurrences(text, "\"ph\":\"X\"");
+      auto counters = Occurrences(text, "\"ph\":\"C\"");
+      auto gameScopes = Occurrences(text, "{\"name\":\"game\"");
+
+      auto ok = scopes + counters == stats.events && (stats.dropped > 0 || gameScopes == games);
+      std::printf("%zu games on %u threads: %zu events from %zu threads, %zu scopes, %zu counters, %zu dropped, "
+         "%.1f KiB written in %.2f ms  %s\n",
+         games, pool.Threads(), stats.events, stats.threads, scopes, counters, stats.dropped,
+         text.size() / 1024.0, writeSeconds * 1e3, ok ? "complete" : "MISSING EVENTS");
+
+      if (path) {
+         std::ofstream file(path, std::ios::binary | std::ios::trunc);
+         file << text;
+         std::printf("trace written to %s\n", path);
+      }
+      return ok;
+   }
+}
+
+int RunProfileBench(std::span<char* const> args) {
+#ifdef MINESWEEPER_PROFILE
+   std::printf("MINESWEEPER_PROFILE on: board scopes are recorded\n");
+#else
+   std::printf("MINESWEEPER_PROFILE off: board scopes cost nothing\n");
+#endif
+   auto games = args.size() >= 1 ? std::size_t(std::atoll(args[0])) : std::size_t(200);
+   auto path = args.size() >= 2 ? args[1] : nullptr;
+   Overhead();
+   return Trace(games, path) ? 0 : 1;
+}
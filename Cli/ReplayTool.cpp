@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../Engine/Replay.h"
+#include "Commands.h"
+
+namespace {
+   double Seconds(std::chrono::steady_clock::time_point since) {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+   }
+
+   char const* StateName(GameState state) {
+      return state == GameState::Win ? "win" : state == GameState::Defeat ? "defeat" : "unfinished";
+   }
+
+   // A careless player: random cells, one in eight flagged instead of clicked,
+   // a millisecond apart. Good enough to exercise every record kind.
+   std::string RecordRandomGame(BoardSize size, std::uint64_t seed) {
+      std::ostringstream out;
+      Board board(size, SafeZone::Block, seed);
+      ReplayWriter writer(out, { size, SafeZone::Block, seed });
+      Xoshiro256 rng(~seed);
+      auto time = std::uint64_t(0);
+      for (auto i = 0; i < 4 * size.width * size.height && board.State() == GameState::Play; i++) {
+         Pos pos = { int(Bounded(rng, size.width)), int(Bounded(rng, size.height)) };
+         auto action = !board.Started() || Bounded(rng, 8) != 0 ? ReplayAction::Click : ReplayAction::Flag;
+         if (action == ReplayAction::Click) board.Click(pos.x, pos.y);
+         else board.Flag(pos.x, pos.y);
+         time += 1000;
+         writer.Record(action, pos, time);
+      }
+      writer.Finish(EndOf(board), time);
+      return out.str();
+   }
+
+   int SelfCheck() {
+      auto constexpr GAMES = 10000;
+      auto size = BoardSize{ 30, 16, 99 };
+      std::vector<std::string> replays;
+      auto bytes = std::size_t(0);
+      for (auto game = 0; game < GAMES; game++) {
+         replays.push_back(RecordRandomGame(size, game));
+         bytes += replays.back().size();
+      }
+
+      auto mismatches = 0;
+      auto actions = std::size_t(0);
+      auto start = std::chrono::steady_clock::now();
+      for (auto& replay : replays) {
+         std::istringstream in(replay);
+         auto check = PlayReplay(in);
+         actions += check.actions;
+         mismatches += check.Matched() ? 0 : 1;
+      }
+      auto seconds = Seconds(start);
+      std::printf("%d games, %zu actions, %.1f bytes per game: %d mismatched, %.0f games/s %.1f Mactions/s\n",
+         GAMES, actions, double(bytes) / GAMES, mismatches, GAMES / seconds, actions / seconds / 1e6);
+      return mismatches == 0 ? 0 : 1;
+   }
+}
+
+int RunReplay(std::span<char* const> args) {
+   if (args.empty()) return SelfCheck();
+
+   auto failed = 0;
+   auto actions = std::size_t(0);
+   auto start = std::chrono::steady_clock::now();
+   for (auto path : args) {
+      std::ifstream in(path, std::ios::binary);
+      if (!in) {
+         std::printf("%s: cannot open\n", path);
+         failed++;
+         continue;
+      }
+      try {
+         auto check = PlayReplay(in);
+         actions += check.actions;
+         if (!check.expected) {
+            std::printf("%s: cut short after %zu actions, board %s\n", path, check.actions, StateName(check.actual.state));
+            failed++;
+         }
+         else if (!check.Matched()) {
+            std::printf("%s: MISMATCH after %zu actions, recorded %s with %llu opened, replayed %s with %llu opened\n",
+               path, check.actions, StateName(check.expected->state), (unsigned long long)check.expected->opened,
+               StateName(check.actual.state), (unsigned long long)check.actual.opened);
+            failed++;
+         }
+      }
+      // anything one file throws fails that file, not the batch
+      catch (std::exception const& e) {
+         std::printf("%s: %s\n", path, e.what());
+         failed++;
+      }
+   }
+   auto seconds = Seconds(start);
+   std::printf("%zu replays, %d failed, %zu actions in %.3f s\n", args.size(), failed, actions, seconds);
+   return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#include "../Engine/Bot.h"
+#include "../Engine/TaskPool.h"
+#include "Commands.h"
+
+namespace {
+   auto constexpr GAMES_PER_TASK = std::size_t(64);
+
+   struct Totals {
+      std::size_t games = 0;
+      std::size_t wins = 0;
+      std::size_t clicks = 0;
+      std::size_t guesses = 0;
+      std::size_t threeBV = 0;
+      // XOR of a hash per game, so it does not depend on the order games finish in
+      std::uint64_t checksum = 0;
+
+      void Add(Totals const& other) {
+         games += other.games;
+         wins += other.wins;
+         clicks += other.clicks;
+         guesses += other.guesses;
+         threeBV += other.threeBV;
+         checksum ^= other.checksum;
+      }
+   };
+
+   bool ParseDifficulty(char const* text, Difficulty& difficulty) {
+      struct Name {
+         char const* name;
+         Difficulty difficulty;
+      };
+      Name constexpr NAMES[] = {
+         { "easy", Difficulty::Easy },
+         { "medium", Difficulty::Medium },
+         { "hard", Difficulty::Hard },
+         { "impossible", Difficulty::Impossible },
+      };
+      for (auto& name : NAMES) {
+         if (std::strcmp(text, name.name) == 0) {
+            difficulty = name.difficulty;
+            return true;
+         }
+      }
+      return false;
+   }
+
+   // Game i is always the board of the i-th seed, played from the centre.
+   Totals Play(BoardSize size, std::uint64_t seed, std::size_t begin, std::size_t end) {
+      Totals totals;
+      for (auto i = begin; i < end; i++) {
+         Board board(size, SafeZone::Cell, SplitMix64(seed + i)());
+         auto result = PlayBot(board, { size.width / 2, size.height / 2 });
+         auto threeBV = ThreeBV(board);
+         totals.games++;
+         totals.wins += result.state == GameState::Win ? 1 : 0;
+         totals.clicks += result.clicks;
+         totals.guesses += result.guesses;
+         totals.threeBV += threeBV;
+         totals.checksum ^= SplitMix64(i ^ (std::uint64_t(result.clicks) << 32 | result.guesses << 1 | result.state))();
+      }
+      return totals;
+   }
+
+   void Run(BoardSize size, std::size_t games, unsigned threads, std::uint64_t seed) {
+      TaskPool pool(threads);
+      Totals totals;
+      std::mutex mutex;
+
+      auto start = std::chrono::steady_clock::now();
+      ParallelFor(pool, games, GAMES_PER_TASK, [&](std::size_t begin, std::size_t end) {
+         auto part = Play(size, seed, begin, end);
+         std::lock_guard lock(mutex);
+         totals.Add(part);
+         });
+      auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      auto perGame = [&totals](std::size_t value) { return double(value) / double(totals.games); };
+      std::printf("%6dx%-6d %7d mines  %9zu games  %6.2f%% won  %7.1f clicks  %5.2f guesses  %7.1f 3BV per game  "
+         "%9.0f games/s on %u threads  checksum %016llx\n",
+         size.width, size.height, size.mines, totals.games, 100.0 * perGame(totals.wins), perGame(totals.clicks),
+         perGame(totals.guesses), perGame(totals.threeBV), totals.games / seconds, pool.Threads(),
+         static_cast<unsigned long long>(totals.checksum));
+   }
+}
+
+int RunSimBench(std::span<char* const> args) {
+   if (args.size() >= 2) {
+      auto width = std::atoi(args[0]);
+      auto height = std::atoi(args[1]);
+      auto difficulty = Difficulty::Hard;
+      if (args.size() >= 3 && !ParseDifficulty(args[2], difficulty)) {
+         std::printf("unknown difficulty %s, expected easy, medium, hard or impossible\n", args[2]);
+         return 1;
+      }
+      auto games = args.size() >= 4 ? std::size_t(std::atoll(args[3])) : std::size_t(10000);
+      auto threads = args.size() >= 5 ? unsigned(std::atoi(args[4])) : 0u;
+      auto seed = args.size() >= 6 ? std::uint64_t(std::strtoull(args[5], nullptr, 0)) : std::uint64_t(1);
+      BoardSize size = { width, height, MinesFor(width, height, difficulty) };
+      // one board up front, so a bad size is reported here rather than thrown in every task
+      try {
+         Board board(size, SafeZone::Cell, seed);
+      }
+      catch (std::invalid_argument const& e) {
+         std::printf("%s\nusage: sim [width height [difficulty [games [threads [seed]]]]]\n", e.what());
+         return 1;
+      }
+      Run(size, games, threads, seed);
+      return 0;
+   }
+
+   for (auto difficulty : { Difficulty::Easy, Difficulty::Medium, Difficulty::Hard }) {
+      Run({ 30, 16, MinesFor(30, 16, difficulty) }, 10000, 0, 1);
+   }
+   return 0;
+}
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../Engine/Solver.h"
+#include "Commands.h"
+
+namespace {
+   struct Outcome {
+      bool solved;
+      std::size_t opened;
+   };
+
+   // Opens the centre, then keeps opening whatever the solver proves safe.
+   Outcome Play(BoardSize size, std::uint64_t seed) {
+      Board board(size, SafeZone::Block, seed);
+      board.Click(size.width / 2, size.height / 2);
+      Solver solver(board);
+      while (board.State() == GameState::Play) {
+         auto result = solver.Solve();
+         if (result.safe.empty()) break;
+         for (auto pos : result.safe) {
+            if (board.At(pos.x, pos.y).IsOpened()) continue;
+            solver.Update(board.Click(pos.x, pos.y).changed);
+         }
+      }
+      return { board.State() == GameState::Win, board.Opened() };
+   }
+
+   void Run(BoardSize size, int boards) {
+      auto solved = 0;
+      auto opened = std::size_t(0);
+      auto start = std::chrono::steady_clock::now();
+      for (auto seed = 0; seed < boards; seed++) {
+         auto outcome = Play(size, seed);
+         solved += outcome.solved ? 1 : 0;
+         opened += outcome.opened;
+      }
+      auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      std::printf("%6dx%-6d %9d mines  %7d boards  solved %5.1f%%  %10.0f boards/s %8.1f Mcells/s\n",
+         size.width, size.height, size.mines, boards, 100.0 * solved / boards, boards / seconds, opened / seconds / 1e6);
+   }
+}
+
+int RunSolveBench(std::span<char* const> args) {
+   if (args.size() >= 2) {
+      auto width = std::atoi(args[0]);
+      auto height = std::atoi(args[1]);
+      auto mines = args.size() >= 3 ? std::atoi(args[2]) : MinesFor(width, height, Difficulty::Medium);
+      auto cells = std::size_t(width) * height;
+      Run({ width, height, mines }, int(std::max<std::size_t>(1, 10'000'000 / cells)));
+      return 0;
+   }
+
+   // the classic beginner, intermediate and expert boards, then large sparse ones
+   Run({ 9, 9, 10 }, 100000);
+   Run({ 16, 16, 40 }, 50000);
+   Run({ 30, 16, 99 }, 50000);
+   Run({ 1000, 1000, MinesFor(1000, 1000, Difficulty::Easy) }, 10);
+   Run({ 3000, 3000, MinesFor(3000, 3000, Difficulty::Easy) }, 2);
+   return 0;
+}
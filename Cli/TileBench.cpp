@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../Engine/DirtyCells.h"
+#include "../Engine/Solver.h"
+#include "../Engine/TileMap.h"
+#include "Commands.h"
+
+namespace {
+   double Seconds(std::chrono::steady_clock::time_point since) {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+   }
+
+   // Plays a board the way the game redraws it: every action's changed cells
+   // and the pressed cells go through DirtyCells into TileMap::Update. Every
+   // few actions the map is checked against a full Build, and a copy kept
+   // up to date through the changed ranges against it as well.
+   void Run(BoardSize size, std::size_t checkEvery) {
+      Board board(size, SafeZone::Block, 1);
+      DirtyCells dirty(size.width, size.height);
+      TileMap tiles(size.width, size.height);
+      TileMap reference(size.width, size.height);
+      std::vector<TileInstance> uploaded;
+      std::vector<Pos> pressed;
+      Xoshiro256 rng(7);
+
+      auto start = std::chrono::steady_clock::now();
+      tiles.Build(board, {});
+      auto buildSeconds = Seconds(start);
+      uploaded.assign(tiles.Instances().begin(), tiles.Instances().end());
+      tiles.ClearChanged();
+      dirty.Clear();
+
+      auto actions = std::size_t(0);
+      auto updateSeconds = 0.0;
+      auto uploadedInstances = std::size_t(0);
+      auto mismatches = std::size_t(0);
+      auto missed = std::size_t(0);
+      auto act = [&](ActionResult result) {
+         dirty.Mark(result.changed);
+         if (result.state != GameState::Play) dirty.MarkAll();
+
+         // press the next cell, as holding the button does
+         dirty.Mark(pressed);
+         pressed.assign(1, Pos{ int(Bounded(rng, size.width)), int(Bounded(rng, size.height)) });
+         dirty.Mark(pressed);
+
+         auto update = std::chrono::steady_clock::now();
+         TileView view = { pressed, nullptr };
+         if (dirty.All()) tiles.Build(board, view);
+         else tiles.Update(board, dirty.Cells(), view);
+         dirty.Clear();
+         updateSeconds += Seconds(update);
+
+         // what an upload of the changed ranges would copy
+         for (auto range : tiles.Changed()) {
+            uploadedInstances += range.last - range.first;
+            std::copy(tiles.Instances().begin() + range.first, tiles.Instances().begin() + range.last, uploaded.begin() + range.first);
+         }
+         tiles.ClearChanged();
+
+         if (++actions % checkEvery == 0) {
+            reference.Build(board, view);
+            for (std::size_t i = 0; i < uploaded.size(); i++) {
+               if (!(tiles.Instances()[i] == reference.Instances()[i])) mismatches++;
+               if (!(uploaded[i] == reference.Instances()[i])) missed++;
+            }
+         }
+      };
+
+      // the solver plays, with a flag on every proven mine and a random
+      // guess whenever it gets stuck
+      act(board.Click(size.width / 2, size.height / 2));
+      Solver solver(board);
+      while (board.State() == GameState::Play) {
+         auto result = solver.Solve();
+         for (auto pos : result.mines) {
+            if (board.At(pos.x, pos.y).State() == RCellState::Still) act(board.Flag(pos.x, pos.y));
+         }
+         for (auto pos : result.safe) {
+            if (board.State() != GameState::Play) break;
+            if (board.At(pos.x, pos.y).IsOpened()) continue;
+            auto action = board.Click(pos.x, pos.y);
+            solver.Update(action.changed);
+            act(action);
+         }
+         if (!result.safe.empty() || board.State() != GameState::Play) continue;
+         Pos guess;
+         do {
+            guess = { int(Bounded(rng, size.width)), int(Bounded(rng, size.height)) };
+         } while (board.At(guess.x, guess.y).IsOpened() || solver.At(guess.x, guess.y) != Knowledge::Unknown);
+         auto action = board.Click(guess.x, guess.y);
+         solver.Update(action.changed);
+         act(action);
+      }
+
+      auto cells = std::size_t(size.width) * size.height;
+      std::printf("%6dx%-6d %9d mines  build %6.2f ns/cell  %7zu actions  %8.2f us/update  %9.1f instances uploaded per action  %s\n",
+         size.width, size.height, size.mines, buildSeconds * 1e9 / cells, actions, updateSeconds * 1e6 / actions,
+         double(uploadedInstances) / actions,
+         mismatches == 0 && missed == 0 ? "matches full builds" : "MISMATCH");
+      if (mismatches != 0 || missed != 0) {
+         std::printf("   %zu instances differ from a full build, %zu changes missed by the upload ranges\n", mismatches, missed);
+      }
+   }
+}
+
+int RunTileBench(std::span<char* const> args) {
+   if (args.size() >= 2) {
+      auto width = std::atoi(args[0]);
+      auto height = std::atoi(args[1]);
+      auto mines = args.size() >= 3 ? std::atoi(args[2]) : MinesFor(width, height, Difficulty::Medium);
+      Run({ width, height, mines }, 1000);
+      return 0;
+   }
+
+   Run({ 9, 9, 10 }, 1);
+   Run({ 30, 16, 99 }, 1);
+   Run({ 200, 200, MinesFor(200, 200, Difficulty::Medium) }, 100);
+   Run({ 500, 500, MinesFor(500, 500, Difficulty::Easy) }, 2000);
+   return 0;
+}
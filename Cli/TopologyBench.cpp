@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#include "../Engine/Board.h"
+#include "../Engine/Random.h"
+#include "Commands.h"
+
+namespace {
+   auto constexpr GAMES = 200;
+
+   double Seconds(std::chrono::steady_clock::time_point since) {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+   }
+
+   // Whether a and b neighbour, worked out from the definitions rather than
+   // from the stencils the boards use.
+   using Neighbours = bool (*)(BoardSize size, Pos a, Pos b);
+
+   bool MooreNear(BoardSize, Pos a, Pos b) {
+      return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y)) == 1;
+   }
+
+   bool TorusNear(BoardSize size, Pos a, Pos b) {
+      auto dx = std::abs(a.x - b.x);
+      auto dy = std::abs(a.y - b.y);
+      return std::max(std::min(dx, size.width - dx), std::min(dy, size.height - dy)) == 1;
+   }
+
+   bool VonNeumannNear(BoardSize, Pos a, Pos b) {
+      return std::abs(a.x - b.x) + std::abs(a.y - b.y) == 1;
+   }
+
+   // Odd rows shifted right: in cube coordinates neighbours are one apart.
+   bool HexNear(BoardSize, Pos a, Pos b) {
+      auto q = [](Pos pos) { return pos.x - (pos.y - (pos.y & 1)) / 2; };
+      auto dq = q(a) - q(b);
+      auto dr = a.y - b.y;
+      return (std::abs(dq) + std::abs(dr) + std::abs(dq + dr)) / 2 == 1;
+   }
+
+   // Calls `visit(x, y)` for each neighbour of pos. Every topology keeps to
+   // the 3x3 block around the cell, wrapped around the edges.
+   template <typename Visit>
+   void ForEachNear(BoardSize size, Pos pos, Neighbours near, Visit&& visit) {
+      std::array<Pos, 9> candidates;
+      auto count = 0;
+      for (auto dy = -1; dy <= 1; dy++) {
+         for (auto dx = -1; dx <= 1; dx++) {
+            candidates[count++] = { (pos.x + dx + size.width) % size.width, (pos.y + dy + size.height) % size.height };
+         }
+      }
+      std::sort(candidates.begin(), candidates.end(), [](Pos a, Pos b) { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+      auto end = std::unique(candidates.begin(), candidates.end(), [](Pos a, Pos b) { return a.x == b.x && a.y == b.y; });
+      for (auto at = candidates.begin(); at != end; ++at) {
+         if (near(size, pos, *at)) visit(at->x, at->y);
+      }
+   }
+
+   struct Played {
+      bool ok = true;
+      bool won = false;
+      // a digest of every action's changed cells, to compare two boards by
+      std::uint64_t digest = 0;
+   };
+
+   // Every cell's byte, the border around the board included.
+   template <typename BoardType>
+   std::vector<std::uint8_t> Snapshot(BoardType const& board) {
+      std::vector<std::uint8_t> bytes;
+      for (auto y = -1; y <= board.Height(); y++) {
+         for (auto x = -1; x <= board.Width(); x++) bytes.push_back(board.At(x, y).bits);
+      }
+      return bytes;
+   }
+
+   // Acts on cells just and far outside the board, which must change
+   // nothing, not even the border.
+   template <typename BoardType>
+   bool IgnoresOutside(BoardType& board) {
+      auto width = board.Width();
+      auto height = board.Height();
+      Pos const outside[] = {
+         { -1, 0 }, { 0, -1 }, { width, 0 }, { 0, height }, { -1, -1 }, { width, height },
+         { -width - 2, height / 2 }, { width / 2, 2 * height + 2 },
+         { std::numeric_limits<int>::min(), std::numeric_limits<int>::min() },
+         { std::numeric_limits<int>::max(), std::numeric_limits<int>::max() },
+      };
+      auto before = Snapshot(board);
+      auto state = board.State();
+      auto opened = board.Opened();
+      auto flagged = board.Flagged();
+      auto started = board.Started();
+      auto ok = true;
+      for (auto pos : outside) {
+         for (auto result : { board.Click(pos.x, pos.y), board.Flag(pos.x, pos.y), board.Chord(pos.x, pos.y) }) {
+            ok = ok && result.changed.empty() && result.state == state;
+         }
+         board.Start(pos.x, pos.y);
+      }
+      return ok && Snapshot(board) == before &&
+         board.State() == state && board.Opened() == opened && board.Flagged() == flagged && board.Started() == started;
+   }
+
+   // Clicks a random cell, checks the safe zone and every count against
+   // `near`, then clicks every other safe cell, which must win. Checking
+   // acts outside the board as well, before and after the first click.
+   template <typename BoardType>
+   Played PlayGame(BoardSize size, std::uint64_t seed, Neighbours near, bool check) {
+      BoardType board(size, SafeZone::Block, seed);
+      Xoshiro256 rng(seed);
+      Pos first = { int(Bounded(rng, size.width)), int(Bounded(rng, size.height)) };
+      Played played;
+      auto add = [&played](ActionResult result) {
+         for (auto pos : result.changed) played.digest = (played.digest ^ std::uint64_t(pos.y * 65536 + pos.x)) * 0x100000001B3ull;
+      };
+      if (check && !IgnoresOutside(board)) played.ok = false;
+      add(board.Click(first.x, first.y));
+
+      if (check) {
+         if (!IgnoresOutside(board)) played.ok = false;
+         // the block around the centre is the largest; if the mines do not
+         // leave room for it, only the clicked cell is kept clear
+         auto centre = 0;
+         ForEachNear(size, { size.width / 2, size.height / 2 }, near, [&centre](int, int) { centre++; });
+         auto block = size.mines <= size.width * size.height - centre - 1;
+         auto zone = 0;
+         board.IterateNear(first.x, first.y, [&](int x, int y) {
+            zone++;
+            if ((block || (x == first.x && y == first.y)) && board.At(x, y).IsMined()) played.ok = false;
+            if ((x != first.x || y != first.y) && !near(size, first, { x, y })) played.ok = false;
+            });
+         for (auto y = 0; y < size.height; y++) {
+            for (auto x = 0; x < size.width; x++) {
+               auto mines = 0;
+               auto neighbours = 0;
+               ForEachNear(size, { x, y }, near, [&](int nearX, int nearY) {
+                  neighbours++;
+                  mines += board.At(nearX, nearY).IsMined() ? 1 : 0;
+                  });
+               if (board.At(x, y).MinesNear() != mines) played.ok = false;
+               if (x == first.x && y == first.y && zone != neighbours + 1) played.ok = false;
+            }
+         }
+      }
+
+      for (auto y = 0; y < size.height && board.State() == GameState::Play; y++) {
+         for (auto x = 0; x < size.width && board.State() == GameState::Play; x++) {
+            if (!board.At(x, y).IsMined() && !board.At(x, y).IsOpened()) add(board.Click(x, y));
+         }
+      }
+      played.won = board.State() == GameState::Win && board.Opened() == std::size_t(size.width) * size.height - size.mines;
+      played.ok = played.ok && played.won;
+      return played;
+   }
+
+   // Checks a topology sized at run time, then plays the same games on it
+   // and on the one compiled for the preset, which must go the same way.
+   template <template <int, int> class Topology, BoardSize Size>
+   bool Run(char const* name, Neighbours near) {
+      auto ok = true;
+      for (auto game = 0; game < GAMES / 10; game++) {
+         ok = PlayGame<BasicBoard<CellStore, Topology<0, 0>>>(Size, SplitMix64(game)(), near, true).ok && ok;
+      }
+
+      auto same = true;
+      for (auto game = 0; game < GAMES; game++) {
+         auto seed = SplitMix64(game)();
+         auto runtime = PlayGame<BasicBoard<CellStore, Topology<0, 0>>>(Size, seed, near, false);
+         auto fixed = PlayGame<PresetBoard<Topology, Size>>(Size, seed, near, false);
+         same = same && runtime.ok && fixed.ok && runtime.digest == fixed.digest;
+      }
+
+      auto time = [](auto play) {
+         auto best = 1e30;
+         for (auto run = 0; run < 3; run++) {
+            auto start = std::chrono::steady_clock::now();
+            for (auto game = 0; game < GAMES; game++) play(SplitMix64(game)());
+            best = std::min(best, Seconds(start));
+         }
+         return best * 1e6 / GAMES;
+      };
+      auto runtimeUs = time([near](std::uint64_t seed) { PlayGame<BasicBoard<CellStore, Topology<0, 0>>>(Size, seed, near, false); });
+      auto fixedUs = time([near](std::uint64_t seed) { PlayGame<PresetBoard<Topology, Size>>(Size, seed, near, false); });
+
+      std::printf("   %-10s %2dx%-2d %3d mines  %-7s  sized at run time %7.2f us/game, compiled for the size %7.2f us/game  %s\n",
+         name, Size.width, Size.height, Size.mines, ok ? "counts" : "WRONG", runtimeUs, fixedUs, same ? "same games" : "GAMES DIFFER");
+      return ok && same;
+   }
+
+   template <BoardSize Size>
+   bool RunAll() {
+      auto ok = Run<Moore, Size>("moore", MooreNear);
+      ok = Run<Torus, Size>("torus", TorusNear) && ok;
+      ok = Run<VonNeumann, Size>("vonneumann", VonNeumannNear) && ok;
+      ok = Run<Hex, Size>("hex", HexNear) && ok;
+      return ok;
+   }
+}
+
+int RunTopologyBench(std::span<char* const> args) {
+   if (args.size() >= 2) {
+      BoardSize size = { std::atoi(args[0]), std::atoi(args[1]), 0 };
+      size.mines = args.size() >= 3 ? std::atoi(args[2]) : MinesFor(size.width, size.height, Difficulty::Medium);
+      Neighbours const nears[] = { MooreNear, TorusNear, VonNeumannNear, HexNear };
+      char const* const names[] = { "moore", "torus", "vonneumann", "hex" };
+      auto ok = true;
+      for (auto i = 0; i < 4; i++) {
+         auto games = 0;
+         auto good = 0;
+         for (auto game = 0; game < GAMES / 10; game++, games++) {
+            auto seed = SplitMix64(game)();
+            Played played;
+            if (i == 0) played = PlayGame<BasicBoard<CellStore, Moore<>>>(size, seed, nears[i], true);
+            if (i == 1) played = PlayGame<BasicBoard<CellStore, Torus<>>>(size, seed, nears[i], true);
+            if (i == 2) played = PlayGame<BasicBoard<CellStore, VonNeumann<>>>(size, seed, nears[i], true);
+            if (i == 3) played = PlayGame<BasicBoard<CellStore, Hex<>>>(size, seed, nears[i], true);
+            good += played.ok ? 1 : 0;
+         }
+         std::printf("   %-10s %dx%d %d mines: %d of %d games counted right and won\n", names[i], size.width, size.height, size.mines, good, games);
+         ok = ok && good == games;
+      }
+      return ok ? 0 : 1;
+   }
+
+   auto ok = RunAll<BEGINNER>();
+   ok = RunAll<INTERMEDIATE>() && ok;
+   ok = RunAll<EXPERT>() && ok;
+   return ok ? 0 : 1;
+}
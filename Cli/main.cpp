@@ -0,0 +1,58 @@
+//
+// main.cpp
+// Headless command line tools on top of the board engine.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <span>
+
+#include "Commands.h"
+
+namespace {
+   struct Command {
+      char const* name;
+      char const* usage;
+      int (*run)(std::span<char* const> args);
+   };
+
+   Command constexpr COMMANDS[] = {
+      { "alloc", "alloc [width height [mines]]", RunAllocBench },
+      { "assets", "assets [directory [threads]]", RunAssetBench },
+      { "camera", "camera [width height [mines]]", RunCameraBench },
+      { "flood", "flood [width height [mines]]", RunFloodBench },
+      { "frames", "frames [fps [seconds]]", RunFrameBench },
+      { "generate", "generate [width height [mines]]", RunGenerateBench },
+      { "input", "input [frames [clicks-per-frame]]", RunInputBench },
+      { "layout", "layout [width height [mines]]", RunLayoutBench },
+      { "log", "log [crash]", RunLogBench },
+      { "noguess", "noguess [width height [mines [count]]]", RunNoGuessBench },
+      { "pack", "pack [pack-file [directory]]", RunPackBench },
+      { "pool", "pool [width height [mines]]", RunPoolBench },
+      { "probability", "probability [width height [mines [dump-file]]]", RunProbabilityBench },
+      { "profile", "profile [games [trace-file]]", RunProfileBench },
+      { "replay", "replay [file...]", RunReplay },
+      { "sim", "sim [width height [difficulty [games [threads [seed]]]]]", RunSimBench },
+      { "solve", "solve [width height [mines]]", RunSolveBench },
+      { "tiles", "tiles [width height [mines]]", RunTileBench },
+      { "topology", "topology [width height [mines]]", RunTopologyBench },
+   };
+
+   int Usage() {
+      std::printf("usage: MinesweeperCli <command> [args]\n");
+      for (auto& command : COMMANDS) {
+         std::printf("   %s\n", command.usage);
+      }
+      return 1;
+   }
+}
+
+int main(int argc, char* argv[]) {
+   if (argc < 2) return Usage();
+   for (auto& command : COMMANDS) {
+      if (std::strcmp(argv[1], command.name) == 0) {
+         return command.run(std::span<char* const>(argv + 2, argc - 2));
+      }
+   }
+   return Usage();
+}
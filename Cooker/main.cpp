@@ -0,0 +1,187 @@
+//
+// main.cpp
+// The asset cooker: turns the PNG textures under img/ and the WAVE sounds
+// under sounds/ into one asset pack the game maps at startup, see
+// Engine/AssetPack.h. Runs as a build step and on any platform.
+//
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../Engine/AssetLoader.h"
+#include "../Engine/AssetPack.h"
+#include "../Engine/Png.h"
+#include "../Engine/Wave.h"
+
+namespace {
+   // The sprites share one texture, so lower levels would bleed between
+   // them; more can be asked for on the command line.
+   auto constexpr DEFAULT_LEVELS = 1u;
+
+   PackEntry MakeEntry(std::string const& name, PackKind kind) {
+      if (name.size() >= PackEntry::NAME_SIZE) throw std::runtime_error("Asset name too long: " + name);
+      PackEntry entry = {};
+      std::copy(name.begin(), name.end(), entry.name);
+      entry.kind = kind;
+      return entry;
+   }
+
+   // Each level a 2x2 box filter of the one above; an odd last row or
+   // column is dropped.
+   std::vector<std::uint8_t> MakeLevels(Image const& image, std::uint32_t levels) {
+      std::vector<std::uint8_t> out = image.pixels;
+      auto above = std::size_t(0);
+      for (std::uint32_t level = 1; level < levels; level++) {
+         auto width = std::max(image.width >> level, 1u);
+         auto height = std::max(image.height >> level, 1u);
+         auto aboveWidth = std::max(image.width >> (level - 1), 1u);
+         auto aboveHeight = std::max(image.height >> (level - 1), 1u);
+         auto start = out.size();
+         out.resize(start + std::size_t(width) * height * 4);
+         for (std::uint32_t y = 0; y < height; y++) {
+            for (std::uint32_t x = 0; x < width; x++) {
+               for (auto c = 0; c < 4; c++) {
+                  auto sum = 0u;
+                  for (auto dy = 0u; dy < 2; dy++) {
+                     for (auto dx = 0u; dx < 2; dx++) {
+                        auto sx = std::min(x * 2 + dx, aboveWidth - 1);
+                        auto sy = std::min(y * 2 + dy, aboveHeight - 1);
+                        sum += out[above + (std::size_t(sy) * aboveWidth + sx) * 4 + c];
+                     }
+                  }
+                  out[start + (std::size_t(y) * width + x) * 4 + c] = std::uint8_t((sum + 2) / 4);
+               }
+            }
+         }
+         above = start;
+      }
+      return out;
+   }
+
+   void CookTexture(PackWriter& pack, std::filesystem::path const& directory, std::string const& name, std::uint32_t levels) {
+      auto file = ReadFile(directory / name);
+      auto image = DecodePng({ file.data.get(), file.size });
+      auto maxLevels = std::uint32_t(std::bit_width(std::max(image.width, image.height)));
+      levels = std::clamp(levels, 1u, maxLevels);
+      auto pixels = MakeLevels(image, levels);
+
+      auto entry = MakeEntry(name, PackKind::Texture);
+      entry.format = image.srgb ? PackFormat::Rgba8Srgb : PackFormat::Rgba8;
+      entry.width = image.width;
+      entry.height = image.height;
+      entry.levels = levels;
+      entry.offset = pack.Append(pixels);
+      entry.size = pixels.size();
+      pack.Add(entry);
+      std::printf("   %-24s %4u x %-4u %u level%s, %s, %zu KiB from %zu KiB\n", name.c_str(), image.width, image.height,
+         levels, levels == 1 ? "" : "s", image.srgb ? "sRGB" : "linear", pixels.size() / 1024, file.size / 1024);
+   }
+
+   // All sounds must share a format: they go into one blob under one
+   // WAVEFORMATEX, which the game hands to the audio engine as it is.
+   void CookSounds(PackWriter& pack, std::filesystem::path const& directory, std::vector<std::string> const& names) {
+      if (names.empty()) return;
+      std::vector<WaveFile> waves;
+      for (auto const& name : names) {
+         auto file = ReadFile(directory / name);
+         waves.push_back(ParseWave(std::move(file.data), file.size));
+         auto const& format = waves.back().format;
+         auto const& first = waves.front().format;
+         if (format.formatTag != first.formatTag || format.channels != first.channels || format.sampleRate != first.sampleRate ||
+            format.bitsPerSample != first.bitsPerSample) {
+            throw std::runtime_error(name + " is not in the format of " + names.front());
+         }
+      }
+
+      auto const& format = waves.front().format;
+      std::uint8_t waveFormat[18] = {};
+      std::memcpy(waveFormat, &format, sizeof(format));
+      auto formatEntry = MakeEntry("sounds/format", PackKind::SoundFormat);
+      formatEntry.offset = pack.Append(waveFormat);
+      formatEntry.size = sizeof(waveFormat);
+      pack.Add(formatEntry);
+
+      std::vector<std::uint8_t> samples;
+      std::vector<std::size_t> starts;
+      for (auto const& wave : waves) {
+         starts.push_back(samples.size());
+         samples.insert(samples.end(), wave.Samples(), wave.Samples() + wave.samplesSize);
+      }
+      auto dataEntry = MakeEntry("sounds/data", PackKind::SoundData);
+      dataEntry.offset = pack.Append(samples);
+      dataEntry.size = samples.size();
+      pack.Add(dataEntry);
+
+      for (std::size_t i = 0; i < waves.size(); i++) {
+         auto entry = MakeEntry(names[i], PackKind::Sound);
+         entry.offset = dataEntry.offset + starts[i];
+         entry.size = waves[i].samplesSize;
+         entry.waveFormat = std::uint32_t(formatEntry.offset);
+         pack.Add(entry);
+      }
+      std::printf("   %-24s %zu sounds, %u Hz, %u channels, %u bits, %.1f s, %zu KiB\n", "sounds/data", waves.size(),
+         format.sampleRate, format.channels, format.bitsPerSample, double(samples.size()) / format.bytesPerSecond, samples.size() / 1024);
+   }
+
+   // Paths under `directory`/`folder` with `extension`, relative to
+   // `directory` and with forward slashes, sorted.
+   std::vector<std::string> Sources(std::filesystem::path const& directory, char const* folder, char const* extension) {
+      std::vector<std::string> names;
+      if (!std::filesystem::is_directory(directory / folder)) return names;
+      for (auto const& file : std::filesystem::directory_iterator(directory / folder)) {
+         if (file.path().extension() == extension) names.push_back(std::string(folder) + "/" + file.path().filename().string());
+      }
+      std::sort(names.begin(), names.end());
+      return names;
+   }
+}
+
+int main(int argc, char* argv[]) {
+   if (argc > 1 && (std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0)) {
+      std::printf("usage: MinesweeperCooker [game-directory [pack-file [mip-levels]]]\n");
+      return 0;
+   }
+   std::filesystem::path directory = argc > 1 ? argv[1] : ".";
+   std::filesystem::path output = argc > 2 ? argv[2] : "assets.pack";
+   auto levels = argc > 3 ? std::uint32_t(std::max(1, std::atoi(argv[3]))) : DEFAULT_LEVELS;
+
+   try {
+      auto start = std::chrono::steady_clock::now();
+      PackWriter pack;
+      auto textures = Sources(directory, "img", ".png");
+      auto sounds = Sources(directory, "sounds", ".wav");
+      if (textures.empty() && sounds.empty()) throw std::runtime_error("No img/*.png or sounds/*.wav under " + directory.string());
+      std::printf("cooking %s\n", directory.string().c_str());
+      for (auto const& name : textures) CookTexture(pack, directory, name, levels);
+      CookSounds(pack, directory, sounds);
+
+      // written aside and moved over, so a failed cook leaves the old pack
+      auto temporary = output;
+      temporary += ".tmp";
+      {
+         std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+         pack.Write(out);
+         if (!out) throw std::runtime_error("Cannot write " + temporary.string());
+      }
+      std::filesystem::rename(temporary, output);
+      // checks the index the way the game will
+      AssetPack check(output);
+      std::printf("wrote %s: %zu entries, %zu KiB in %.1f ms\n", output.string().c_str(), check.Entries().size(), check.Size() / 1024,
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+      return 0;
+   }
+   catch (std::exception const& exc) {
+      std::fprintf(stderr, "%s\n", exc.what());
+      return 1;
+   }
+}
@@ -0,0 +1,65 @@
+#include "Allocations.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+   // Plain, so reading it from operator new never allocates.
+   thread_local std::uint64_t allocations = 0;
+}
+
+bool Allocations::Counting() {
+#ifdef MINESWEEPER_PROFILE
+   return true;
+#else
+   return false;
+#endif
+}
+
+std::uint64_t Allocations::ThisThread() {
+   return allocations;
+}
+
+#ifdef MINESWEEPER_PROFILE
+// The array and nothrow forms call these, so replacing the plain and the
+// aligned ones counts every allocation.
+void* operator new(std::size_t size) {
+   allocations++;
+   if (auto memory = std::malloc(size == 0 ? 1 : size)) return memory;
+   throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+   std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+   std::free(memory);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+   allocations++;
+   auto align = static_cast<std::size_t>(alignment);
+   // aligned_alloc wants a multiple of the alignment
+   size = (size + align - 1) / align * align;
+#ifdef _WIN32
+   auto memory = _aligned_malloc(size == 0 ? align : size, align);
+#else
+   auto memory = std::aligned_alloc(align, size == 0 ? align : size);
+#endif
+   if (memory) return memory;
+   throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+#ifdef _WIN32
+   _aligned_free(memory);
+#else
+   std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept {
+   operator delete(memory, alignment);
+}
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+//
+// Allocations.h
+// Counts the heap allocations each thread makes, to check that a frame in
+// steady state makes none.
+//
+// Global operator new is replaced to count only when MINESWEEPER_PROFILE is
+// defined, as in Debug builds; otherwise nothing is counted and
+// PROFILE_ALLOCATIONS expands to nothing.
+//
+
+#include <cstdint>
+
+#include "Profiler.h"
+
+namespace Allocations {
+   // Whether this build counts at all.
+   bool Counting();
+   // Allocations made by the calling thread since it started.
+   std::uint64_t ThisThread();
+
+   // Records the allocations the calling thread made during the scope as a
+   // profiler counter.
+   class ScopedCounter {
+   public:
+      explicit ScopedCounter(char const* name) : name_(name), start_(ThisThread()) {}
+      ~ScopedCounter() { Profile::Count(name_, std::int64_t(ThisThread() - start_)); }
+
+      ScopedCounter(ScopedCounter const&) = delete;
+      ScopedCounter& operator=(ScopedCounter const&) = delete;
+
+   private:
+      char const* name_;
+      std::uint64_t start_;
+   };
+}
+
+#ifdef MINESWEEPER_PROFILE
+#define PROFILE_ALLOCATIONS(name) ::Allocations::ScopedCounter PROFILE_JOIN(profileAllocations, __LINE__)(name)
+#else
+#define PROFILE_ALLOCATIONS(name) ((void)0)
+#endif
@@ -0,0 +1,84 @@
+#include "AssetLoader.h"
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+
+FileBytes ReadFile(std::filesystem::path const& path) {
+   std::ifstream in(path, std::ios::binary | std::ios::ate);
+   if (!in) throw std::runtime_error("Cannot open " + path.string());
+   FileBytes file;
+   file.size = std::size_t(in.tellg());
+   file.data = std::make_unique_for_overwrite<std::uint8_t[]>(file.size);
+   in.seekg(0);
+   if (!in.read(reinterpret_cast<char*>(file.data.get()), std::streamsize(file.size))) {
+      throw std::runtime_error("Cannot read " + path.string());
+   }
+   return file;
+}
+
+AssetLoader::AssetLoader(TaskPool& pool) :
+   pool_(pool),
+   start_(Clock::now()) {
+}
+
+AssetLoader::~AssetLoader() {
+   std::unique_lock lock(mutex_);
+   finished_.wait(lock, [this] { return pending_[0] == 0 && pending_[1] == 0; });
+}
+
+void AssetLoader::Load(std::string name, std::filesystem::path path, AssetPriority priority, Decode decode) {
+   {
+      std::lock_guard lock(mutex_);
+      pending_[std::size_t(priority)]++;
+   }
+   auto asked = Clock::now();
+   pool_.Submit([this, name = std::move(name), path = std::move(path), priority, decode = std::move(decode), asked] {
+      AssetTiming timing;
+      timing.name = name;
+      timing.priority = priority;
+      auto start = Clock::now();
+      timing.waited = start - asked;
+      try {
+         auto file = ReadFile(path);
+         timing.bytes = file.size;
+         auto read = Clock::now();
+         timing.read = read - start;
+         decode(std::move(file));
+         timing.decoded = Clock::now() - read;
+      }
+      catch (std::exception const& exc) {
+         timing.error = exc.what();
+      }
+      Finish(std::move(timing));
+      });
+}
+
+// Notifies under the lock: once it is let go the destructor may return.
+void AssetLoader::Finish(AssetTiming&& timing) {
+   std::lock_guard lock(mutex_);
+   timing.done = Clock::now() - start_;
+   pending_[std::size_t(timing.priority)]--;
+   timings_.push_back(std::move(timing));
+   finished_.notify_all();
+}
+
+bool AssetLoader::Ready(AssetPriority priority) const {
+   std::lock_guard lock(mutex_);
+   return pending_[std::size_t(priority)] == 0;
+}
+
+void AssetLoader::Wait(AssetPriority priority) {
+   std::unique_lock lock(mutex_);
+   finished_.wait(lock, [this, priority] { return pending_[std::size_t(priority)] == 0; });
+   auto failed = std::find_if(timings_.begin(), timings_.end(), [priority](AssetTiming const& timing) {
+      return timing.priority == priority && !timing.error.empty();
+      });
+   if (failed != timings_.end()) throw std::runtime_error("Failed to load " + failed->name + ": " + failed->error);
+}
+
+std::vector<AssetTiming> AssetLoader::Timings() const {
+   std::lock_guard lock(mutex_);
+   return timings_;
+}
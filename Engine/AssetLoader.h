@@ -0,0 +1,89 @@
+#pragma once
+//
+// AssetLoader.h
+// Reads and decodes asset files on a task pool while the main thread gets
+// the window up. Critical assets are waited for before the first frame; the
+// rest are picked up by the update once they are ready.
+//
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "TaskPool.h"
+
+enum class AssetPriority : std::uint8_t {
+   // needed for the first frame
+   Critical,
+   // may arrive after it
+   Deferred,
+};
+
+struct FileBytes {
+   std::unique_ptr<std::uint8_t[]> data;
+   std::size_t size = 0;
+};
+
+// Throws std::runtime_error if the file cannot be read.
+FileBytes ReadFile(std::filesystem::path const& path);
+
+struct AssetTiming {
+   using Duration = std::chrono::steady_clock::duration;
+
+   std::string name;
+   AssetPriority priority;
+   std::size_t bytes = 0;
+   // from the load being asked for to a thread taking it up
+   Duration waited = {};
+   Duration read = {};
+   Duration decoded = {};
+   // since the loader was made
+   Duration done = {};
+   // empty if the load succeeded
+   std::string error;
+};
+
+// Loads are taken up in the order submitted, so submit critical ones first.
+class AssetLoader {
+public:
+   using Clock = std::chrono::steady_clock;
+   // Runs on a pool thread with the whole file. Whatever it stores is safe to
+   // read on the thread that saw Ready or Wait return.
+   using Decode = std::function<void(FileBytes&& file)>;
+
+   explicit AssetLoader(TaskPool& pool);
+   // Waits for the loads still running, as they store into their callers.
+   ~AssetLoader();
+
+   AssetLoader(AssetLoader const&) = delete;
+   AssetLoader& operator=(AssetLoader const&) = delete;
+
+   void Load(std::string name, std::filesystem::path path, AssetPriority priority, Decode decode);
+
+   // Whether every load of `priority` asked for so far has finished.
+   bool Ready(AssetPriority priority) const;
+   // Blocks until they have. Throws std::runtime_error naming the first of
+   // them that failed.
+   void Wait(AssetPriority priority);
+
+   // Finished loads, in the order they finished.
+   std::vector<AssetTiming> Timings() const;
+
+private:
+   void Finish(AssetTiming&& timing);
+
+   TaskPool& pool_;
+   Clock::time_point start_;
+   mutable std::mutex mutex_;
+   std::condition_variable finished_;
+   std::array<std::size_t, 2> pending_ = {};
+   std::vector<AssetTiming> timings_;
+};
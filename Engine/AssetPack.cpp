@@ -0,0 +1,100 @@
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+   char constexpr MAGIC[4] = { 'M', 'S', 'P', 'K' };
+   // a WAVEFORMATEX, cbSize included
+   auto constexpr WAVE_FORMAT_SIZE = std::uint64_t(18);
+
+   struct Header {
+      char magic[4];
+      std::uint32_t version;
+      std::uint32_t entries;
+      std::uint32_t reserved;
+   };
+
+   std::size_t AlignUp(std::size_t at) {
+      return (at + AssetPack::ALIGNMENT - 1) / AssetPack::ALIGNMENT * AssetPack::ALIGNMENT;
+   }
+}
+
+std::string_view PackEntry::Name() const {
+   return { name, std::find(name, name + NAME_SIZE, '\0') };
+}
+
+std::size_t LevelSize(PackEntry const& entry, std::uint32_t level) {
+   auto width = std::max(entry.width >> level, 1u);
+   auto height = std::max(entry.height >> level, 1u);
+   return std::size_t(width) * height * 4;
+}
+
+AssetPack::AssetPack(std::filesystem::path const& path) :
+   file_(path) {
+   auto bytes = file_.Bytes();
+   Header header;
+   if (bytes.size() < sizeof(header)) throw std::runtime_error("Not an asset pack");
+   std::memcpy(&header, bytes.data(), sizeof(header));
+   if (!std::equal(MAGIC, MAGIC + sizeof(MAGIC), header.magic)) throw std::runtime_error("Not an asset pack");
+   if (header.version != VERSION) throw std::runtime_error("Unsupported asset pack version");
+   if (header.entries > (bytes.size() - sizeof(header)) / sizeof(PackEntry)) throw std::runtime_error("Asset pack index cut short");
+   // the mapping starts on a page, and the index right after the header
+   entries_ = { reinterpret_cast<PackEntry const*>(bytes.data() + sizeof(header)), header.entries };
+
+   for (auto const& entry : entries_) {
+      auto fits = [&bytes](std::uint64_t offset, std::uint64_t size) {
+         return offset <= bytes.size() && size <= bytes.size() - offset;
+      };
+      auto ok = fits(entry.offset, entry.size) && (entry.kind == PackKind::Sound || entry.offset % ALIGNMENT == 0);
+      if (entry.kind == PackKind::Texture) {
+         std::uint64_t size = 0;
+         for (std::uint32_t level = 0; level < entry.levels && level < 32; level++) size += LevelSize(entry, level);
+         ok = ok && entry.levels >= 1 && entry.levels <= 32 && size == entry.size &&
+            (entry.format == PackFormat::Rgba8 || entry.format == PackFormat::Rgba8Srgb);
+      }
+      if (entry.kind == PackKind::Sound) ok = ok && fits(entry.waveFormat, WAVE_FORMAT_SIZE);
+      if (!ok) throw std::runtime_error("Asset pack entry " + std::string(entry.Name()) + " is broken");
+   }
+}
+
+PackEntry const* AssetPack::Find(std::string_view name) const {
+   auto found = std::find_if(entries_.begin(), entries_.end(), [name](PackEntry const& entry) { return entry.Name() == name; });
+   return found == entries_.end() ? nullptr : &*found;
+}
+
+std::span<std::uint8_t const> AssetPack::Data(PackEntry const& entry) const {
+   return file_.Bytes().subspan(std::size_t(entry.offset), std::size_t(entry.size));
+}
+
+std::uint64_t PackWriter::Append(std::span<std::uint8_t const> data) {
+   auto at = AlignUp(data_.size());
+   data_.resize(at);
+   data_.insert(data_.end(), data.begin(), data.end());
+   return at;
+}
+
+void PackWriter::Add(PackEntry const& entry) {
+   entries_.push_back(entry);
+}
+
+void PackWriter::Write(std::ostream& out) const {
+   Header header = {};
+   std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+   header.version = AssetPack::VERSION;
+   header.entries = std::uint32_t(entries_.size());
+   auto indexEnd = sizeof(header) + entries_.size() * sizeof(PackEntry);
+   auto dataStart = AlignUp(indexEnd);
+
+   out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+   for (auto entry : entries_) {
+      entry.offset += dataStart;
+      if (entry.kind == PackKind::Sound) entry.waveFormat += std::uint32_t(dataStart);
+      out.write(reinterpret_cast<char const*>(&entry), sizeof(entry));
+   }
+   std::vector<char> padding(dataStart - indexEnd);
+   out.write(padding.data(), std::streamsize(padding.size()));
+   out.write(reinterpret_cast<char const*>(data_.data()), std::streamsize(data_.size()));
+}
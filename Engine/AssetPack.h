@@ -0,0 +1,103 @@
+#pragma once
+//
+// AssetPack.h
+// One file holding every asset ready to use: textures as raw mip levels the
+// GPU takes as they are, sounds as PCM in one blob. The game maps it and
+// points the device and the audio engine into the mapping, so starting up
+// reads and parses nothing per asset. Written by the cooker, see
+// Cooker/main.cpp.
+//
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+
+// Entries are mapped as they are stored, so packs are little endian.
+static_assert(std::endian::native == std::endian::little, "Asset packs are mapped as little endian");
+
+enum class PackKind : std::uint32_t {
+   // `levels` mip levels of `width` by `height` at the top, each halving,
+   // one after another with rows tightly packed
+   Texture = 1,
+   // a WAVEFORMATEX with cbSize 0: the format every sound is in
+   SoundFormat = 2,
+   // the samples of every sound, one after another
+   SoundData = 3,
+   // a range of the sound data; `waveFormat` is where its format is
+   Sound = 4,
+};
+
+enum class PackFormat : std::uint32_t {
+   None = 0,
+   Rgba8 = 1,
+   Rgba8Srgb = 2,
+};
+
+struct PackEntry {
+   static auto constexpr NAME_SIZE = std::size_t(40);
+
+   // the source path the asset was cooked from, zero padded
+   char name[NAME_SIZE];
+   PackKind kind;
+   PackFormat format;
+   // from the start of the file
+   std::uint64_t offset;
+   std::uint64_t size;
+   std::uint32_t width;
+   std::uint32_t height;
+   std::uint32_t levels;
+   std::uint32_t waveFormat;
+
+   std::string_view Name() const;
+};
+
+static_assert(sizeof(PackEntry) == 80, "PackEntry is stored as it is laid out");
+
+// Bytes in mip level `level` of a texture entry.
+std::size_t LevelSize(PackEntry const& entry, std::uint32_t level);
+
+class AssetPack {
+public:
+   static auto constexpr VERSION = std::uint32_t(1);
+   // every entry's data starts on this, for loads straight from the
+   // mapping, but for sounds, which follow each other in the sound data
+   static auto constexpr ALIGNMENT = std::size_t(16);
+
+   // Checks the index against the file. Throws std::runtime_error if it is
+   // not a pack of this version or an entry points outside it.
+   explicit AssetPack(std::filesystem::path const& path);
+
+   std::span<PackEntry const> Entries() const { return entries_; }
+   // Null if there is none by that name.
+   PackEntry const* Find(std::string_view name) const;
+   std::span<std::uint8_t const> Data(PackEntry const& entry) const;
+   std::uint8_t const* At(std::uint64_t offset) const { return file_.Bytes().data() + offset; }
+   std::size_t Size() const { return file_.Bytes().size(); }
+
+private:
+   MappedFile file_;
+   std::span<PackEntry const> entries_;
+};
+
+// Collects data and entries, then writes the header, the index and the data.
+class PackWriter {
+public:
+   // Appends `data` at the next aligned place and returns where it starts,
+   // counting from the start of the data.
+   std::uint64_t Append(std::span<std::uint8_t const> data);
+   // `entry.offset` and, for sounds, `entry.waveFormat` count from the
+   // start of the data, as Append returns them.
+   void Add(PackEntry const& entry);
+   void Write(std::ostream& out) const;
+
+private:
+   std::vector<PackEntry> entries_;
+   std::vector<std::uint8_t> data_;
+};
@@ -0,0 +1,61 @@
+#include "BitStore.h"
+
+#include <bit>
+
+namespace {
+   std::size_t CountBits(std::vector<std::uint64_t> const& plane) {
+      std::size_t count = 0;
+      for (auto word : plane) {
+         count += std::popcount(word);
+      }
+      return count;
+   }
+}
+
+void BitStore::Reset(std::size_t stride, std::size_t rows) {
+   stride_ = stride;
+   rows_ = rows;
+   auto words = (stride * rows + 63) / 64;
+   for (auto plane : { &mined_, &opened_, &flagged_, &questioned_ }) {
+      plane->assign(words, 0);
+   }
+}
+
+Cell BitStore::Get(std::size_t index) const {
+   auto bits = MinesNear(index) | (IsMined(index) ? Cell::MINED_BIT : 0) | (IsOpened(index) ? Cell::OPENED_BIT : 0) | (State(index) << Cell::STATE_SHIFT);
+   return Cell{ std::uint8_t(bits) };
+}
+
+RCellState BitStore::State(std::size_t index) const {
+   return Test(flagged_, index) ? RCellState::Flagged : Test(questioned_, index) ? RCellState::Questioned : RCellState::Still;
+}
+
+std::uint8_t BitStore::MinesNear(std::size_t index) const {
+   auto mines = MinesInThree(index - stride_ - 1) + MinesInThree(index - 1) + MinesInThree(index + stride_ - 1) - (IsMined(index) ? 1 : 0);
+   return std::uint8_t(mines);
+}
+
+void BitStore::SetState(std::size_t index, RCellState state) {
+   Clear(flagged_, index);
+   Clear(questioned_, index);
+   if (state == RCellState::Flagged) Set(flagged_, index);
+   if (state == RCellState::Questioned) Set(questioned_, index);
+}
+
+std::size_t BitStore::CountOpened() const {
+   auto border = 2 * stride_ + 2 * (rows_ - 2);
+   return CountBits(opened_) - border;
+}
+
+std::size_t BitStore::CountFlagged() const {
+   return CountBits(flagged_);
+}
+
+int BitStore::MinesInThree(std::size_t index) const {
+   auto word = index >> 6;
+   auto shift = index & 63;
+   auto bits = mined_[word] >> shift;
+   // the three bits straddle two words; the border keeps `word + 1` in range
+   if (shift > 61) bits |= mined_[word + 1] << (64 - shift);
+   return std::popcount(bits & 7);
+}
@@ -0,0 +1,56 @@
+#pragma once
+//
+// BitStore.h
+// Cells as separate bitplanes of 64-bit words, same indexing as CellStore.
+// Mines-around counts are not stored: they are three 3-bit popcounts of the
+// mined plane, so a cell costs half a byte and whole-board counts are
+// popcounts over words.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Cell.h"
+
+class BitStore {
+public:
+   void Reset(std::size_t stride, std::size_t rows);
+   void SetBorder(std::size_t index) { Set(opened_, index); }
+
+   Cell Get(std::size_t index) const;
+   bool IsOpened(std::size_t index) const { return Test(opened_, index); }
+   bool IsMined(std::size_t index) const { return Test(mined_, index); }
+   bool IsMarked(std::size_t index) const { return Test(flagged_, index) || Test(questioned_, index); }
+   RCellState State(std::size_t index) const;
+   std::uint8_t MinesNear(std::size_t index) const;
+
+   void Open(std::size_t index) { Set(opened_, index); }
+   void SetMined(std::size_t index) { Set(mined_, index); }
+   void SetState(std::size_t index, RCellState state);
+   void MoveMine(std::size_t from, std::size_t to) {
+      Clear(mined_, from);
+      Set(mined_, to);
+   }
+
+   void CountMines(int, int) {}
+   std::size_t CountOpened() const;
+   std::size_t CountFlagged() const;
+   std::size_t Bytes() const { return 4 * mined_.size() * sizeof(std::uint64_t); }
+
+private:
+   using Plane = std::vector<std::uint64_t>;
+
+   static bool Test(Plane const& plane, std::size_t index) { return (plane[index >> 6] >> (index & 63)) & 1; }
+   static void Set(Plane& plane, std::size_t index) { plane[index >> 6] |= std::uint64_t(1) << (index & 63); }
+   static void Clear(Plane& plane, std::size_t index) { plane[index >> 6] &= ~(std::uint64_t(1) << (index & 63)); }
+   // Mines among the three cells starting at `index`.
+   int MinesInThree(std::size_t index) const;
+
+   std::size_t stride_ = 0;
+   std::size_t rows_ = 0;
+   Plane mined_;
+   Plane opened_;
+   Plane flagged_;
+   Plane questioned_;
+};
@@ -0,0 +1,228 @@
+#include "Board.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+   // Reserved for the changed cells and the fill front. Only a flood
+   // opening more cells than this grows them, once per board.
+   auto constexpr SCRATCH_CELLS = std::size_t(1) << 16;
+}
+
+template <typename Store, typename Topology>
+BasicBoard<Store, Topology>::BasicBoard(BoardSize size, SafeZone safeZone, std::uint64_t seed) :
+   topology_(size.width, size.height),
+   mines_(size.mines),
+   safeZone_(safeZone),
+   seed_(seed),
+   rng_(seed) {
+   auto width = Width();
+   auto height = Height();
+   if (width < 1 || height < 1) throw std::invalid_argument("Board must have at least one cell");
+   auto cells = std::size_t(width) * height;
+   // the first click is always safe, so at least one cell stays free of mines
+   if (mines_ < 0 || std::size_t(mines_) >= cells) throw std::invalid_argument("Too many mines for the board");
+
+   // the centre block is the largest, so if it fits any other does
+   auto centreBlock = std::size_t(0);
+   IterateNear(width / 2, height / 2, [&centreBlock](int, int) { centreBlock++; });
+   safeBlock_ = safeZone_ == SafeZone::Block && std::size_t(mines_) <= cells - centreBlock;
+
+   needToOpen_ = cells - mines_;
+
+   auto stride = topology_.Stride();
+   auto rows = std::size_t(height) + 2;
+   store_.Reset(stride, rows);
+   for (std::size_t x = 0; x < stride; x++) {
+      store_.SetBorder(x);
+      store_.SetBorder((rows - 1) * stride + x);
+   }
+   for (auto y = 0; y < height; y++) {
+      store_.SetBorder(Index(-1, y));
+      store_.SetBorder(Index(width, y));
+   }
+   changed_.reserve(std::min(cells, SCRATCH_CELLS));
+   fill_.Reserve(std::min(cells, SCRATCH_CELLS));
+}
+
+template <typename Store, typename Topology>
+ActionResult BasicBoard<Store, Topology>::Click(int x, int y) {
+   changed_.clear();
+   if (!Contains(x, y)) return Result();
+   auto index = Index(x, y);
+   if (store_.IsOpened(index) && store_.MinesNear(index) > 0) {
+      OpenNearForced(index, { x, y });
+   }
+   else {
+      ExploreMap(index);
+   }
+   return Result();
+}
+
+template <typename Store, typename Topology>
+ActionResult BasicBoard<Store, Topology>::Flag(int x, int y) {
+   changed_.clear();
+   if (!Contains(x, y)) return Result();
+   auto index = Index(x, y);
+   if (gameState_ == GameState::Play && !store_.IsOpened(index)) {
+      auto cell = store_.Get(index);
+      cell.ToggleState();
+      store_.SetState(index, cell.State());
+      if (cell.State() == RCellState::Flagged) flagged_++;
+      if (cell.State() == RCellState::Questioned) flagged_--;
+      changed_.push_back({ x, y });
+   }
+   return Result();
+}
+
+template <typename Store, typename Topology>
+ActionResult BasicBoard<Store, Topology>::Chord(int x, int y) {
+   changed_.clear();
+   if (!Contains(x, y)) return Result();
+   OpenNearForced(Index(x, y), { x, y });
+   return Result();
+}
+
+template <typename Store, typename Topology>
+void BasicBoard<Store, Topology>::Prepare() {
+   Prepare(rng_);
+}
+
+template <typename Store, typename Topology>
+void BasicBoard<Store, Topology>::Start(int x, int y) {
+   Start(x, y, rng_);
+}
+
+template <typename Store, typename Topology>
+Pos BasicBoard<Store, Topology>::PosOf(std::size_t index) const {
+   auto stride = topology_.Stride();
+   return { int(index % stride) - 1, int(index / stride) - 1 };
+}
+
+template <typename Store, typename Topology>
+int BasicBoard<Store, Topology>::SafeCells(int x, int y, std::array<Pos, 9>& cells) const {
+   if (!safeBlock_) {
+      cells[0] = { x, y };
+      return 1;
+   }
+   auto count = 0;
+   IterateNear(x, y, [&cells, &count](int safeX, int safeY) { cells[count++] = { safeX, safeY }; });
+   std::sort(cells.begin(), cells.begin() + count, [](Pos a, Pos b) { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+   return count;
+}
+
+template <typename Store, typename Topology>
+void BasicBoard<Store, Topology>::CountMines() {
+   if constexpr (Topology::BOX) {
+      store_.CountMines(Width(), Height());
+   }
+   else {
+      for (auto y = 0; y < Height(); y++) {
+         for (auto x = 0; x < Width(); x++) {
+            auto index = Index(x, y);
+            auto mines = 0;
+            topology_.ForEachNear(index, x, y, [this, &mines](std::size_t near, int, int) { mines += store_.IsMined(near) ? 1 : 0; });
+            store_.SetMinesNear(index, mines);
+         }
+      }
+   }
+}
+
+template <typename Store, typename Topology>
+void BasicBoard<Store, Topology>::MoveMine(std::size_t from, std::size_t to) {
+   if constexpr (Topology::BOX) {
+      store_.MoveMine(from, to);
+   }
+   else {
+      store_.ClearMined(from);
+      store_.SetMined(to);
+      // border cells keep a count of zero
+      auto adjust = [this](std::size_t centre, int delta) {
+         auto pos = PosOf(centre);
+         topology_.ForEachNear(centre, pos.x, pos.y, [this, delta](std::size_t near, int x, int y) {
+            if (Contains(x, y)) store_.SetMinesNear(near, store_.MinesNear(near) + delta);
+            });
+      };
+      adjust(from, -1);
+      adjust(to, 1);
+   }
+}
+
+template <typename Store, typename Topology>
+void BasicBoard<Store, Topology>::OpenAt(std::size_t index, Pos pos) {
+   if (store_.IsMarked(index) || store_.IsOpened(index)) return;
+
+   store_.Open(index);
+   changed_.push_back(pos);
+
+   if (!started_) {
+      Start(pos.x, pos.y);
+   }
+
+   if (store_.IsMined(index)) {
+      gameState_ = GameState::Defeat;
+      return;
+   }
+
+   opened_++;
+   if (opened_ == needToOpen_) gameState_ = GameState::Win;
+}
+
+// Breadth-first over the empty cells. Only cells with no mines around are
+// queued, so the queue holds the current fill front rather than the whole area,
+// and it keeps its memory for the next click.
+template <typename Store, typename Topology>
+void BasicBoard<Store, Topology>::ExploreMap(std::size_t origin) {
+   if (gameState_ != GameState::Play || store_.IsOpened(origin) || store_.IsMarked(origin)) return;
+   PROFILE_SCOPE("Board::ExploreMap");
+   auto pos = PosOf(origin);
+   OpenAt(origin, pos);
+   if (store_.IsMined(origin) || store_.MinesNear(origin) != 0) return;
+
+   fill_.Clear();
+   fill_.Push(pos);
+   while (!fill_.Empty()) {
+      auto from = fill_.Pop();
+      topology_.ForEachNear(Index(from.x, from.y), from.x, from.y, [this](std::size_t next, int x, int y) {
+         if (store_.IsOpened(next) || store_.IsMarked(next)) return;
+         OpenAt(next, { x, y });
+         if (store_.MinesNear(next) == 0) fill_.Push({ x, y });
+         });
+   }
+}
+
+template <typename Store, typename Topology>
+void BasicBoard<Store, Topology>::OpenNearForced(std::size_t origin, Pos pos) {
+   if (!(store_.IsOpened(origin) && store_.MinesNear(origin) > 0)) return;
+   auto flagged = 0;
+   topology_.ForEachNear(origin, pos.x, pos.y, [this, &flagged](std::size_t near, int, int) {
+      flagged += store_.State(near) == RCellState::Flagged ? 1 : 0;
+      });
+   if (store_.MinesNear(origin) == flagged) {
+      topology_.ForEachNear(origin, pos.x, pos.y, [this](std::size_t near, int, int) { ExploreMap(near); });
+   }
+}
+
+template <typename Store, typename Topology>
+ActionResult BasicBoard<Store, Topology>::Result() {
+   return { changed_, gameState_ };
+}
+
+template class BasicBoard<CellStore>;
+template class BasicBoard<BitStore>;
+template class BasicBoard<CellStore, Torus<>>;
+template class BasicBoard<CellStore, VonNeumann<>>;
+template class BasicBoard<CellStore, Hex<>>;
+// the presets, see PresetBoard
+template class BasicBoard<CellStore, Moore<9, 9>>;
+template class BasicBoard<CellStore, Moore<16, 16>>;
+template class BasicBoard<CellStore, Moore<30, 16>>;
+template class BasicBoard<CellStore, Torus<9, 9>>;
+template class BasicBoard<CellStore, Torus<16, 16>>;
+template class BasicBoard<CellStore, Torus<30, 16>>;
+template class BasicBoard<CellStore, VonNeumann<9, 9>>;
+template class BasicBoard<CellStore, VonNeumann<16, 16>>;
+template class BasicBoard<CellStore, VonNeumann<30, 16>>;
+template class BasicBoard<CellStore, Hex<9, 9>>;
+template class BasicBoard<CellStore, Hex<16, 16>>;
+template class BasicBoard<CellStore, Hex<30, 16>>;
@@ -0,0 +1,262 @@
+#pragma once
+//
+// Board.h
+// Minesweeper rules without any window, device or sound dependencies.
+//
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "BitStore.h"
+#include "Cell.h"
+#include "CellStore.h"
+#include "MinePlacer.h"
+#include "Profiler.h"
+#include "RingQueue.h"
+#include "Topology.h"
+
+// percentage of mines
+enum Difficulty {
+   Easy = 10,
+   Medium = 15,
+   Hard = 20,
+   Impossible = 25
+};
+
+enum GameState {
+   Play, Win, Defeat
+};
+
+struct Pos {
+   int x;
+   int y;
+};
+
+struct BoardSize {
+   int width;
+   int height;
+   int mines;
+};
+
+constexpr int MinesFor(int width, int height, Difficulty difficulty) {
+   return static_cast<int>(std::int64_t(width) * height * difficulty / 100);
+}
+
+auto constexpr DEFAULT_SIZE = BoardSize{ 40, 20, MinesFor(40, 20, Difficulty::Hard) };
+
+// The classic sizes, which boards can be compiled for, see PresetBoard.
+auto constexpr BEGINNER = BoardSize{ 9, 9, 10 };
+auto constexpr INTERMEDIATE = BoardSize{ 16, 16, 40 };
+auto constexpr EXPERT = BoardSize{ 30, 16, 99 };
+
+// What an action did to the board. `changed` lists every cell whose visible
+// state changed and stays valid until the next action on the same board.
+struct ActionResult {
+   std::span<Pos const> changed;
+   GameState state;
+};
+
+// Cells are stored row-major with a one cell border around the board. Border
+// cells are opened and never mined, so the neighbours of any board cell are
+// plain offsets from its index and need no bounds checks, unless the
+// topology wraps. `Store` holds the cells: CellStore packs each into a byte,
+// BitStore keeps one bitplane per flag. `Topology` says which cells
+// neighbour which, see Topology.h.
+template <typename Store, typename Topology = Moore<>>
+class BasicBoard {
+public:
+   static_assert(Topology::BOX || requires(Store& store) { store.SetMinesNear(std::size_t(0), 0); },
+      "Only stores that keep the counts can count over other neighbours than the 3x3 block");
+
+   // The same size, safe zone, seed and first click always give the same mines.
+   explicit BasicBoard(BoardSize size = DEFAULT_SIZE, SafeZone safeZone = SafeZone::Cell, std::uint64_t seed = RandomSeed());
+
+   // The actions take any (x, y), and change nothing outside the board, so
+   // bots and fuzzers can drive them directly.
+
+   // Opens a covered cell (flooding through empty ones) or chords an opened number.
+   ActionResult Click(int x, int y);
+   // Cycles the mark of a covered cell: still -> flagged -> questioned -> still.
+   ActionResult Flag(int x, int y);
+   // Opens the neighbours of an opened number once enough of them are flagged.
+   ActionResult Chord(int x, int y);
+   // Places the mines ahead of the first click, keeping the safe zone around
+   // the centre free. Start then moves the zone to the click by swapping a few
+   // cells, so boards can be prepared on another thread; see BoardPool.h.
+   void Prepare();
+   template <typename Rng>
+   void Prepare(Rng& rng);
+   // Places the mines, if not prepared yet, and makes the safe zone around
+   // (x, y) free, unless (x, y) is outside the board. The first Click does
+   // this on its own with a generator seeded from the board seed, so the
+   // same seed gives the same board either way.
+   void Start(int x, int y);
+   template <typename Rng>
+   void Start(int x, int y, Rng& rng);
+
+   Cell At(int x, int y) const { return store_.Get(Index(x, y)); }
+   bool Contains(int x, int y) const { return x >= 0 && x < Width() && y >= 0 && y < Height(); }
+   // Calls `visit(x, y)` for (originX, originY), then for its neighbours on the board.
+   template <typename Visit>
+   void IterateNear(int originX, int originY, Visit&& visit) const;
+   Store const& Cells() const { return store_; }
+
+   int Width() const { return topology_.Width(); }
+   int Height() const { return topology_.Height(); }
+   int Mines() const { return mines_; }
+   BoardSize Size() const { return { Width(), Height(), mines_ }; }
+   SafeZone Zone() const { return safeZone_; }
+   std::uint64_t Seed() const { return seed_; }
+   Pos FirstClick() const { return firstClick_; }
+   GameState State() const { return gameState_; }
+   std::size_t Opened() const { return opened_; }
+   std::size_t Flagged() const { return flagged_; }
+   bool Prepared() const { return prepared_; }
+   bool Started() const { return started_; }
+
+private:
+   std::size_t Index(int x, int y) const { return (std::size_t(y) + 1) * topology_.Stride() + x + 1; }
+   Pos PosOf(std::size_t index) const;
+   // Fills `cells` with the safe zone around (x, y), row-major, and returns its size.
+   int SafeCells(int x, int y, std::array<Pos, 9>& cells) const;
+   template <typename Rng>
+   void MoveSafeZone(int x, int y, Rng& rng);
+   // The stores count over the 3x3 block themselves; other topologies are
+   // counted here.
+   void CountMines();
+   void MoveMine(std::size_t from, std::size_t to);
+
+   void OpenAt(std::size_t index, Pos pos);
+   void ExploreMap(std::size_t origin);
+   void OpenNearForced(std::size_t origin, Pos pos);
+   ActionResult Result();
+
+   Topology topology_;
+   int mines_;
+   SafeZone safeZone_;
+   // false when the mines leave no room for a safe block
+   bool safeBlock_;
+   std::uint64_t seed_;
+   Xoshiro256 rng_;
+   std::size_t needToOpen_;
+   Store store_;
+
+   GameState gameState_ = GameState::Play;
+   std::size_t opened_ = 0;
+   std::size_t flagged_ = 0;
+   bool prepared_ = false;
+   bool started_ = false;
+   Pos firstClick_ = { -1, -1 };
+
+   // scratch for the actions, sized by the constructor so that playing
+   // does not allocate
+   std::vector<Pos> changed_;
+   RingQueue<Pos> fill_;
+};
+
+using Board = BasicBoard<CellStore>;
+using BitBoard = BasicBoard<BitStore>;
+// A board of a classic size, say PresetBoard<Torus, EXPERT>, with every
+// stride and offset a constant. It is played with the size it was made for.
+template <template <int, int> class Topology, BoardSize Size>
+using PresetBoard = BasicBoard<CellStore, Topology<Size.width, Size.height>>;
+
+template <typename Store, typename Topology>
+template <typename Rng>
+void BasicBoard<Store, Topology>::Prepare(Rng& rng) {
+   if (prepared_) return;
+   PROFILE_SCOPE("Board::Prepare");
+   prepared_ = true;
+
+   // row-major indices of the safe cells, ascending
+   std::array<Pos, 9> zone;
+   auto width = Width();
+   auto safeCount = SafeCells(width / 2, Height() / 2, zone);
+   std::array<std::uint64_t, 9> safe;
+   for (auto i = 0; i < safeCount; i++) {
+      safe[i] = std::uint64_t(zone[i].y) * width + zone[i].x;
+   }
+
+   // values skip the safe cells, so every value in [0, cells - safeCount) is a minable cell
+   auto cells = std::uint64_t(width) * Height();
+   SampleDistinct(cells - safeCount, mines_, rng, [this, &safe, safeCount, width](std::uint64_t value) {
+      for (auto i = 0; i < safeCount; i++) {
+         if (value >= safe[i]) value++;
+      }
+      auto index = value <= 0xFFFFFFFFull ?
+         Index(int(std::uint32_t(value) % std::uint32_t(width)), int(std::uint32_t(value) / std::uint32_t(width))) :
+         Index(int(value % width), int(value / width));
+      if (store_.IsMined(index)) return false;
+      store_.SetMined(index);
+      return true;
+      });
+
+   CountMines();
+}
+
+template <typename Store, typename Topology>
+template <typename Visit>
+void BasicBoard<Store, Topology>::IterateNear(int originX, int originY, Visit&& visit) const {
+   visit(originX, originY);
+   topology_.ForEachNear(Index(originX, originY), originX, originY, [this, &visit](std::size_t, int x, int y) {
+      if (Contains(x, y)) visit(x, y);
+      });
+}
+
+template <typename Store, typename Topology>
+template <typename Rng>
+void BasicBoard<Store, Topology>::Start(int x, int y, Rng& rng) {
+   if (started_ || !Contains(x, y)) return;
+   Prepare(rng);
+   MoveSafeZone(x, y, rng);
+   started_ = true;
+   firstClick_ = { x, y };
+}
+
+// The mines are uniform over the cells outside the centre zone R. Swapping the
+// cells of the click zone S outside R with as many cells of R outside S maps
+// them to uniform mines outside S and the leftover cells of R. Each leftover
+// cell then swaps with a uniform cell outside S and the leftovers still to
+// come (itself included), after which the mines are uniform outside S alone.
+template <typename Store, typename Topology>
+template <typename Rng>
+void BasicBoard<Store, Topology>::MoveSafeZone(int x, int y, Rng& rng) {
+   auto width = Width();
+   std::array<Pos, 9> reserved;
+   std::array<Pos, 9> safe;
+   auto reservedCount = SafeCells(width / 2, Height() / 2, reserved);
+   auto safeCount = SafeCells(x, y, safe);
+   auto in = [](Pos const* zone, int count, Pos pos) {
+      return std::any_of(zone, zone + count, [pos](Pos cell) { return cell.x == pos.x && cell.y == pos.y; });
+   };
+   auto swap = [this](Pos a, Pos b) {
+      auto from = Index(a.x, a.y);
+      auto to = Index(b.x, b.y);
+      if (store_.IsMined(from) && !store_.IsMined(to)) MoveMine(from, to);
+      else if (store_.IsMined(to) && !store_.IsMined(from)) MoveMine(to, from);
+   };
+
+   std::array<Pos, 9> leftover;
+   auto leftoverCount = 0;
+   for (auto i = 0; i < reservedCount; i++) {
+      if (!in(safe.data(), safeCount, reserved[i])) leftover[leftoverCount++] = reserved[i];
+   }
+   auto paired = 0;
+   for (auto i = 0; i < safeCount; i++) {
+      if (!in(reserved.data(), reservedCount, safe[i])) swap(safe[i], leftover[paired++]);
+   }
+
+   auto cells = std::uint64_t(width) * Height();
+   for (auto i = paired; i < leftoverCount; i++) {
+      Pos other;
+      do {
+         auto value = Bounded(rng, cells);
+         other = { int(value % width), int(value / width) };
+      } while (in(safe.data(), safeCount, other) || in(leftover.data() + i + 1, leftoverCount - i - 1, other));
+      swap(leftover[i], other);
+   }
+}
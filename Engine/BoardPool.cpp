@@ -0,0 +1,135 @@
+#include "BoardPool.h"
+
+#include <algorithm>
+
+namespace {
+   auto constexpr RECYCLE_CAPACITY = std::size_t(16);
+   // only the latest request counts, so a few in flight are plenty
+   auto constexpr NO_GUESS_QUEUE = std::size_t(4);
+   // boards tried between looks at the other lanes and new requests
+   auto constexpr NO_GUESS_BATCH = std::size_t(16);
+}
+
+BoardPool::BoardPool(std::vector<PoolKey> const& keys, std::size_t depth, std::uint64_t seed) :
+   depth_(depth),
+   recycled_(RECYCLE_CAPACITY),
+   requests_(NO_GUESS_QUEUE),
+   found_(NO_GUESS_QUEUE),
+   seeds_(seed) {
+   for (auto& key : keys) {
+      lanes_.push_back(std::make_unique<Lane>(key, depth));
+   }
+   worker_ = std::thread([this] { Run(); });
+}
+
+BoardPool::~BoardPool() {
+   stop_ = true;
+   Wake();
+   worker_.join();
+}
+
+std::unique_ptr<Board> BoardPool::Take(PoolKey const& key) {
+   std::unique_ptr<Board> board;
+   auto lane = Find(key);
+   if (lane && lane->boards.TryPop(board)) Wake();
+   return board;
+}
+
+void BoardPool::Recycle(std::unique_ptr<Board> board) {
+   // with the queue full the board is simply freed here
+   if (recycled_.TryPush(board)) Wake();
+}
+
+std::size_t BoardPool::Ready(PoolKey const& key) const {
+   auto lane = Find(key);
+   return lane ? lane->boards.Size() : 0;
+}
+
+bool BoardPool::RequestNoGuess(BoardSize size, Pos first, std::size_t maxAttempts) {
+   if (requested_ && requested_->size.width == size.width && requested_->size.height == size.height &&
+      requested_->size.mines == size.mines && requested_->first.x == first.x && requested_->first.y == first.y) {
+      return true;
+   }
+   // whatever was found for earlier requests is of no use now
+   NoGuessFound stale;
+   while (found_.TryPop(stale)) {
+      if (stale.board) Recycle(std::move(stale.board));
+   }
+
+   NoGuessRequest request = { ++requestIds_, size, first, std::min(maxAttempts, MAX_NO_GUESS_ATTEMPTS) };
+   if (!requests_.TryPush(request)) {
+      requested_.reset();
+      return false;
+   }
+   requested_ = request;
+   Wake();
+   return true;
+}
+
+std::optional<std::unique_ptr<Board>> BoardPool::TakeNoGuess() {
+   NoGuessFound found;
+   while (requested_ && found_.TryPop(found)) {
+      if (found.id == requested_->id) {
+         requested_.reset();
+         return std::move(found.board);
+      }
+      if (found.board) Recycle(std::move(found.board));
+   }
+   return std::nullopt;
+}
+
+BoardPool::Lane* BoardPool::Find(PoolKey const& key) const {
+   for (auto& lane : lanes_) {
+      if (lane->key == key) return lane.get();
+   }
+   return nullptr;
+}
+
+void BoardPool::Wake() {
+   wake_.fetch_add(1, std::memory_order_release);
+   wake_.notify_one();
+}
+
+// Fills the lanes one board at a time in turn, so a large key does not starve
+// a small one, with a batch of the no-guess search before each turn, and
+// sleeps until woken once every lane is full and no search is left.
+void BoardPool::Run() {
+   while (!stop_) {
+      auto observed = wake_.load(std::memory_order_acquire);
+
+      std::unique_ptr<Board> finished;
+      while (recycled_.TryPop(finished)) finished.reset();
+
+      auto filled = SearchNoGuess();
+      for (auto& lane : lanes_) {
+         if (stop_) return;
+         if (lane->boards.Size() >= depth_) continue;
+         auto board = std::make_unique<Board>(lane->key.size, lane->key.safeZone, seeds_());
+         board->Prepare();
+         lane->boards.TryPush(board);
+         filled = true;
+      }
+      if (!filled) wake_.wait(observed, std::memory_order_acquire);
+   }
+}
+
+bool BoardPool::SearchNoGuess() {
+   // a newer request replaces the search under way
+   NoGuessRequest request;
+   while (requests_.TryPop(request)) {
+      search_.emplace(request.size, request.first, seeds_(), request.maxAttempts);
+      searchId_ = request.id;
+   }
+   if (!search_) return false;
+   if (!search_->Step(NO_GUESS_BATCH)) return true;
+
+   NoGuessFound found = { searchId_, nullptr };
+   if (auto seed = search_->Result().seed) {
+      found.board = std::make_unique<Board>(search_->Size(), NO_GUESS_ZONE, *seed);
+      found.board->Prepare();
+   }
+   search_.reset();
+   // the owner drains the results before each request, so there is room
+   found_.TryPush(found);
+   return true;
+}
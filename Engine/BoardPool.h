@@ -0,0 +1,111 @@
+#pragma once
+//
+// BoardPool.h
+// Boards prepared ahead of time on a worker thread. A prepared board only has
+// to move its safe zone to the first click, which costs the same at any size,
+// so taking a board for a restart and the first click are both constant time.
+//
+// No-guess boards depend on the first click itself, so they cannot be made
+// ahead of it; the worker searches for them on request instead, between the
+// other boards, and the caller's thread never runs the search.
+//
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "Board.h"
+#include "NoGuess.h"
+#include "SpscQueue.h"
+
+struct PoolKey {
+   BoardSize size;
+   SafeZone safeZone;
+
+   bool operator==(PoolKey const& other) const {
+      return size.width == other.size.width && size.height == other.size.height &&
+         size.mines == other.size.mines && safeZone == other.safeZone;
+   }
+};
+
+// The worker is the only producer of every key's queue and of the no-guess
+// results, and the only consumer of the recycle and request queues; the
+// owner's thread is the other side of all of them, so every public call but
+// Ready must come from one thread.
+class BoardPool {
+public:
+   // Most boards one no-guess request tries. The worker is shared with the
+   // lanes and every later request, so one search must not hold it for long.
+   static auto constexpr MAX_NO_GUESS_ATTEMPTS = std::size_t(2000);
+
+   // Keeps `depth` prepared boards of each key. Keys must be valid board sizes.
+   BoardPool(std::vector<PoolKey> const& keys, std::size_t depth, std::uint64_t seed = RandomSeed());
+   ~BoardPool();
+
+   BoardPool(BoardPool const&) = delete;
+   BoardPool& operator=(BoardPool const&) = delete;
+
+   // A prepared board, or null if none is ready or the key is not pooled.
+   std::unique_ptr<Board> Take(PoolKey const& key);
+   // Hands a finished board to the worker to free, keeping large frees off
+   // the caller's thread.
+   void Recycle(std::unique_ptr<Board> board);
+   // Boards ready for a key.
+   std::size_t Ready(PoolKey const& key) const;
+
+   // Starts searching for a board of `size` that needs no guess from `first`,
+   // dropping any other search; asking again for the same click keeps the
+   // search going. Searches as FindNoGuessSeed would, from a seed of the
+   // pool's, trying at most MAX_NO_GUESS_ATTEMPTS boards. False when the
+   // request could not be queued.
+   bool RequestNoGuess(BoardSize size, Pos first, std::size_t maxAttempts = MAX_NO_GUESS_ATTEMPTS);
+   // The board for the latest request, prepared: nothing while it is still
+   // searched for, then the board, or null if the attempts ran out.
+   std::optional<std::unique_ptr<Board>> TakeNoGuess();
+
+private:
+   struct Lane {
+      Lane(PoolKey key, std::size_t depth) : key(key), boards(depth) {}
+
+      PoolKey key;
+      SpscQueue<std::unique_ptr<Board>> boards;
+   };
+
+   struct NoGuessRequest {
+      std::uint64_t id;
+      BoardSize size;
+      Pos first;
+      std::size_t maxAttempts;
+   };
+
+   struct NoGuessFound {
+      std::uint64_t id;
+      std::unique_ptr<Board> board;
+   };
+
+   Lane* Find(PoolKey const& key) const;
+   void Wake();
+   void Run();
+   // A batch of the current search; true if there was one.
+   bool SearchNoGuess();
+
+   std::size_t depth_;
+   std::vector<std::unique_ptr<Lane>> lanes_;
+   SpscQueue<std::unique_ptr<Board>> recycled_;
+   SpscQueue<NoGuessRequest> requests_;
+   SpscQueue<NoGuessFound> found_;
+   // the owner's side: the latest request, while its board is not taken
+   std::optional<NoGuessRequest> requested_;
+   std::uint64_t requestIds_ = 0;
+   // the worker's side
+   std::optional<NoGuessSearch> search_;
+   std::uint64_t searchId_ = 0;
+   SplitMix64 seeds_;
+   std::atomic<std::uint32_t> wake_ = 0;
+   std::atomic<bool> stop_ = false;
+   std::thread worker_;
+};
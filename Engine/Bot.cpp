@@ -0,0 +1,99 @@
+#include "Bot.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+   template <typename Store>
+   Pos SafestGuess(BasicBoard<Store> const& board, BasicSolver<Store> const& solver, ProbabilityOptions const& options) {
+      auto grid = MineProbabilities(board, solver, options);
+      Pos best = { -1, -1 };
+      auto bestMine = 2.0f;
+      for (auto y = 0; y < board.Height(); y++) {
+         for (auto x = 0; x < board.Width(); x++) {
+            if (board.At(x, y).IsOpened() || solver.At(x, y) != Knowledge::Unknown) continue;
+            auto mine = grid.At(x, y);
+            if (mine < bestMine) {
+               best = { x, y };
+               bestMine = mine;
+            }
+         }
+      }
+      return best;
+   }
+}
+
+template <typename Store>
+BotResult PlayBot(BasicBoard<Store>& board, Pos first, BotOptions const& options) {
+   BotResult result;
+   board.Click(first.x, first.y);
+   result.clicks++;
+   result.guesses++;
+
+   auto probability = options.probability;
+   BasicSolver<Store> solver(board);
+   while (board.State() == GameState::Play) {
+      auto proven = solver.Solve();
+      for (auto pos : proven.safe) {
+         if (board.State() != GameState::Play) break;
+         if (board.At(pos.x, pos.y).IsOpened()) continue;
+         solver.Update(board.Click(pos.x, pos.y).changed);
+         result.clicks++;
+      }
+      // a safe cell opened by another one's flood may leave the solver more to do
+      if (!proven.safe.empty()) continue;
+
+      probability.seed = board.Seed() + result.guesses;
+      auto guess = SafestGuess(board, solver, probability);
+      if (guess.x < 0) break;
+      solver.Update(board.Click(guess.x, guess.y).changed);
+      result.clicks++;
+      result.guesses++;
+   }
+   result.state = board.State();
+   return result;
+}
+
+template <typename Store>
+std::size_t ThreeBV(BasicBoard<Store> const& board) {
+   auto width = board.Width();
+   auto height = board.Height();
+   std::vector<std::uint8_t> revealed(std::size_t(width) * height);
+   auto isEmpty = [&board](int x, int y) {
+      auto cell = board.At(x, y);
+      return !cell.IsMined() && cell.MinesNear() == 0;
+   };
+
+   auto clicks = std::size_t(0);
+   std::vector<Pos> stack;
+   for (auto y = 0; y < height; y++) {
+      for (auto x = 0; x < width; x++) {
+         if (revealed[std::size_t(y) * width + x] || !isEmpty(x, y)) continue;
+         // one click opens the whole opening and the numbers around it
+         clicks++;
+         revealed[std::size_t(y) * width + x] = 1;
+         stack.push_back({ x, y });
+         while (!stack.empty()) {
+            auto pos = stack.back();
+            stack.pop_back();
+            board.IterateNear(pos.x, pos.y, [&](int nx, int ny) {
+               auto& seen = revealed[std::size_t(ny) * width + nx];
+               if (seen) return;
+               seen = 1;
+               if (isEmpty(nx, ny)) stack.push_back({ nx, ny });
+               });
+         }
+      }
+   }
+   for (auto y = 0; y < height; y++) {
+      for (auto x = 0; x < width; x++) {
+         if (!revealed[std::size_t(y) * width + x] && !board.At(x, y).IsMined()) clicks++;
+      }
+   }
+   return clicks;
+}
+
+template BotResult PlayBot(BasicBoard<CellStore>&, Pos, BotOptions const&);
+template BotResult PlayBot(BasicBoard<BitStore>&, Pos, BotOptions const&);
+template std::size_t ThreeBV(BasicBoard<CellStore> const&);
+template std::size_t ThreeBV(BasicBoard<BitStore> const&);
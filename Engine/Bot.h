@@ -0,0 +1,35 @@
+#pragma once
+//
+// Bot.h
+// A player that opens what the solver proves safe and otherwise guesses the
+// cell least likely to hide a mine, and the 3BV measure of a board.
+//
+
+#include <cstddef>
+
+#include "Board.h"
+#include "Probability.h"
+#include "Solver.h"
+
+struct BotOptions {
+   // The bot runs inside batch workers, so it samples on the calling thread.
+   // The sampler is seeded from the board seed, keeping games reproducible.
+   ProbabilityOptions probability = { .threads = 1 };
+};
+
+struct BotResult {
+   GameState state = GameState::Play;
+   std::size_t clicks = 0;
+   std::size_t guesses = 0; // clicks on cells that were not proven safe, the first one included
+};
+
+// Plays `board` to the end from `first`. Ties between equally safe guesses go
+// to the first cell in row-major order.
+template <typename Store>
+BotResult PlayBot(BasicBoard<Store>& board, Pos first, BotOptions const& options = {});
+
+// Bechtel's Board Benchmark Value: the fewest clicks that clear the board
+// without chording, i.e. one per opening plus one per safe cell that no
+// opening reveals. The board must have its mines, so it has to be started.
+template <typename Store>
+std::size_t ThreeBV(BasicBoard<Store> const& board);
@@ -0,0 +1,78 @@
+#include "Camera.h"
+
+#include <algorithm>
+#include <cmath>
+
+Camera::Camera(int columns, int rows, float cellSize, float viewWidth, float viewHeight) :
+   columns_(columns),
+   rows_(rows),
+   cellSize_(cellSize),
+   viewWidth_(viewWidth),
+   viewHeight_(viewHeight) {
+   Clamp();
+}
+
+void Camera::Resize(float viewWidth, float viewHeight) {
+   viewWidth_ = viewWidth;
+   viewHeight_ = viewHeight;
+   zoom_ = std::clamp(zoom_, MinZoom(), MAX_ZOOM);
+   Clamp();
+}
+
+void Camera::Pan(float dx, float dy) {
+   scrollX_ -= dx / zoom_;
+   scrollY_ -= dy / zoom_;
+   Clamp();
+}
+
+void Camera::ZoomAt(float factor, float x, float y) {
+   auto boardX = scrollX_ + x / zoom_;
+   auto boardY = scrollY_ + y / zoom_;
+   zoom_ = std::clamp(zoom_ * factor, MinZoom(), MAX_ZOOM);
+   scrollX_ = boardX - x / zoom_;
+   scrollY_ = boardY - y / zoom_;
+   Clamp();
+}
+
+Pos Camera::CellAt(float x, float y) const {
+   return { int(std::floor((scrollX_ + x / zoom_) / cellSize_)), int(std::floor((scrollY_ + y / zoom_) / cellSize_)) };
+}
+
+CellRange Camera::Visible(int block) const {
+   auto size = cellSize_ * block;
+   auto blocksX = (columns_ + block - 1) / block;
+   auto blocksY = (rows_ + block - 1) / block;
+   CellRange range = {
+      int(std::floor(scrollX_ / size)),
+      int(std::floor(scrollY_ / size)),
+      int(std::ceil((scrollX_ + viewWidth_ / zoom_) / size)),
+      int(std::ceil((scrollY_ + viewHeight_ / zoom_) / size)),
+   };
+   range.x0 = std::clamp(range.x0, 0, blocksX);
+   range.y0 = std::clamp(range.y0, 0, blocksY);
+   range.x1 = std::clamp(range.x1, range.x0, blocksX);
+   range.y1 = std::clamp(range.y1, range.y0, blocksY);
+   return range;
+}
+
+int Camera::LodLevel(int maxLevel) const {
+   auto level = 0;
+   for (auto pixels = CellPixels(); pixels < LOD_PIXELS && level < maxLevel; pixels *= 2) level++;
+   return level;
+}
+
+// Zoomed out no further than the whole board fitting the view, and never
+// below one pixel per cell.
+float Camera::MinZoom() const {
+   auto fit = std::min(viewWidth_ / (columns_ * cellSize_), viewHeight_ / (rows_ * cellSize_));
+   return std::min(1.0f, std::max(fit, 1.0f / cellSize_));
+}
+
+void Camera::Clamp() {
+   auto clampAxis = [](float scroll, float boardPixels, float viewPixels) {
+      if (boardPixels <= viewPixels) return (boardPixels - viewPixels) / 2;
+      return std::clamp(scroll, 0.0f, boardPixels - viewPixels);
+   };
+   scrollX_ = clampAxis(scrollX_, columns_ * cellSize_, viewWidth_ / zoom_);
+   scrollY_ = clampAxis(scrollY_, rows_ * cellSize_, viewHeight_ / zoom_);
+}
@@ -0,0 +1,66 @@
+#pragma once
+//
+// Camera.h
+// Pan and zoom over a board larger than the window: which cells are in view,
+// which cell is under the mouse, and how coarse to draw when zoomed out.
+//
+
+#include "Board.h"
+
+// Cells [x0, x1) x [y0, y1), or blocks of cells at a level of detail.
+struct CellRange {
+   int x0;
+   int y0;
+   int x1;
+   int y1;
+
+   int Width() const { return x1 - x0; }
+   int Height() const { return y1 - y0; }
+   bool Empty() const { return x1 <= x0 || y1 <= y0; }
+};
+
+// Positions are in view pixels, from the top left of the area the board is
+// drawn in. The camera keeps the board on screen: a board smaller than the
+// view is centred, a larger one cannot scroll past its edges.
+class Camera {
+public:
+   static auto constexpr MAX_ZOOM = 4.0f;
+   // Below this many pixels a cell is too small to read, and the board is
+   // drawn in blocks of cells instead, see TileLod.h.
+   static auto constexpr LOD_PIXELS = 4.0f;
+
+   Camera(int columns, int rows, float cellSize, float viewWidth, float viewHeight);
+
+   void Resize(float viewWidth, float viewHeight);
+   void Pan(float dx, float dy);
+   // Scales by `factor`, keeping the board point under (x, y) in place.
+   void ZoomAt(float factor, float x, float y);
+
+   float Zoom() const { return zoom_; }
+   float CellPixels() const { return cellSize_ * zoom_; }
+   // Where the board's top left corner is in the view.
+   float OriginX() const { return -scrollX_ * zoom_; }
+   float OriginY() const { return -scrollY_ * zoom_; }
+
+   // The cell under a view position; may be off the board.
+   Pos CellAt(float x, float y) const;
+   // Blocks of `block` x `block` cells at least partly in view, clipped to the board.
+   CellRange Visible(int block = 1) const;
+   // 0 while cells are readable, else the level whose blocks of 2^level
+   // cells span at least LOD_PIXELS, but no more than `maxLevel`.
+   int LodLevel(int maxLevel) const;
+
+private:
+   float MinZoom() const;
+   void Clamp();
+
+   int columns_;
+   int rows_;
+   float cellSize_;
+   float viewWidth_;
+   float viewHeight_;
+   float zoom_ = 1;
+   // the board point, in unscaled pixels, at the top left of the view
+   float scrollX_ = 0;
+   float scrollY_ = 0;
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+
+enum RCellState : std::uint8_t {
+   Still,
+   Flagged,
+   Questioned,
+};
+
+// One byte per cell with a fixed layout, so whole-board passes can work on
+// the raw bytes: bits 0-3 mines around, bit 4 mined, bit 5 opened, bits 6-7 mark.
+struct Cell {
+   static auto constexpr MINES_NEAR_MASK = std::uint8_t(0x0F);
+   static auto constexpr MINED_BIT = std::uint8_t(0x10);
+   static auto constexpr OPENED_BIT = std::uint8_t(0x20);
+   static auto constexpr STATE_SHIFT = 6;
+
+   std::uint8_t bits;
+
+   bool IsOpened() const { return bits & OPENED_BIT; }
+   bool IsMined() const { return bits & MINED_BIT; }
+   std::uint8_t MinesNear() const { return std::uint8_t(bits & MINES_NEAR_MASK); }
+   RCellState State() const { return RCellState(bits >> STATE_SHIFT); }
+
+   void Open() { bits |= OPENED_BIT; }
+   void SetMined(bool mined) { bits = std::uint8_t(mined ? bits | MINED_BIT : bits & ~MINED_BIT); }
+   void SetMinesNear(int mines) { bits = std::uint8_t((bits & ~MINES_NEAR_MASK) | mines); }
+   void SetState(RCellState state) { bits = std::uint8_t((bits & ~(3 << STATE_SHIFT)) | (state << STATE_SHIFT)); }
+
+   bool IsMarked() const {
+      return State() == RCellState::Flagged || State() == RCellState::Questioned;
+   }
+
+   void ToggleState() {
+      auto state = State();
+      SetState(state == RCellState::Still ? RCellState::Flagged : state == RCellState::Flagged ? RCellState::Questioned : RCellState::Still);
+   }
+};
+
+static_assert(sizeof(Cell) == 1, "Cell must stay one byte so large boards fit in memory");
@@ -0,0 +1,104 @@
+#include "CellStore.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CELL_STORE_SSE2
+#endif
+
+namespace {
+   // Fills the mines-around nibble of every board cell from the mined bits
+   // (0x10) of its 3x3 block, one row at a time: first the column sums of the
+   // rows above, at and below go into `sums`, then three neighbouring column
+   // sums are added and the centre taken back out. A sum is at most 9 * 0x10,
+   // so sixteen cells add bytewise in one SSE2 register without carries, and
+   // shifting it down by four gives the count. Only the low nibble of a cell
+   // is written, so the next row still reads the mined bits it needs.
+   void FillMinesNear(Cell* cells, std::size_t stride, int width, int height, std::vector<std::uint8_t>& sums) {
+      static_assert(Cell::MINED_BIT == 0x10, "the sums shift the mined bit down by four");
+      auto bytes = reinterpret_cast<std::uint8_t*>(cells);
+      sums.resize(stride);
+      for (auto y = 1; y <= height; y++) {
+         auto row = bytes + y * stride;
+         // rows 0 and height + 1 are the border, so both stay inside the cells
+         auto above = row - stride;
+         auto below = row + stride;
+         std::size_t x = 0;
+#ifdef CELL_STORE_SSE2
+         auto const mined = _mm_set1_epi8(Cell::MINED_BIT);
+         auto const keep = _mm_set1_epi8(char(~Cell::MINES_NEAR_MASK));
+         auto const low = _mm_set1_epi8(Cell::MINES_NEAR_MASK);
+         for (; x + 16 <= stride; x += 16) {
+            auto up = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(above + x)), mined);
+            auto at = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(row + x)), mined);
+            auto down = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(below + x)), mined);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums.data() + x), _mm_add_epi8(_mm_add_epi8(up, at), down));
+         }
+#endif
+         for (; x < stride; x++) {
+            sums[x] = std::uint8_t((above[x] & Cell::MINED_BIT) + (row[x] & Cell::MINED_BIT) + (below[x] & Cell::MINED_BIT));
+         }
+
+         x = 1;
+#ifdef CELL_STORE_SSE2
+         // the right hand loads reach the border column, never past the sums
+         for (; x + 16 <= std::size_t(width) + 1; x += 16) {
+            auto left = _mm_loadu_si128(reinterpret_cast<__m128i const*>(sums.data() + x - 1));
+            auto centre = _mm_loadu_si128(reinterpret_cast<__m128i const*>(sums.data() + x));
+            auto right = _mm_loadu_si128(reinterpret_cast<__m128i const*>(sums.data() + x + 1));
+            auto self = _mm_loadu_si128(reinterpret_cast<__m128i const*>(row + x));
+            auto sum = _mm_sub_epi8(_mm_add_epi8(_mm_add_epi8(left, centre), right), _mm_and_si128(self, mined));
+            auto count = _mm_and_si128(_mm_srli_epi16(sum, 4), low);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), _mm_or_si128(_mm_and_si128(self, keep), count));
+         }
+#endif
+         for (; x <= std::size_t(width); x++) {
+            auto sum = sums[x - 1] + sums[x] + sums[x + 1] - (row[x] & Cell::MINED_BIT);
+            row[x] = std::uint8_t((row[x] & ~Cell::MINES_NEAR_MASK) | (sum >> 4));
+         }
+      }
+   }
+
+   std::size_t CountBits(std::vector<Cell> const& cells, std::uint8_t mask, std::uint8_t value) {
+      return std::count_if(cells.begin(), cells.end(), [mask, value](Cell cell) {
+         return (cell.bits & mask) == value;
+         });
+   }
+}
+
+void CellStore::Reset(std::size_t stride, std::size_t rows) {
+   stride_ = stride;
+   rows_ = rows;
+   cells_.assign(stride * rows, Cell{});
+}
+
+void CellStore::MoveMine(std::size_t from, std::size_t to) {
+   cells_[from].SetMined(false);
+   cells_[to].SetMined(true);
+   // border cells keep a count of zero
+   auto adjust = [this](std::size_t centre, int delta) {
+      for (auto y = centre / stride_ - 1; y <= centre / stride_ + 1; y++) {
+         for (auto x = centre % stride_ - 1; x <= centre % stride_ + 1; x++) {
+            auto index = y * stride_ + x;
+            if (index == centre || x == 0 || x == stride_ - 1 || y == 0 || y == rows_ - 1) continue;
+            cells_[index].SetMinesNear(cells_[index].MinesNear() + delta);
+         }
+      }
+   };
+   adjust(from, -1);
+   adjust(to, 1);
+}
+
+void CellStore::CountMines(int width, int height) {
+   FillMinesNear(cells_.data(), stride_, width, height, sums_);
+}
+
+std::size_t CellStore::CountOpened() const {
+   auto border = 2 * stride_ + 2 * (rows_ - 2);
+   return CountBits(cells_, Cell::OPENED_BIT, Cell::OPENED_BIT) - border;
+}
+
+std::size_t CellStore::CountFlagged() const {
+   return CountBits(cells_, std::uint8_t(3 << Cell::STATE_SHIFT), std::uint8_t(RCellState::Flagged << Cell::STATE_SHIFT));
+}
@@ -0,0 +1,48 @@
+#pragma once
+//
+// CellStore.h
+// One byte per cell, row-major with the board border included.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Cell.h"
+
+class CellStore {
+public:
+   // Sizes the store for `rows` rows of `stride` cells and clears it.
+   void Reset(std::size_t stride, std::size_t rows);
+   // Marks a cell as border: opened, never mined.
+   void SetBorder(std::size_t index) { cells_[index] = Cell{ Cell::OPENED_BIT }; }
+
+   Cell Get(std::size_t index) const { return cells_[index]; }
+   bool IsOpened(std::size_t index) const { return cells_[index].IsOpened(); }
+   bool IsMined(std::size_t index) const { return cells_[index].IsMined(); }
+   bool IsMarked(std::size_t index) const { return cells_[index].IsMarked(); }
+   RCellState State(std::size_t index) const { return cells_[index].State(); }
+   std::uint8_t MinesNear(std::size_t index) const { return cells_[index].MinesNear(); }
+
+   void Open(std::size_t index) { cells_[index].Open(); }
+   void SetMined(std::size_t index) { cells_[index].SetMined(true); }
+   void ClearMined(std::size_t index) { cells_[index].SetMined(false); }
+   // For boards whose neighbours are not the 3x3 block, which count themselves.
+   void SetMinesNear(std::size_t index, int mines) { cells_[index].SetMinesNear(mines); }
+   void SetState(std::size_t index, RCellState state) { cells_[index].SetState(state); }
+   // Moves a placed mine to a free cell, keeping the counts around both right.
+   void MoveMine(std::size_t from, std::size_t to);
+
+   // Fills every board cell's mines-around count once the mines are placed.
+   void CountMines(int width, int height);
+   // Opened and flagged cells on the board, border excluded.
+   std::size_t CountOpened() const;
+   std::size_t CountFlagged() const;
+   std::size_t Bytes() const { return cells_.size() * sizeof(Cell); }
+
+private:
+   std::size_t stride_ = 0;
+   std::size_t rows_ = 0;
+   std::vector<Cell> cells_;
+   std::vector<std::uint8_t> sums_;
+};
@@ -0,0 +1,35 @@
+#include "DirtyCells.h"
+
+#include <algorithm>
+
+DirtyCells::DirtyCells(int width, int height) :
+   width_(width),
+   height_(height),
+   marked_(std::size_t(width) * height) {
+   cells_.reserve(std::max(std::min(marked_.size(), CAPACITY), std::size_t(1)));
+}
+
+void DirtyCells::Mark(Pos pos) {
+   if (all_ || pos.x < 0 || pos.x >= width_ || pos.y < 0 || pos.y >= height_) return;
+   auto& marked = marked_[std::size_t(pos.y) * width_ + pos.x];
+   if (marked) return;
+   if (cells_.size() == cells_.capacity()) {
+      Clear();
+      all_ = true;
+      return;
+   }
+   marked = 1;
+   cells_.push_back(pos);
+}
+
+void DirtyCells::Mark(std::span<Pos const> cells) {
+   for (auto pos : cells) Mark(pos);
+}
+
+void DirtyCells::Clear() {
+   for (auto pos : cells_) {
+      marked_[std::size_t(pos.y) * width_ + pos.x] = 0;
+   }
+   cells_.clear();
+   all_ = false;
+}
@@ -0,0 +1,43 @@
+#pragma once
+//
+// DirtyCells.h
+// The cells whose picture changed since the renderer last caught up, so a
+// frame redraws what changed rather than the whole board.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Board.h"
+
+// Each cell is listed once however often it is marked. Marking and clearing
+// cost the number of cells marked, never the board size. The list is
+// reserved up front, and past CAPACITY cells the whole board is marked
+// instead, so marking never allocates.
+class DirtyCells {
+public:
+   static auto constexpr CAPACITY = std::size_t(1) << 16;
+
+   DirtyCells(int width, int height);
+
+   void Mark(Pos pos);
+   void Mark(std::span<Pos const> cells);
+   // For changes that touch every cell, like a new board or the odds overlay.
+   void MarkAll() { all_ = true; }
+
+   // When set, every cell must be redrawn and Cells is not complete.
+   bool All() const { return all_; }
+   bool Empty() const { return !all_ && cells_.empty(); }
+   std::span<Pos const> Cells() const { return cells_; }
+   // Forgets everything marked, once the renderer has redrawn it.
+   void Clear();
+
+private:
+   int width_;
+   int height_;
+   bool all_ = true;
+   std::vector<std::uint8_t> marked_;
+   std::vector<Pos> cells_;
+};
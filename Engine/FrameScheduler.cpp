@@ -0,0 +1,91 @@
+#include "FrameScheduler.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+std::chrono::nanoseconds ThreadCpuTime() {
+#ifdef _WIN32
+   FILETIME creation, exit, kernel, user;
+   if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return {};
+   auto ticks = [](FILETIME time) { return (std::uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+   // 100 ns units
+   return std::chrono::nanoseconds((ticks(kernel) + ticks(user)) * 100);
+#else
+   timespec time;
+   if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) return {};
+   return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+#endif
+}
+
+FrameScheduler::FrameScheduler(FrameMode mode, Clock::duration interval) :
+   mode_(mode),
+   interval_(interval) {
+}
+
+void FrameScheduler::WakeAt(Clock::time_point at) {
+   wake_ = at;
+}
+
+bool FrameScheduler::Frame(FrameRenderer& renderer, Clock::time_point now) {
+   Measure(now);
+   if (now >= wake_) wake_ = Clock::time_point::max();
+   if (!Due(now)) {
+      stats_.skipped++;
+      return false;
+   }
+
+   // a late frame moves the schedule on rather than drawing a burst to catch up
+   nextFrame_ += interval_;
+   if (nextFrame_ <= now) nextFrame_ = now + interval_;
+
+   auto dirty = dirty_;
+   dirty_ = Clean;
+   auto sprites = renderer.RenderFrame(dirty);
+   renderer.PresentFrame(mode_ != FrameMode::Capped);
+   stats_.frames++;
+   stats_.sprites += sprites;
+   stats_.lastSprites = sprites;
+   return true;
+}
+
+FrameScheduler::Clock::duration FrameScheduler::Idle(Clock::time_point now) const {
+   auto until = [now](Clock::time_point at) { return at > now ? at - now : Clock::duration::zero(); };
+   switch (mode_) {
+   case FrameMode::VSync:
+      return Clock::duration::zero();
+   case FrameMode::Capped:
+      return until(nextFrame_);
+   default:
+      if (dirty_ != Clean) return until(nextFrame_);
+      return wake_ == Clock::time_point::max() ? Clock::duration::max() : until(wake_);
+   }
+}
+
+bool FrameScheduler::Due(Clock::time_point now) const {
+   switch (mode_) {
+   case FrameMode::VSync:
+      return true;
+   case FrameMode::Capped:
+      return now >= nextFrame_;
+   default:
+      return dirty_ != Clean && now >= nextFrame_;
+   }
+}
+
+void FrameScheduler::Measure(Clock::time_point now) {
+   auto cpu = ThreadCpuTime();
+   if (measuring_) {
+      stats_.cpu += cpu - lastCpu_;
+      stats_.wall += now - lastWall_;
+   }
+   measuring_ = true;
+   lastCpu_ = cpu;
+   lastWall_ = now;
+}
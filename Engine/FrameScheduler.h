@@ -0,0 +1,114 @@
+#pragma once
+//
+// FrameScheduler.h
+// Decides when the main loop draws, and how long it may sleep in between.
+// Knows nothing of Direct3D: drawing goes through FrameRenderer, so the
+// scheduling runs headless against NullRenderer as well.
+//
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+enum class FrameMode : std::uint8_t {
+   VSync,    // a frame every turn, paced by the presentation
+   Capped,   // a frame every interval
+   OnDemand, // a frame only when something visible changed, at most once an interval
+};
+
+// What changed since the last frame drawn, as bits.
+enum Dirty : std::uint32_t {
+   Clean = 0,
+   BoardChanged = 1 << 0,
+   HoverChanged = 1 << 1,
+   TimerChanged = 1 << 2,
+   PanelChanged = 1 << 3,
+   AllChanged = 0xFFFFFFFF,
+};
+
+class FrameRenderer {
+public:
+   virtual ~FrameRenderer() = default;
+
+   // Draws a frame and returns the sprites it submitted; `dirty` says what
+   // changed since the last one.
+   virtual std::size_t RenderFrame(std::uint32_t dirty) = 0;
+   // Shows the frame, waiting for the vertical blank when asked to.
+   virtual void PresentFrame(bool vsync) = 0;
+};
+
+// Draws nothing and counts what it was asked to do.
+class NullRenderer : public FrameRenderer {
+public:
+   std::size_t RenderFrame(std::uint32_t dirty) override {
+      frames++;
+      lastDirty = dirty;
+      return 0;
+   }
+   void PresentFrame(bool vsync) override { synced += vsync ? 1 : 0; }
+
+   std::uint64_t frames = 0;
+   std::uint64_t synced = 0;
+   std::uint32_t lastDirty = Clean;
+};
+
+struct FrameStats {
+   std::uint64_t frames = 0;  // drawn
+   std::uint64_t skipped = 0; // loop turns that drew nothing
+   std::uint64_t sprites = 0; // over all frames
+   std::size_t lastSprites = 0;
+   // CPU time of the loop thread and real time, both since the first Frame call
+   std::chrono::nanoseconds cpu{};
+   std::chrono::nanoseconds wall{};
+
+   double SpritesPerFrame() const { return frames ? double(sprites) / double(frames) : 0; }
+   double CpuPerFrameMs() const { return frames ? cpu.count() / 1e6 / double(frames) : 0; }
+   // Share of one core the loop keeps busy.
+   double CpuShare() const { return wall.count() ? double(cpu.count()) / double(wall.count()) : 0; }
+};
+
+// CPU time the calling thread has used so far.
+std::chrono::nanoseconds ThreadCpuTime();
+
+// Call Frame once per turn of the main loop, after the update, and then wait
+// for input for at most Idle before the next turn. Everything the update
+// changes on screen is reported to Invalidate.
+class FrameScheduler {
+public:
+   using Clock = std::chrono::steady_clock;
+
+   static auto constexpr DEFAULT_INTERVAL = std::chrono::microseconds(16'667);
+
+   explicit FrameScheduler(FrameMode mode = FrameMode::VSync, Clock::duration interval = DEFAULT_INTERVAL);
+
+   void Invalidate(std::uint32_t dirty) { dirty_ |= dirty; }
+   // Makes Idle end by `at` even with nothing dirty, e.g. when the timer is
+   // about to show the next second. Replaces the previous wake-up time.
+   void WakeAt(Clock::time_point at);
+
+   // Draws and presents a frame if one is due at `now`, and says whether it did.
+   bool Frame(FrameRenderer& renderer, Clock::time_point now);
+   // How long the loop may wait for input before the next Frame call;
+   // Clock::duration::max() when only input can make a frame due.
+   Clock::duration Idle(Clock::time_point now) const;
+
+   FrameMode Mode() const { return mode_; }
+   Clock::duration Interval() const { return interval_; }
+   std::uint32_t Pending() const { return dirty_; }
+   FrameStats const& Stats() const { return stats_; }
+
+private:
+   bool Due(Clock::time_point now) const;
+   void Measure(Clock::time_point now);
+
+   FrameMode mode_;
+   Clock::duration interval_;
+   std::uint32_t dirty_ = AllChanged;
+   Clock::time_point nextFrame_ = {};
+   Clock::time_point wake_ = Clock::time_point::max();
+
+   FrameStats stats_;
+   bool measuring_ = false;
+   Clock::time_point lastWall_ = {};
+   std::chrono::nanoseconds lastCpu_{};
+};
@@ -0,0 +1,45 @@
+#pragma once
+//
+// GameClock.h
+// Time of a game in whole microseconds, advanced by the frame loop rather
+// than read from the system, with a split time kept for every action.
+//
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Integer microseconds add up exactly, so the elapsed time is the sum of the
+// frame steps with no drift, and only ever grows while running.
+class GameClock {
+public:
+   using Duration = std::chrono::microseconds;
+
+   // Starts from zero, dropping the splits of any earlier run.
+   void Start() {
+      elapsed_ = 0;
+      splits_.clear();
+      running_ = true;
+   }
+   void Stop() { running_ = false; }
+   // Ignored while stopped.
+   void Advance(Duration dt) {
+      if (running_ && dt.count() > 0) elapsed_ += std::uint64_t(dt.count());
+   }
+   // Notes the time of an action and returns it.
+   std::uint64_t Split() {
+      splits_.push_back(elapsed_);
+      return elapsed_;
+   }
+
+   bool Running() const { return running_; }
+   std::uint64_t Elapsed() const { return elapsed_; }
+   std::uint64_t Seconds() const { return elapsed_ / 1'000'000; }
+   std::span<std::uint64_t const> Splits() const { return splits_; }
+
+private:
+   std::uint64_t elapsed_ = 0;
+   bool running_ = false;
+   std::vector<std::uint64_t> splits_;
+};
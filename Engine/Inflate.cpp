@@ -0,0 +1,264 @@
+#include "Inflate.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+   auto constexpr MAX_BITS = 15;
+   // codes up to this long are found with one lookup, longer ones bit by bit
+   auto constexpr FAST_BITS = 9;
+
+   // RFC 1951 3.2.5: base and extra bits of the length and distance codes
+   std::uint16_t constexpr LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+      35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+   std::uint8_t constexpr LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+      3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+   std::uint16_t constexpr DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+      257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+   std::uint8_t constexpr DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+      7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+   // the order code length code lengths are stored in
+   std::uint8_t constexpr CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+   // Deflate packs bits from the least significant end of each byte.
+   class BitReader {
+   public:
+      explicit BitReader(std::span<std::uint8_t const> in) : in_(in) {}
+
+      std::uint32_t Get(int count) {
+         Fill(count);
+         if (count_ < count) throw std::runtime_error("Compressed data cut short");
+         auto value = buffer_ & ((1u << count) - 1);
+         buffer_ >>= count;
+         count_ -= count;
+         return value;
+      }
+
+      // Up to `count` bits without taking them; past the end they read as 0.
+      std::uint32_t Peek(int count) {
+         Fill(count);
+         return buffer_ & ((1u << count) - 1);
+      }
+
+      int Available() const { return count_; }
+
+      void Skip(int count) {
+         buffer_ >>= count;
+         count_ -= count;
+      }
+
+      // Stored blocks start on a byte.
+      void AlignToByte() {
+         Skip(count_ % 8);
+      }
+
+      std::size_t Position() const { return pos_ - std::size_t(count_ / 8); }
+
+   private:
+      void Fill(int count) {
+         while (count_ < count && pos_ < in_.size()) {
+            buffer_ |= std::uint32_t(in_[pos_++]) << count_;
+            count_ += 8;
+         }
+      }
+
+      std::span<std::uint8_t const> in_;
+      std::size_t pos_ = 0;
+      std::uint32_t buffer_ = 0;
+      int count_ = 0;
+   };
+
+   // Canonical Huffman code. `fast` maps the next FAST_BITS input bits to
+   // symbol << 4 | length, or 0 for a longer code; `counts` and `symbols`
+   // decode those the slow way.
+   class Huffman {
+   public:
+      Huffman(std::uint8_t const* lengths, int symbols) : symbols_(symbols) {
+         for (auto s = 0; s < symbols; s++) counts_[lengths[s]]++;
+         counts_[0] = 0;
+         auto left = 1;
+         for (auto length = 1; length <= MAX_BITS; length++) {
+            left = (left << 1) - counts_[length];
+            if (left < 0) throw std::runtime_error("Bad Huffman code lengths");
+         }
+
+         std::array<std::uint16_t, MAX_BITS + 2> offsets = {};
+         std::array<std::uint16_t, MAX_BITS + 1> next = {};
+         auto code = 0;
+         for (auto length = 1; length <= MAX_BITS; length++) {
+            offsets[length + 1] = std::uint16_t(offsets[length] + counts_[length]);
+            code = (code + counts_[length - 1]) << 1;
+            next[length] = std::uint16_t(code);
+         }
+         for (auto s = 0; s < symbols; s++) {
+            auto length = lengths[s];
+            if (length == 0) continue;
+            symbols_[offsets[length]++] = std::uint16_t(s);
+            if (length > FAST_BITS) continue;
+            // the code's bits come first to last, so it is looked up reversed
+            auto reversed = 0u;
+            auto bits = unsigned(next[length]++);
+            for (auto i = 0; i < length; i++, bits >>= 1) reversed = reversed << 1 | (bits & 1);
+            for (auto i = reversed; i < fast_.size(); i += 1u << length) fast_[i] = std::uint16_t(s << 4 | length);
+         }
+      }
+
+      int Decode(BitReader& bits) const {
+         auto entry = fast_[bits.Peek(FAST_BITS)];
+         auto length = entry & 15;
+         if (entry != 0 && length <= bits.Available()) {
+            bits.Skip(length);
+            return entry >> 4;
+         }
+         // one bit at a time, as in zlib's puff
+         auto code = 0;
+         auto first = 0;
+         auto index = 0;
+         for (auto len = 1; len <= MAX_BITS; len++) {
+            code |= int(bits.Get(1));
+            auto count = int(counts_[len]);
+            if (code - count < first) return symbols_[index + (code - first)];
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+         }
+         throw std::runtime_error("Bad Huffman code");
+      }
+
+   private:
+      std::array<std::uint16_t, MAX_BITS + 1> counts_ = {};
+      std::vector<std::uint16_t> symbols_;
+      std::array<std::uint16_t, 1 << FAST_BITS> fast_ = {};
+   };
+
+   void InflateBlock(BitReader& bits, Huffman const& literals, Huffman const& distances, std::vector<std::uint8_t>& out) {
+      while (true) {
+         auto symbol = literals.Decode(bits);
+         if (symbol < 256) {
+            out.push_back(std::uint8_t(symbol));
+            continue;
+         }
+         if (symbol == 256) return;
+         symbol -= 257;
+         if (symbol >= 29) throw std::runtime_error("Bad deflate length code");
+         auto length = LENGTH_BASE[symbol] + bits.Get(LENGTH_EXTRA[symbol]);
+         auto code = distances.Decode(bits);
+         if (code >= 30) throw std::runtime_error("Bad deflate distance code");
+         auto distance = DISTANCE_BASE[code] + bits.Get(DISTANCE_EXTRA[code]);
+         if (distance > out.size()) throw std::runtime_error("Deflate distance before the start");
+         // may overlap what it writes, so byte by byte
+         auto from = out.size() - distance;
+         for (std::size_t i = 0; i < length; i++) out.push_back(out[from + i]);
+      }
+   }
+
+   void InflateDynamic(BitReader& bits, std::vector<std::uint8_t>& out) {
+      auto literalCount = int(bits.Get(5)) + 257;
+      auto distanceCount = int(bits.Get(5)) + 1;
+      auto codeLengthCount = int(bits.Get(4)) + 4;
+      if (literalCount > 286 || distanceCount > 30) throw std::runtime_error("Bad deflate block header");
+
+      std::uint8_t codeLengths[19] = {};
+      for (auto i = 0; i < codeLengthCount; i++) codeLengths[CODE_LENGTH_ORDER[i]] = std::uint8_t(bits.Get(3));
+      Huffman codeLengthCode(codeLengths, 19);
+
+      std::uint8_t lengths[286 + 30] = {};
+      for (auto i = 0; i < literalCount + distanceCount;) {
+         auto symbol = codeLengthCode.Decode(bits);
+         if (symbol < 16) {
+            lengths[i++] = std::uint8_t(symbol);
+            continue;
+         }
+         auto repeat = 0u;
+         auto value = std::uint8_t(0);
+         if (symbol == 16) {
+            if (i == 0) throw std::runtime_error("Deflate repeat with nothing before");
+            value = lengths[i - 1];
+            repeat = 3 + bits.Get(2);
+         }
+         else if (symbol == 17) repeat = 3 + bits.Get(3);
+         else repeat = 11 + bits.Get(7);
+         if (i + int(repeat) > literalCount + distanceCount) throw std::runtime_error("Deflate code lengths overrun");
+         while (repeat--) lengths[i++] = value;
+      }
+      if (lengths[256] == 0) throw std::runtime_error("Deflate block without an end code");
+
+      Huffman literals(lengths, literalCount);
+      Huffman distances(lengths + literalCount, distanceCount);
+      InflateBlock(bits, literals, distances, out);
+   }
+
+   void InflateFixed(BitReader& bits, std::vector<std::uint8_t>& out) {
+      static auto const tables = [] {
+         std::uint8_t lengths[288 + 30];
+         std::fill(lengths, lengths + 144, std::uint8_t(8));
+         std::fill(lengths + 144, lengths + 256, std::uint8_t(9));
+         std::fill(lengths + 256, lengths + 280, std::uint8_t(7));
+         std::fill(lengths + 280, lengths + 288, std::uint8_t(8));
+         std::fill(lengths + 288, lengths + 318, std::uint8_t(5));
+         return std::pair{ Huffman(lengths, 288), Huffman(lengths + 288, 30) };
+      }();
+      InflateBlock(bits, tables.first, tables.second, out);
+   }
+
+   std::uint32_t Adler32(std::span<std::uint8_t const> data) {
+      std::uint32_t a = 1;
+      std::uint32_t b = 0;
+      // the largest run before the sums can overflow
+      auto constexpr RUN = std::size_t(5552);
+      for (std::size_t at = 0; at < data.size(); at += RUN) {
+         auto end = std::min(data.size(), at + RUN);
+         for (auto i = at; i < end; i++) {
+            a += data[i];
+            b += a;
+         }
+         a %= 65521;
+         b %= 65521;
+      }
+      return b << 16 | a;
+   }
+}
+
+std::vector<std::uint8_t> Inflate(std::span<std::uint8_t const> zlib, std::size_t sizeHint) {
+   if (zlib.size() < 6) throw std::runtime_error("Compressed data cut short");
+   auto method = zlib[0];
+   auto flags = zlib[1];
+   if ((method & 15) != 8 || (method << 8 | flags) % 31 != 0) throw std::runtime_error("Not a zlib stream");
+   if (flags & 0x20) throw std::runtime_error("zlib preset dictionaries are not supported");
+
+   std::vector<std::uint8_t> out;
+   out.reserve(sizeHint);
+   BitReader bits(zlib.subspan(2));
+   auto last = false;
+   while (!last) {
+      last = bits.Get(1) != 0;
+      switch (bits.Get(2)) {
+      case 0: {
+         bits.AlignToByte();
+         auto length = bits.Get(16);
+         auto complement = bits.Get(16);
+         if ((length ^ 0xFFFF) != complement) throw std::runtime_error("Bad stored block length");
+         for (std::uint32_t i = 0; i < length; i++) out.push_back(std::uint8_t(bits.Get(8)));
+         break;
+      }
+      case 1:
+         InflateFixed(bits, out);
+         break;
+      case 2:
+         InflateDynamic(bits, out);
+         break;
+      default:
+         throw std::runtime_error("Bad deflate block type");
+      }
+   }
+
+   bits.AlignToByte();
+   auto trailer = 2 + bits.Position();
+   if (trailer + 4 > zlib.size()) throw std::runtime_error("Compressed data cut short");
+   auto expected = std::uint32_t(zlib[trailer]) << 24 | std::uint32_t(zlib[trailer + 1]) << 16 |
+      std::uint32_t(zlib[trailer + 2]) << 8 | zlib[trailer + 3];
+   if (Adler32(out) != expected) throw std::runtime_error("Decompressed data fails its checksum");
+   return out;
+}
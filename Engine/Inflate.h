@@ -0,0 +1,16 @@
+#pragma once
+//
+// Inflate.h
+// Decompresses zlib streams (RFC 1950 around RFC 1951 deflate), as found in
+// PNG image data.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// `sizeHint` reserves the output up front when the size is known. Throws
+// std::runtime_error if the stream is malformed, cut short or fails its
+// checksum.
+std::vector<std::uint8_t> Inflate(std::span<std::uint8_t const> zlib, std::size_t sizeHint = 0);
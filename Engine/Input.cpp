@@ -0,0 +1,84 @@
+#include "Input.h"
+
+void InputQueue::Push(InputEvent const& event) {
+   pushed_++;
+   if (!events_.Empty()) {
+      auto& last = events_.Back();
+      if (last.kind == event.kind && (event.kind == InputKind::PointerMove || event.kind == InputKind::Wheel)) {
+         last.x = event.x;
+         last.y = event.y;
+         last.wheel += event.wheel;
+         coalesced_++;
+         return;
+      }
+   }
+   events_.Push(event);
+}
+
+bool InputQueue::Pop(InputEvent& event) {
+   if (events_.Empty()) return false;
+   event = events_.Pop();
+   return true;
+}
+
+void InputDispatcher::Apply(InputEvent const& event, std::vector<InputAction>& actions) {
+   auto action = [&event](InputActionKind kind) {
+      return InputAction{ kind, event.x, event.y, 0, 0, 0, 0, event.time };
+   };
+
+   switch (event.kind) {
+   case InputKind::PointerMove: {
+      if (Held(MouseButton::Middle) && x_ >= 0) {
+         auto pan = action(InputActionKind::Pan);
+         pan.dx = event.x - x_;
+         pan.dy = event.y - y_;
+         actions.push_back(pan);
+      }
+      x_ = event.x;
+      y_ = event.y;
+      actions.push_back(action(InputActionKind::Hover));
+      break;
+   }
+   case InputKind::ButtonDown: {
+      x_ = event.x;
+      y_ = event.y;
+      actions.push_back(action(InputActionKind::Hover));
+      auto button = MouseButton(event.code);
+      buttons_[std::size_t(button)] = true;
+      if (button == MouseButton::Left) actions.push_back(action(InputActionKind::Press));
+      break;
+   }
+   case InputKind::ButtonUp: {
+      x_ = event.x;
+      y_ = event.y;
+      actions.push_back(action(InputActionKind::Hover));
+      auto button = MouseButton(event.code);
+      if (!Held(button)) break;
+      buttons_[std::size_t(button)] = false;
+      if (button == MouseButton::Left) actions.push_back(action(InputActionKind::Click));
+      if (button == MouseButton::Right) actions.push_back(action(InputActionKind::Mark));
+      break;
+   }
+   case InputKind::Wheel: {
+      auto zoom = action(InputActionKind::Zoom);
+      zoom.notches = float(event.wheel) / WHEEL_NOTCH;
+      actions.push_back(zoom);
+      break;
+   }
+   case InputKind::KeyDown:
+      keys_[event.code] = true;
+      break;
+   case InputKind::KeyUp: {
+      if (!keys_[event.code]) break;
+      keys_[event.code] = false;
+      auto key = action(InputActionKind::Key);
+      key.key = event.code;
+      actions.push_back(key);
+      break;
+   }
+   case InputKind::Cancel:
+      buttons_ = {};
+      keys_.reset();
+      break;
+   }
+}
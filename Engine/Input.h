@@ -0,0 +1,122 @@
+#pragma once
+//
+// Input.h
+// Window input as timestamped events: the window procedure queues them and
+// the update applies them in order, so a press and a release between two
+// frames both count, and pointer moves are handled once per update rather
+// than once per message.
+//
+
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RingQueue.h"
+
+enum class InputKind : std::uint8_t {
+   PointerMove,
+   ButtonDown,
+   ButtonUp,
+   Wheel,
+   KeyDown,
+   KeyUp,
+   // the window lost focus: whatever is held is let go without acting
+   Cancel,
+};
+
+enum class MouseButton : std::uint8_t {
+   Left,
+   Right,
+   Middle,
+};
+
+struct InputEvent {
+   using Clock = std::chrono::steady_clock;
+
+   InputKind kind;
+   std::uint8_t code; // the MouseButton, or the virtual key code
+   int x;             // pointer position in client pixels
+   int y;
+   int wheel;         // wheel turn, 120 per notch
+   Clock::time_point time;
+};
+
+// A growing ring, so no event is ever dropped. A pointer move merges into a
+// move queued right before it and a wheel turn into a turn, keeping the
+// newest position and the oldest time: latency is measured from the first
+// input an event stands for.
+class InputQueue {
+public:
+   void Push(InputEvent const& event);
+   bool Pop(InputEvent& event);
+   bool Empty() const { return events_.Empty(); }
+
+   std::size_t Pushed() const { return pushed_; }
+   std::size_t Coalesced() const { return coalesced_; }
+
+private:
+   RingQueue<InputEvent> events_;
+   std::size_t pushed_ = 0;
+   std::size_t coalesced_ = 0;
+};
+
+enum class InputActionKind : std::uint8_t {
+   Hover, // the pointer is at x, y
+   Press, // left button down at x, y
+   Click, // left button up at x, y, after a press
+   Mark,  // right button up at x, y, after a press
+   Pan,   // moved by dx, dy with the middle button held
+   Zoom,  // wheel turned by `notches` at x, y
+   Key,   // `key` released after a press
+};
+
+struct InputAction {
+   InputActionKind kind;
+   int x;
+   int y;
+   int dx;
+   int dy;
+   float notches;
+   std::uint8_t key;
+   InputEvent::Clock::time_point time;
+};
+
+// Turns events into the actions they stand for, keeping track of what is
+// held. A release counts only after its own press, so a button pressed
+// outside the window does not click when it comes up inside.
+class InputDispatcher {
+public:
+   static auto constexpr WHEEL_NOTCH = 120;
+
+   // Appends the actions of `event` to `actions`.
+   void Apply(InputEvent const& event, std::vector<InputAction>& actions);
+
+   bool Held(MouseButton button) const { return buttons_[std::size_t(button)]; }
+   bool KeyHeld(std::uint8_t key) const { return keys_[key]; }
+   int X() const { return x_; }
+   int Y() const { return y_; }
+
+private:
+   std::array<bool, 3> buttons_ = {};
+   std::bitset<256> keys_;
+   int x_ = -1;
+   int y_ = -1;
+};
+
+// From an input event to its effect on the game.
+struct LatencyStats {
+   std::size_t count = 0;
+   InputEvent::Clock::duration total = {};
+   InputEvent::Clock::duration max = {};
+
+   void Add(InputEvent::Clock::duration latency) {
+      count++;
+      total += latency;
+      if (latency > max) max = latency;
+   }
+   double MeanMs() const { return count ? std::chrono::duration<double, std::milli>(total).count() / count : 0; }
+   double MaxMs() const { return std::chrono::duration<double, std::milli>(max).count(); }
+};
@@ -0,0 +1,210 @@
+#include "Logger.h"
+
+#include <csignal>
+#include <cstdio>
+#include <exception>
+#include <system_error>
+
+namespace {
+   char const* const LEVEL_NAMES[] = { "Debug", "Info", "Warning", "Error" };
+   // how long a crash handler waits for the writer to finish a line
+   auto constexpr CRASH_LOCK_WAIT = std::chrono::milliseconds(200);
+
+   std::atomic<Logger*> crashLogger = nullptr;
+   std::terminate_handler previousTerminate = nullptr;
+
+   void OnTerminate() {
+      // taken, so the abort that follows does not log it again
+      if (auto logger = crashLogger.exchange(nullptr)) {
+         logger->Write(LogLevel::Error, "Terminated");
+         logger->FlushFromCrash();
+      }
+      if (previousTerminate) previousTerminate();
+      std::abort();
+   }
+
+   void OnSignal(int signal) {
+      if (auto logger = crashLogger.exchange(nullptr)) {
+         logger->Write(LogLevel::Error, signal == SIGSEGV ? "Crashed: segmentation fault" :
+            signal == SIGFPE ? "Crashed: arithmetic error" :
+            signal == SIGILL ? "Crashed: illegal instruction" : "Crashed: aborted");
+         logger->FlushFromCrash();
+      }
+      std::signal(signal, SIG_DFL);
+      std::raise(signal);
+   }
+}
+
+Logger::Logger(LoggerOptions options) :
+   options_(std::move(options)),
+   level_(options_.level) {
+   auto size = std::size_t(1);
+   while (size < options_.capacity) size <<= 1;
+   slots_ = std::make_unique<Slot[]>(size);
+   for (std::size_t i = 0; i < size; i++) slots_[i].sequence.store(i, std::memory_order_relaxed);
+   mask_ = size - 1;
+   ticks_ = lastTicks_ = Ticks();
+   time_ = lastTime_ = Microseconds();
+
+   Rotate();
+   writer_ = std::thread([this] { Run(); });
+}
+
+Logger::~Logger() {
+   {
+      std::lock_guard lock(wakeMutex_);
+      stopping_ = true;
+   }
+   wake_.notify_one();
+   writer_.join();
+   if (crashLogger.load() == this) FlushOnCrash(nullptr);
+}
+
+void Logger::Flush() {
+   std::lock_guard lock(mutex_);
+   Drain();
+}
+
+void Logger::FlushFromCrash() {
+   std::unique_lock lock(mutex_, std::defer_lock);
+   auto deadline = std::chrono::steady_clock::now() + CRASH_LOCK_WAIT;
+   while (!lock.try_lock()) {
+      // the writer may be the thread that crashed, holding the lock for good
+      if (std::chrono::steady_clock::now() > deadline) break;
+      std::this_thread::yield();
+   }
+   Drain();
+}
+
+std::int64_t Logger::Microseconds() {
+   return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Entries are queued between the last two readings, give or take one being
+// published while they are taken, so a straight line between them serves.
+std::int64_t Logger::TimeAt(std::int64_t ticks) const {
+   if (ticks_ == lastTicks_) return time_;
+   auto rate = double(time_ - lastTime_) / double(ticks_ - lastTicks_);
+   return lastTime_ + std::int64_t(double(ticks - lastTicks_) * rate);
+}
+
+std::uint32_t Logger::ThreadNumber() {
+   static std::atomic<std::uint32_t> next = 1;
+   thread_local auto number = next.fetch_add(1, std::memory_order_relaxed);
+   return number;
+}
+
+void Logger::Wake() {
+   wake_.notify_one();
+}
+
+void Logger::Run() {
+   std::unique_lock wakeLock(wakeMutex_);
+   while (true) {
+      wake_.wait_for(wakeLock, options_.flushInterval);
+      auto stopping = stopping_;
+      wakeLock.unlock();
+      {
+         std::lock_guard lock(mutex_);
+         Drain();
+      }
+      if (stopping) return;
+      wakeLock.lock();
+   }
+}
+
+void Logger::Drain() {
+   lastTicks_ = ticks_;
+   lastTime_ = time_;
+   ticks_ = Ticks();
+   time_ = Microseconds();
+
+   auto wrote = false;
+   while (true) {
+      auto head = head_.load(std::memory_order_relaxed);
+      auto& slot = slots_[head & mask_];
+      if (slot.sequence.load(std::memory_order_acquire) != head + 1) break;
+      WriteLine(slot.entry);
+      slot.sequence.store(head + mask_ + 1, std::memory_order_release);
+      head_.store(head + 1, std::memory_order_relaxed);
+      wrote = true;
+   }
+
+   auto dropped = dropped_.load(std::memory_order_relaxed);
+   if (dropped != droppedReported_) {
+      Entry note = { 0, 0, LogLevel::Warning, 0, nullptr, {} };
+      note.ticks = ticks_;
+      note.length = std::uint16_t(std::snprintf(note.text, TEXT_SIZE, "%zu entries dropped, the log queue was full",
+         dropped - droppedReported_));
+      WriteLine(note);
+      droppedReported_ = dropped;
+      wrote = true;
+   }
+   if (wrote) file_.flush();
+}
+
+// "2026-10-17 09:41:05.123456Z Info    [1] text", in UTC
+void Logger::WriteLine(Entry const& entry) {
+   using namespace std::chrono;
+   auto time = sys_time<microseconds>(microseconds(TimeAt(entry.ticks)));
+   auto day = floor<days>(time);
+   year_month_day date(day);
+   hh_mm_ss clock(time - day);
+
+   char line[64 + TEXT_SIZE];
+   auto length = std::snprintf(line, sizeof(line), "%04d-%02u-%02u %02d:%02d:%02d.%06lldZ %-7s [%u] ",
+      int(date.year()), unsigned(date.month()), unsigned(date.day()),
+      int(clock.hours().count()), int(clock.minutes().count()), int(clock.seconds().count()),
+      static_cast<long long>(clock.subseconds().count()), LEVEL_NAMES[int(entry.level)], entry.thread);
+   auto header = std::size_t(std::max(length, 0));
+   auto text = std::size_t(entry.length);
+   if (entry.format) text = std::min(entry.format(entry.text, line + header, TEXT_SIZE), TEXT_SIZE);
+   else std::copy_n(entry.text, text, line + header);
+   line[header + text] = '\n';
+   auto size = header + text + 1;
+
+   if (fileBytes_ + size > options_.maxBytes && fileBytes_ > 0) Rotate();
+   file_.write(line, std::streamsize(size));
+   fileBytes_ += size;
+}
+
+void Logger::Open() {
+   file_.open(options_.path, std::ios::binary | std::ios::trunc);
+   fileBytes_ = 0;
+}
+
+// log.2.txt -> log.3.txt, log.1.txt -> log.2.txt, log.txt -> log.1.txt; the
+// oldest falls off the end.
+void Logger::Rotate() {
+   if (file_.is_open()) {
+      file_.flush();
+      file_.close();
+   }
+   auto const& path = options_.path;
+   auto rotated = [&path](int index) {
+      auto name = path.stem();
+      name += ".";
+      name += std::to_string(index);
+      name += path.extension();
+      return path.parent_path() / name;
+   };
+   std::error_code error;
+   if (options_.keepFiles > 0) {
+      std::filesystem::remove(rotated(options_.keepFiles), error);
+      for (auto i = options_.keepFiles - 1; i >= 1; i--) std::filesystem::rename(rotated(i), rotated(i + 1), error);
+      std::filesystem::rename(path, rotated(1), error);
+   }
+   Open();
+}
+
+void FlushOnCrash(Logger* logger) {
+   auto previous = crashLogger.exchange(logger);
+   if (logger && !previous) {
+      previousTerminate = std::set_terminate(OnTerminate);
+      for (auto signal : { SIGABRT, SIGSEGV, SIGFPE, SIGILL }) std::signal(signal, OnSignal);
+   }
+   if (!logger && previous) {
+      std::set_terminate(previousTerminate);
+      for (auto signal : { SIGABRT, SIGSEGV, SIGFPE, SIGILL }) std::signal(signal, SIG_DFL);
+   }
+}
@@ -0,0 +1,222 @@
+#pragma once
+//
+// Logger.h
+// Log entries go into a slot of a lock-free queue, as text or as the values
+// to format later, and are written to disk by a background thread, with
+// levels, timestamps and size-based rotation.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define LOGGER_X86
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LOGGER_X86
+#endif
+
+enum class LogLevel : std::uint8_t {
+   Debug,
+   Info,
+   Warning,
+   Error,
+};
+
+struct LoggerOptions {
+   std::filesystem::path path = "log.txt";
+   LogLevel level = LogLevel::Info;
+   // past this size the file is renamed to `log.1.txt` and a new one started
+   std::uintmax_t maxBytes = 1 << 20;
+   // rotated files kept: log.1.txt is the newest
+   int keepFiles = 3;
+   // entries queued at most; more are dropped and counted, never waited for
+   std::size_t capacity = 4096;
+   // how long the writer leaves entries queued; errors are written at once
+   std::chrono::milliseconds flushInterval{ 100 };
+};
+
+// Producers claim a slot with one compare-and-swap and publish it with one
+// store (Vyukov's bounded queue), so logging neither locks nor allocates.
+// The writer takes a mutex only against Flush and FlushFromCrash, which
+// drain on the calling thread.
+class Logger {
+public:
+   // Longer text is cut; a slot is four cache lines.
+   static auto constexpr TEXT_SIZE = std::size_t(224);
+
+   // The file at `path` from an earlier run is rotated, not overwritten.
+   explicit Logger(LoggerOptions options = {});
+   // Writes everything queued.
+   ~Logger();
+
+   Logger(Logger const&) = delete;
+   Logger& operator=(Logger const&) = delete;
+
+   bool Enabled(LogLevel level) const { return level >= level_.load(std::memory_order_relaxed); }
+   void SetLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+
+   void Write(LogLevel level, std::string_view text) {
+      Emplace(level, [text](char* buffer, std::size_t size) {
+         auto length = std::min(text.size(), size);
+         std::copy_n(text.data(), length, buffer);
+         return length;
+         });
+   }
+   // `fill(buffer, TEXT_SIZE)` writes the text into the queue slot and
+   // returns its length; it must not log itself.
+   template <typename Fill>
+   void Emplace(LogLevel level, Fill&& fill);
+   // As Emplace, but `fill` is copied into the slot and called by the writer,
+   // which keeps formatting off the calling thread. It must be trivially
+   // copyable and hold values, not pointers to text that may change first.
+   template <typename Fill>
+   void Defer(LogLevel level, Fill const& fill);
+
+   // Blocks until everything queued so far is on disk.
+   void Flush();
+   // For crash handlers: drains on the calling thread without waiting on a
+   // writer that may never return, see FlushOnCrash.
+   void FlushFromCrash();
+
+   // Entries lost to a full queue.
+   std::size_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+   std::filesystem::path const& Path() const { return options_.path; }
+
+private:
+   struct Entry {
+      std::int64_t ticks; // from Ticks(), turned into time by the writer
+      std::uint32_t thread;
+      LogLevel level;
+      std::uint16_t length;
+      // set by Defer: formats the copy of its `fill` that `text` holds
+      std::size_t (*format)(void const* fill, char* buffer, std::size_t size);
+      alignas(std::int64_t) char text[TEXT_SIZE];
+   };
+
+   // aligned, so an entry with a short text is stored in one cache line
+   struct alignas(64) Slot {
+      std::atomic<std::size_t> sequence;
+      Entry entry;
+   };
+   static_assert(sizeof(Slot) == 256);
+
+   // The time stamp counter where there is one, the steady clock elsewhere:
+   // the system clock costs several times as much to read.
+   static std::int64_t Ticks() {
+#ifdef LOGGER_X86
+      return std::int64_t(__rdtsc());
+#else
+      return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+   }
+   static std::int64_t Microseconds();
+   static std::uint32_t ThreadNumber();
+   // Claims a slot, has `store(entry)` fill in the text and publishes it.
+   template <typename Store>
+   void Push(LogLevel level, Store const& store);
+   void Wake();
+   void Run();
+   // Writes the queued entries; with `mutex_` held.
+   void Drain();
+   // Microseconds since the Unix epoch at `ticks`, between the last two
+   // readings of both clocks; with `mutex_` held.
+   std::int64_t TimeAt(std::int64_t ticks) const;
+   void WriteLine(Entry const& entry);
+   void Open();
+   void Rotate();
+
+   LoggerOptions options_;
+   std::atomic<LogLevel> level_;
+   std::unique_ptr<Slot[]> slots_;
+   std::size_t mask_;
+   alignas(64) std::atomic<std::size_t> tail_ = 0;
+   alignas(64) std::atomic<std::size_t> head_ = 0;
+   std::atomic<std::size_t> dropped_ = 0;
+   std::size_t droppedReported_ = 0;
+
+   std::mutex mutex_;
+   std::int64_t lastTicks_ = 0;
+   std::int64_t lastTime_ = 0;
+   std::int64_t ticks_ = 0;
+   std::int64_t time_ = 0;
+   std::ofstream file_;
+   std::uintmax_t fileBytes_ = 0;
+
+   std::mutex wakeMutex_;
+   std::condition_variable wake_;
+   bool stopping_ = false;
+   std::thread writer_;
+};
+
+template <typename Fill>
+void Logger::Emplace(LogLevel level, Fill&& fill) {
+   Push(level, [&fill](Entry& entry) {
+      entry.format = nullptr;
+      entry.length = std::uint16_t(std::min(fill(entry.text, TEXT_SIZE), TEXT_SIZE));
+      });
+}
+
+template <typename Fill>
+void Logger::Defer(LogLevel level, Fill const& fill) {
+   static_assert(std::is_trivially_copyable_v<Fill> && std::is_trivially_destructible_v<Fill>,
+      "the writer formats from a bytewise copy");
+   static_assert(sizeof(Fill) <= TEXT_SIZE && alignof(Fill) <= alignof(std::int64_t), "too big for a slot");
+   Push(level, [&fill](Entry& entry) {
+      new (entry.text) Fill(fill);
+      entry.format = [](void const* stored, char* buffer, std::size_t size) {
+         return (*std::launder(static_cast<Fill const*>(stored)))(buffer, size);
+      };
+      entry.length = 0;
+      });
+}
+
+template <typename Store>
+void Logger::Push(LogLevel level, Store const& store) {
+   if (!Enabled(level)) return;
+
+   auto pos = tail_.load(std::memory_order_relaxed);
+   Slot* slot;
+   while (true) {
+      slot = &slots_[pos & mask_];
+      auto sequence = slot->sequence.load(std::memory_order_acquire);
+      auto diff = std::intptr_t(sequence) - std::intptr_t(pos);
+      if (diff == 0 && tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      if (diff < 0) {
+         dropped_.fetch_add(1, std::memory_order_relaxed);
+         return;
+      }
+      if (diff > 0) pos = tail_.load(std::memory_order_relaxed);
+   }
+
+#ifdef LOGGER_X86
+   // the next entries find their slots in cache rather than memory
+   _mm_prefetch(reinterpret_cast<char const*>(&slots_[(pos + 2) & mask_]), _MM_HINT_T0);
+#endif
+   auto& entry = slot->entry;
+   entry.ticks = Ticks();
+   entry.thread = ThreadNumber();
+   entry.level = level;
+   store(entry);
+   slot->sequence.store(pos + 1, std::memory_order_release);
+
+   // the writer comes by on its own otherwise; waking it costs a system call
+   if (level == LogLevel::Error || pos - head_.load(std::memory_order_relaxed) > mask_ / 2) Wake();
+}
+
+// Drains `logger` from std::terminate and from fatal signals before the
+// process dies. One logger at a time; null uninstalls.
+void FlushOnCrash(Logger* logger);
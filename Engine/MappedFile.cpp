@@ -0,0 +1,59 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(std::filesystem::path const& path) {
+   auto fail = [this, &path](char const* what) {
+      if (mapping_) CloseHandle(mapping_);
+      if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+      throw std::runtime_error(what + path.string());
+   };
+   file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (file_ == INVALID_HANDLE_VALUE) fail("Cannot open ");
+   LARGE_INTEGER size;
+   if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) fail("Cannot map an empty file ");
+   mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   if (!mapping_) fail("Cannot map ");
+   data_ = static_cast<std::uint8_t const*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+   if (!data_) fail("Cannot map ");
+   size_ = std::size_t(size.QuadPart);
+}
+
+MappedFile::~MappedFile() {
+   UnmapViewOfFile(data_);
+   CloseHandle(mapping_);
+   CloseHandle(file_);
+}
+#else
+MappedFile::MappedFile(std::filesystem::path const& path) {
+   auto descriptor = open(path.c_str(), O_RDONLY);
+   if (descriptor < 0) throw std::runtime_error("Cannot open " + path.string());
+   struct stat status;
+   if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+      close(descriptor);
+      throw std::runtime_error("Cannot map an empty file " + path.string());
+   }
+   auto data = mmap(nullptr, std::size_t(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+   // the mapping keeps the file
+   close(descriptor);
+   if (data == MAP_FAILED) throw std::runtime_error("Cannot map " + path.string());
+   data_ = static_cast<std::uint8_t const*>(data);
+   size_ = std::size_t(status.st_size);
+}
+
+MappedFile::~MappedFile() {
+   munmap(const_cast<std::uint8_t*>(data_), size_);
+}
+#endif
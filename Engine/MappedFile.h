@@ -0,0 +1,32 @@
+#pragma once
+//
+// MappedFile.h
+// A read-only view of a whole file through the page cache: nothing is read
+// until it is touched, and nothing is copied.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+class MappedFile {
+public:
+   // Throws std::runtime_error if the file cannot be opened or mapped, or is
+   // empty.
+   explicit MappedFile(std::filesystem::path const& path);
+   ~MappedFile();
+
+   MappedFile(MappedFile const&) = delete;
+   MappedFile& operator=(MappedFile const&) = delete;
+
+   std::span<std::uint8_t const> Bytes() const { return { data_, size_ }; }
+
+private:
+   std::uint8_t const* data_ = nullptr;
+   std::size_t size_ = 0;
+#ifdef _WIN32
+   void* file_ = nullptr;
+   void* mapping_ = nullptr;
+#endif
+};
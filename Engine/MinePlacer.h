@@ -0,0 +1,28 @@
+#pragma once
+//
+// MinePlacer.h
+// Uniform choice of the mined cells in time linear in the mine count.
+//
+
+#include <cstdint>
+
+#include "Random.h"
+
+// Cells kept free of mines around the first click.
+enum class SafeZone {
+   Cell,  // the clicked cell only
+   Block, // the clicked cell and its neighbours, the 3x3 block on a classic board
+};
+
+// Chooses `count` distinct values uniformly from [0, total) and hands each
+// to `insert`, which adds it and returns false if it was already chosen.
+// This is Floyd's variant of the partial Fisher-Yates shuffle: exactly one
+// draw per value, so it always ends after `count` steps whatever the density,
+// and it needs no shuffle array since the caller's set (for mines, the board
+// itself) remembers what was chosen.
+template <typename Rng, typename Insert>
+void SampleDistinct(std::uint64_t total, std::uint64_t count, Rng& rng, Insert&& insert) {
+   for (auto j = total - count; j < total; j++) {
+      if (!insert(Bounded(rng, j + 1))) insert(j);
+   }
+}
@@ -0,0 +1,49 @@
+#include "NoGuess.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+NoGuessSearch::NoGuessSearch(BoardSize size, Pos first, std::uint64_t seed, std::size_t maxAttempts) :
+   size_(size),
+   first_(first),
+   seeds_(seed),
+   maxAttempts_(maxAttempts) {
+}
+
+bool NoGuessSearch::Step(std::size_t attempts) {
+   for (; attempts > 0 && !Done(); attempts--) {
+      auto candidate = seeds_();
+      result_.attempts++;
+      Board board(size_, NO_GUESS_ZONE, candidate);
+      if (SolvesWithoutGuess(board, first_)) result_.seed = candidate;
+   }
+   return Done();
+}
+
+NoGuessResult FindNoGuessSeed(BoardSize size, Pos first, std::uint64_t seed, std::size_t maxAttempts) {
+   NoGuessSearch search(size, first, seed, maxAttempts);
+   search.Step(maxAttempts);
+   return search.Result();
+}
+
+std::vector<NoGuessResult> FindNoGuessSeeds(BoardSize size, Pos first, std::uint64_t seed, std::size_t count,
+   unsigned threads, std::size_t maxAttempts) {
+   std::vector<NoGuessResult> results(count);
+   if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+   // boards are handed out one at a time, since search lengths vary a lot
+   std::atomic<std::size_t> next = 0;
+   auto work = [&] {
+      for (auto i = next++; i < count; i = next++) {
+         results[i] = FindNoGuessSeed(size, first, SplitMix64(seed + i)(), maxAttempts);
+      }
+   };
+   std::vector<std::thread> pool;
+   for (unsigned thread = 1; thread < threads; thread++) {
+      pool.emplace_back(work);
+   }
+   work();
+   for (auto& thread : pool) thread.join();
+   return results;
+}
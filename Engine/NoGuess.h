@@ -0,0 +1,72 @@
+#pragma once
+//
+// NoGuess.h
+// Boards that can be finished by logic alone from a given first click.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Board.h"
+#include "Solver.h"
+
+// No-guess boards keep the whole 3x3 block around the first click free, so the
+// first click always opens an area to reason from.
+auto constexpr NO_GUESS_ZONE = SafeZone::Block;
+auto constexpr NO_GUESS_ATTEMPTS = std::size_t(1) << 20;
+
+// Plays `board` from `first`, opening only what the solver proves safe, and
+// says whether that wins.
+template <typename Store>
+bool SolvesWithoutGuess(BasicBoard<Store>& board, Pos first) {
+   board.Click(first.x, first.y);
+   BasicSolver<Store> solver(board);
+   while (board.State() == GameState::Play) {
+      auto result = solver.Solve();
+      if (result.safe.empty()) return false;
+      for (auto pos : result.safe) {
+         if (!board.At(pos.x, pos.y).IsOpened()) solver.Update(board.Click(pos.x, pos.y).changed);
+      }
+   }
+   return board.State() == GameState::Win;
+}
+
+struct NoGuessResult {
+   std::optional<std::uint64_t> seed; // missing if no attempt succeeded
+   std::size_t attempts = 0;
+};
+
+// FindNoGuessSeed a few attempts at a time, so a worker can search between
+// other jobs and drop a search the first click no longer needs.
+class NoGuessSearch {
+public:
+   NoGuessSearch(BoardSize size, Pos first, std::uint64_t seed, std::size_t maxAttempts = NO_GUESS_ATTEMPTS);
+
+   // Tries up to `attempts` more boards and says whether the search is over,
+   // found or given up.
+   bool Step(std::size_t attempts);
+   bool Done() const { return result_.seed || result_.attempts >= maxAttempts_; }
+
+   BoardSize Size() const { return size_; }
+   Pos First() const { return first_; }
+   NoGuessResult const& Result() const { return result_; }
+
+private:
+   BoardSize size_;
+   Pos first_;
+   SplitMix64 seeds_;
+   std::size_t maxAttempts_;
+   NoGuessResult result_;
+};
+
+// Tries the boards of a seed sequence starting from `seed` until one needs no
+// guess. The board is then Board(size, NO_GUESS_ZONE, *result.seed), so a
+// no-guess game is as reproducible as any other.
+NoGuessResult FindNoGuessSeed(BoardSize size, Pos first, std::uint64_t seed, std::size_t maxAttempts = NO_GUESS_ATTEMPTS);
+
+// FindNoGuessSeed for `count` boards on all threads. Board i always searches
+// from the same seed, so the result does not depend on the thread count.
+std::vector<NoGuessResult> FindNoGuessSeeds(BoardSize size, Pos first, std::uint64_t seed, std::size_t count,
+   unsigned threads = 0, std::size_t maxAttempts = NO_GUESS_ATTEMPTS);
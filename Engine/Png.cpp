@@ -0,0 +1,143 @@
+#include "Png.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "Inflate.h"
+
+namespace {
+   std::uint8_t constexpr SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+   // the gAMA chunk's 1/2.2, in units of 1/100000
+   auto constexpr SRGB_GAMMA = 45455u;
+
+   enum ColorType : std::uint8_t {
+      Grey = 0,
+      Rgb = 2,
+      Palette = 3,
+      GreyAlpha = 4,
+      Rgba = 6,
+   };
+
+   std::uint32_t Read32(std::uint8_t const* at) {
+      return std::uint32_t(at[0]) << 24 | std::uint32_t(at[1]) << 16 | std::uint32_t(at[2]) << 8 | at[3];
+   }
+
+   int Channels(std::uint8_t colorType) {
+      switch (colorType) {
+      case Grey: return 1;
+      case Rgb: return 3;
+      case Palette: return 1;
+      case GreyAlpha: return 2;
+      case Rgba: return 4;
+      }
+      throw std::runtime_error("Bad PNG color type");
+   }
+
+   std::uint8_t Paeth(int a, int b, int c) {
+      auto p = a + b - c;
+      auto pa = std::abs(p - a);
+      auto pb = std::abs(p - b);
+      auto pc = std::abs(p - c);
+      if (pa <= pb && pa <= pc) return std::uint8_t(a);
+      return std::uint8_t(pb <= pc ? b : c);
+   }
+
+   // Undoes the per-row filters in place; each row keeps its filter byte.
+   void Unfilter(std::vector<std::uint8_t>& data, std::uint32_t height, std::size_t stride, int bpp) {
+      std::uint8_t const* previous = nullptr;
+      for (std::uint32_t y = 0; y < height; y++) {
+         auto row = data.data() + y * (stride + 1);
+         auto filter = row[0];
+         auto pixels = row + 1;
+         for (std::size_t x = 0; x < stride; x++) {
+            int left = x >= std::size_t(bpp) ? pixels[x - bpp] : 0;
+            int up = previous ? previous[x] : 0;
+            int upLeft = previous && x >= std::size_t(bpp) ? previous[x - bpp] : 0;
+            switch (filter) {
+            case 0: break;
+            case 1: pixels[x] = std::uint8_t(pixels[x] + left); break;
+            case 2: pixels[x] = std::uint8_t(pixels[x] + up); break;
+            case 3: pixels[x] = std::uint8_t(pixels[x] + (left + up) / 2); break;
+            case 4: pixels[x] = std::uint8_t(pixels[x] + Paeth(left, up, upLeft)); break;
+            default: throw std::runtime_error("Bad PNG row filter");
+            }
+         }
+         previous = pixels;
+      }
+   }
+}
+
+Image DecodePng(std::span<std::uint8_t const> file) {
+   if (file.size() < 8 || std::memcmp(file.data(), SIGNATURE, 8) != 0) throw std::runtime_error("Not a PNG file");
+
+   Image image;
+   std::uint8_t colorType = 0;
+   auto sawHeader = false;
+   auto sawSrgb = false;
+   auto gamma = 0u;
+   std::uint8_t palette[256][4] = {};
+   std::vector<std::uint8_t> compressed;
+   for (std::size_t at = 8; ; ) {
+      if (at + 12 > file.size()) throw std::runtime_error("PNG cut short");
+      auto length = std::size_t(Read32(&file[at]));
+      auto type = &file[at + 4];
+      auto body = &file[at + 8];
+      if (length > file.size() - at - 12) throw std::runtime_error("PNG cut short");
+      at += 12 + length;
+
+      if (std::memcmp(type, "IHDR", 4) == 0) {
+         if (length < 13) throw std::runtime_error("Bad PNG header");
+         image.width = Read32(body);
+         image.height = Read32(body + 4);
+         auto depth = body[8];
+         colorType = body[9];
+         Channels(colorType);
+         if (image.width == 0 || image.height == 0 || image.width > 1u << 16 || image.height > 1u << 16) {
+            throw std::runtime_error("Bad PNG size");
+         }
+         if (depth != 8 || body[12] != 0) throw std::runtime_error("Only 8-bit PNG files that are not interlaced are supported");
+         sawHeader = true;
+      }
+      else if (std::memcmp(type, "PLTE", 4) == 0) {
+         for (std::size_t i = 0; i < length / 3 && i < 256; i++) {
+            palette[i][0] = body[i * 3];
+            palette[i][1] = body[i * 3 + 1];
+            palette[i][2] = body[i * 3 + 2];
+            palette[i][3] = 255;
+         }
+      }
+      else if (std::memcmp(type, "tRNS", 4) == 0 && colorType == Palette) {
+         for (std::size_t i = 0; i < length && i < 256; i++) palette[i][3] = body[i];
+      }
+      else if (std::memcmp(type, "sRGB", 4) == 0) sawSrgb = true;
+      else if (std::memcmp(type, "gAMA", 4) == 0 && length >= 4) gamma = Read32(body);
+      else if (std::memcmp(type, "IDAT", 4) == 0) compressed.insert(compressed.end(), body, body + length);
+      else if (std::memcmp(type, "IEND", 4) == 0) break;
+   }
+   if (!sawHeader) throw std::runtime_error("PNG without a header");
+   image.srgb = sawSrgb || gamma == SRGB_GAMMA;
+
+   auto channels = Channels(colorType);
+   auto stride = std::size_t(image.width) * channels;
+   auto data = Inflate(compressed, (stride + 1) * image.height);
+   if (data.size() < (stride + 1) * image.height) throw std::runtime_error("PNG image data cut short");
+   Unfilter(data, image.height, stride, channels);
+
+   image.pixels.resize(std::size_t(image.width) * image.height * 4);
+   auto out = image.pixels.data();
+   for (std::uint32_t y = 0; y < image.height; y++) {
+      auto row = data.data() + y * (stride + 1) + 1;
+      for (std::uint32_t x = 0; x < image.width; x++, out += 4) {
+         auto pixel = row + std::size_t(x) * channels;
+         switch (colorType) {
+         case Grey: out[0] = out[1] = out[2] = pixel[0]; out[3] = 255; break;
+         case GreyAlpha: out[0] = out[1] = out[2] = pixel[0]; out[3] = pixel[1]; break;
+         case Rgb: std::memcpy(out, pixel, 3); out[3] = 255; break;
+         case Rgba: std::memcpy(out, pixel, 4); break;
+         case Palette: std::memcpy(out, palette[pixel[0]], 4); break;
+         }
+      }
+   }
+   return image;
+}
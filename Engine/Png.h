@@ -0,0 +1,25 @@
+#pragma once
+//
+// Png.h
+// Decodes PNG files to 8-bit RGBA without an imaging library, for the asset
+// cooker and the tools that check its output.
+//
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct Image {
+   std::uint32_t width = 0;
+   std::uint32_t height = 0;
+   // the file asks for sRGB, by an sRGB chunk or a gamma of 1/2.2, which
+   // is how WIC picks between UNORM and UNORM_SRGB textures
+   bool srgb = false;
+   // rows top down, four bytes a pixel
+   std::vector<std::uint8_t> pixels;
+};
+
+// Grey, grey with alpha, RGB, RGBA and palette images of 8 bits a channel,
+// not interlaced; chunk CRCs are not checked, the image data's checksum is.
+// Throws std::runtime_error for anything else or a broken file.
+Image DecodePng(std::span<std::uint8_t const> file);
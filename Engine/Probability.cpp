@@ -0,0 +1,580 @@
+#include "Probability.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace {
+   // The exact combination keeps an array per component as long as the
+   // frontier can hold mines, and fills each in time linear in the frontier.
+   // Past these sizes it takes the mean-field weights instead, which are
+   // exact in the limit of a large interior.
+   auto constexpr EXACT_COMBINE_ENTRIES = std::size_t(1) << 22;
+   auto constexpr EXACT_COMBINE_STEPS = std::size_t(1) << 28;
+
+   auto constexpr NO_WAY = -std::numeric_limits<double>::infinity();
+
+   // A connected part of the frontier. Cells are in search order, each
+   // neighbour's cell comes soon after it, so the numbers fill up early and
+   // cut dead branches short.
+   struct Component {
+      std::vector<Pos> cells;
+      std::vector<int> numberStart; // per cell, into numberIds; one extra at the end
+      std::vector<int> numberIds;
+      std::vector<int> need;        // per number: mines still missing around it
+      std::vector<int> free;        // per number: unknown cells around it
+
+      // by mine count, all up to one common factor
+      std::vector<double> ways;
+      std::vector<double> cellWays; // exact only, [k * cells + i]
+      // by mine count: ways to place the remaining mines elsewhere
+      std::vector<double> weight;
+      bool sampled = false;
+
+      std::size_t Size() const { return cells.size(); }
+   };
+
+   // Assignments walk the cells in order, keeping for every number the mines
+   // still needed and the cells still unassigned.
+   struct Assignment {
+      Component const& component;
+      std::vector<int> need;
+      std::vector<int> free;
+      std::vector<char> mined;
+      int mines = 0;
+
+      explicit Assignment(Component const& component) :
+         component(component),
+         need(component.need),
+         free(component.free),
+         mined(component.Size(), 0) {
+      }
+
+      void Reset() {
+         need = component.need;
+         free = component.free;
+         mines = 0;
+      }
+
+      bool Fits(std::size_t cell, int value) const {
+         for (auto i = component.numberStart[cell]; i < component.numberStart[cell + 1]; i++) {
+            auto number = component.numberIds[i];
+            auto left = need[number] - value;
+            if (left < 0 || left > free[number] - 1) return false;
+         }
+         return true;
+      }
+
+      void Set(std::size_t cell, int value) {
+         for (auto i = component.numberStart[cell]; i < component.numberStart[cell + 1]; i++) {
+            need[component.numberIds[i]] -= value;
+            free[component.numberIds[i]]--;
+         }
+         mined[cell] = char(value);
+         mines += value;
+      }
+
+      void Unset(std::size_t cell) {
+         auto value = int(mined[cell]);
+         for (auto i = component.numberStart[cell]; i < component.numberStart[cell + 1]; i++) {
+            need[component.numberIds[i]] += value;
+            free[component.numberIds[i]]++;
+         }
+         mines -= value;
+      }
+   };
+
+   struct Enumeration {
+      Component& component;
+      Assignment assignment;
+      std::size_t nodes = 0;
+      std::size_t limit;
+
+      Enumeration(Component& component, std::size_t limit) :
+         component(component),
+         assignment(component),
+         limit(limit) {
+      }
+
+      bool Visit(std::size_t cell) {
+         if (++nodes > limit) return false;
+         auto size = component.Size();
+         if (cell == size) {
+            auto k = std::size_t(assignment.mines);
+            component.ways[k]++;
+            for (std::size_t i = 0; i < size; i++) {
+               if (assignment.mined[i]) component.cellWays[k * size + i]++;
+            }
+            return true;
+         }
+         for (auto value = 0; value <= 1; value++) {
+            if (!assignment.Fits(cell, value)) continue;
+            assignment.Set(cell, value);
+            auto finished = Visit(cell + 1);
+            assignment.Unset(cell);
+            if (!finished) return false;
+         }
+         return true;
+      }
+   };
+
+   // Counts every solution by mine number; false if the search ran over its budget.
+   bool Enumerate(Component& component, std::size_t nodeLimit) {
+      auto size = component.Size();
+      component.ways.assign(size + 1, 0.0);
+      component.cellWays.assign((size + 1) * size, 0.0);
+      Enumeration enumeration(component, nodeLimit);
+      return enumeration.Visit(0);
+   }
+
+   // One random root-to-leaf walk through the search tree, taking a uniform
+   // choice among the values that fit. Its weight, the product of the choice
+   // counts, is an unbiased estimate of the number of solutions (Knuth, 1975).
+   // Returns the log weight, or NO_WAY on a dead end.
+   double Walk(Assignment& assignment, Xoshiro256& rng) {
+      assignment.Reset();
+      auto logWeight = 0.0;
+      for (std::size_t cell = 0; cell < assignment.component.Size(); cell++) {
+         auto clear = assignment.Fits(cell, 0);
+         auto mine = assignment.Fits(cell, 1);
+         if (!clear && !mine) return NO_WAY;
+         auto value = clear && mine ? int(rng() >> 63) : mine ? 1 : 0;
+         if (clear && mine) logWeight += std::log(2.0);
+         assignment.Set(cell, value);
+      }
+      return logWeight;
+   }
+
+   // Sums of exp(log weight) that stay in range: everything is kept relative
+   // to the largest log weight seen so far.
+   struct ScaledSums {
+      double scale = NO_WAY;
+      std::vector<double> sums;
+
+      explicit ScaledSums(std::size_t size) : sums(size, 0.0) {}
+
+      // factor for adding a value with this log weight
+      double Factor(double logWeight) {
+         if (logWeight > scale) {
+            if (scale != NO_WAY) {
+               auto shrink = std::exp(scale - logWeight);
+               for (auto& sum : sums) sum *= shrink;
+            }
+            scale = logWeight;
+         }
+         return std::exp(logWeight - scale);
+      }
+
+      static std::vector<double> Merge(std::vector<ScaledSums> const& parts) {
+         auto scale = NO_WAY;
+         for (auto& part : parts) scale = std::max(scale, part.scale);
+         std::vector<double> total(parts.front().sums.size(), 0.0);
+         if (scale == NO_WAY) return total;
+         for (auto& part : parts) {
+            if (part.scale == NO_WAY) continue;
+            auto factor = std::exp(part.scale - scale);
+            for (std::size_t i = 0; i < total.size(); i++) total[i] += part.sums[i] * factor;
+         }
+         return total;
+      }
+   };
+
+   // Workers for the sampled components, started on first use and kept for
+   // every later grid.
+   TaskPool& SharedPool() {
+      static TaskPool pool;
+      return pool;
+   }
+
+   // Runs work(part) for every part on the pool, the caller included; a
+   // single part stays on the caller.
+   template <typename Work>
+   void Parallel(TaskPool* pool, unsigned parts, Work const& work) {
+      if (parts <= 1) return work(0u);
+      ParallelFor(*pool, parts, 1, [&work](std::size_t begin, std::size_t end) {
+         for (auto part = begin; part < end; part++) work(unsigned(part));
+         });
+   }
+
+   std::uint64_t WalkSeed(ProbabilityOptions const& options, std::size_t component, unsigned thread, int pass) {
+      return options.seed ^ (std::uint64_t(component) << 20) ^ (std::uint64_t(thread) << 4) ^ std::uint64_t(pass);
+   }
+
+   // Estimated solution counts by mine number.
+   void SampleWays(Component& component, std::size_t index, ProbabilityOptions const& options, TaskPool* pool, unsigned threads) {
+      auto size = component.Size();
+      std::vector<ScaledSums> parts(threads, ScaledSums(size + 1));
+      Parallel(pool, threads, [&](unsigned thread) {
+         Xoshiro256 rng(WalkSeed(options, index, thread, 0));
+         Assignment assignment(component);
+         auto& part = parts[thread];
+         for (auto walk = thread; walk < options.samples; walk += threads) {
+            auto logWeight = Walk(assignment, rng);
+            if (logWeight == NO_WAY) continue;
+            part.sums[assignment.mines] += part.Factor(logWeight);
+         }
+         });
+      component.ways = ScaledSums::Merge(parts);
+   }
+
+   // Mine chance of each cell of a sampled component, from fresh walks
+   // weighted by the ways to place the other mines.
+   std::vector<double> SampleCells(Component const& component, std::size_t index, ProbabilityOptions const& options, TaskPool* pool, unsigned threads) {
+      auto size = component.Size();
+      // the last entry holds the total weight
+      std::vector<ScaledSums> parts(threads, ScaledSums(size + 1));
+      Parallel(pool, threads, [&](unsigned thread) {
+         Xoshiro256 rng(WalkSeed(options, index, thread, 1));
+         Assignment assignment(component);
+         auto& part = parts[thread];
+         for (auto walk = thread; walk < options.samples; walk += threads) {
+            auto logWeight = Walk(assignment, rng);
+            if (logWeight == NO_WAY || component.weight[assignment.mines] == 0) continue;
+            auto add = part.Factor(logWeight + std::log(component.weight[assignment.mines]));
+            for (std::size_t i = 0; i < size; i++) {
+               if (assignment.mined[i]) part.sums[i] += add;
+            }
+            part.sums[size] += add;
+         }
+         });
+      auto sums = ScaledSums::Merge(parts);
+      std::vector<double> chance(size, 0.0);
+      if (sums[size] > 0) {
+         for (std::size_t i = 0; i < size; i++) chance[i] = sums[i] / sums[size];
+      }
+      return chance;
+   }
+
+   void Normalize(std::vector<double>& values) {
+      auto top = *std::max_element(values.begin(), values.end());
+      if (top <= 0) return;
+      for (auto& value : values) value /= top;
+   }
+
+   double LogChoose(std::int64_t n, std::int64_t k) {
+      if (k < 0 || k > n) return NO_WAY;
+      return std::lgamma(double(n) + 1) - std::lgamma(double(k) + 1) - std::lgamma(double(n - k) + 1);
+   }
+
+   // Ways to spread `minesLeft - k` mines over the interior for every k the
+   // frontier can take, relative to the largest.
+   std::vector<double> InteriorWays(std::size_t interior, std::int64_t minesLeft, std::size_t frontierCells) {
+      std::vector<double> logWays(frontierCells + 1);
+      auto top = NO_WAY;
+      for (std::size_t k = 0; k <= frontierCells; k++) {
+         logWays[k] = LogChoose(std::int64_t(interior), minesLeft - std::int64_t(k));
+         top = std::max(top, logWays[k]);
+      }
+      std::vector<double> ways(frontierCells + 1, 0.0);
+      if (top == NO_WAY) return ways;
+      for (std::size_t k = 0; k <= frontierCells; k++) {
+         ways[k] = std::exp(logWays[k] - top);
+      }
+      return ways;
+   }
+
+   // Exact weights: with F the ways for the components before this one and
+   // R the ways for those after it together with the interior,
+   //    weight[k] = sum over s of F[s] * R[s + k].
+   // Returns the interior mine chance.
+   double CombineExact(std::vector<Component>& components, std::size_t interior, std::int64_t minesLeft, std::size_t frontierCells) {
+      auto count = components.size();
+      auto span = frontierCells + 1;
+      auto interiorWays = InteriorWays(interior, minesLeft, frontierCells);
+
+      // after[c][s]: ways for components c.. and the interior when s mines are already used
+      std::vector<std::vector<double>> after(count + 1);
+      after[count] = interiorWays;
+      for (auto c = count; c-- > 0;) {
+         auto& ways = components[c].ways;
+         auto& next = after[c + 1];
+         auto& current = after[c];
+         current.assign(span, 0.0);
+         for (std::size_t s = 0; s < span; s++) {
+            for (std::size_t k = 0; k < ways.size() && s + k < span; k++) {
+               current[s] += ways[k] * next[s + k];
+            }
+         }
+         Normalize(current);
+      }
+
+      std::vector<double> before(span, 0.0);
+      before[0] = 1;
+      for (std::size_t c = 0; c < count; c++) {
+         auto& component = components[c];
+         auto& next = after[c + 1];
+         component.weight.assign(component.ways.size(), 0.0);
+         for (std::size_t k = 0; k < component.weight.size(); k++) {
+            for (std::size_t s = 0; s + k < span; s++) {
+               component.weight[k] += before[s] * next[s + k];
+            }
+         }
+         Normalize(component.weight);
+
+         std::vector<double> grown(span, 0.0);
+         for (std::size_t s = 0; s < span; s++) {
+            if (before[s] == 0) continue;
+            for (std::size_t k = 0; k < component.ways.size() && s + k < span; k++) {
+               grown[s + k] += before[s] * component.ways[k];
+            }
+         }
+         Normalize(grown);
+         before = std::move(grown);
+         std::vector<double>().swap(after[c + 1]);
+      }
+
+      if (interior == 0) return 0;
+      auto total = 0.0;
+      auto mined = 0.0;
+      for (std::size_t k = 0; k < span; k++) {
+         auto ways = before[k] * interiorWays[k];
+         total += ways;
+         mined += ways * double(minesLeft - std::int64_t(k));
+      }
+      return total > 0 ? mined / total / double(interior) : 0;
+   }
+
+   // Mean-field weights for huge frontiers: with the interior density p, one
+   // more mine on the frontier costs a factor of p / (1 - p) in interior ways.
+   // p is found by fixed-point iteration on the expected frontier mines.
+   double CombineMeanField(std::vector<Component>& components, std::size_t interior, std::int64_t minesLeft, std::size_t frontierCells) {
+      auto density = double(minesLeft) / double(interior + frontierCells);
+      for (auto round = 0; round < 32; round++) {
+         auto clamped = std::clamp(density, 1e-9, 1 - 1e-9);
+         auto logRatio = interior > 0 ? std::log(clamped / (1 - clamped)) : 0.0;
+         auto expected = 0.0;
+         for (auto& component : components) {
+            auto& ways = component.ways;
+            component.weight.resize(ways.size());
+            auto top = NO_WAY;
+            for (std::size_t k = 0; k < ways.size(); k++) {
+               if (ways[k] > 0) top = std::max(top, k * logRatio);
+            }
+            auto total = 0.0;
+            auto mines = 0.0;
+            for (std::size_t k = 0; k < ways.size(); k++) {
+               // counts with no way could overflow the scale, which is set by live ones only
+               component.weight[k] = ways[k] > 0 ? std::exp(k * logRatio - top) : 0.0;
+               total += ways[k] * component.weight[k];
+               mines += ways[k] * component.weight[k] * k;
+            }
+            expected += total > 0 ? mines / total : 0;
+         }
+         if (interior == 0) return 0;
+         density = (double(minesLeft) - expected) / double(interior);
+      }
+      return std::clamp(density, 0.0, 1.0);
+   }
+
+   struct DisjointSets {
+      std::vector<int> parent;
+
+      explicit DisjointSets(std::size_t size) : parent(size) {
+         for (std::size_t i = 0; i < size; i++) parent[i] = int(i);
+      }
+
+      int Find(int i) {
+         while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+         }
+         return i;
+      }
+
+      void Join(int a, int b) {
+         parent[Find(a)] = Find(b);
+      }
+   };
+
+   // An opened number and the frontier cells around it.
+   struct Number {
+      std::array<int, 8> cells;
+      int count;
+      int need;
+   };
+
+   // Splits the frontier into components, cells in breadth-first order.
+   std::vector<Component> BuildComponents(std::vector<Pos> const& frontier, std::vector<Number> const& numbers) {
+      auto size = frontier.size();
+      std::vector<int> start(size + 1, 0);
+      for (auto& number : numbers) {
+         for (auto i = 0; i < number.count; i++) start[number.cells[i] + 1]++;
+      }
+      for (std::size_t i = 0; i < size; i++) start[i + 1] += start[i];
+      std::vector<int> numbersOf(start.back());
+      auto fill = start;
+      DisjointSets sets(size);
+      for (std::size_t n = 0; n < numbers.size(); n++) {
+         auto& number = numbers[n];
+         for (auto i = 0; i < number.count; i++) {
+            numbersOf[fill[number.cells[i]]++] = int(n);
+            sets.Join(number.cells[0], number.cells[i]);
+         }
+      }
+
+      std::vector<Component> components;
+      std::vector<int> componentOf(size, -1);
+      std::vector<int> localCell(size, -1);
+      std::vector<int> localNumber(numbers.size(), -1);
+      std::vector<int> queue;
+      for (std::size_t first = 0; first < size; first++) {
+         if (localCell[first] >= 0) continue;
+         auto& component = components.emplace_back();
+         queue.assign(1, int(first));
+         localCell[first] = 0;
+         for (std::size_t head = 0; head < queue.size(); head++) {
+            auto cell = queue[head];
+            component.cells.push_back(frontier[cell]);
+            component.numberStart.push_back(int(component.numberIds.size()));
+            for (auto i = start[cell]; i < start[cell + 1]; i++) {
+               auto n = numbersOf[i];
+               auto& number = numbers[n];
+               if (localNumber[n] < 0) {
+                  localNumber[n] = int(component.need.size());
+                  component.need.push_back(number.need);
+                  component.free.push_back(number.count);
+               }
+               component.numberIds.push_back(localNumber[n]);
+               for (auto j = 0; j < number.count; j++) {
+                  auto other = number.cells[j];
+                  if (localCell[other] >= 0) continue;
+                  localCell[other] = int(queue.size());
+                  queue.push_back(other);
+               }
+            }
+         }
+         component.numberStart.push_back(int(component.numberIds.size()));
+      }
+      return components;
+   }
+}
+
+template <typename Store>
+ProbabilityGrid MineProbabilities(BasicBoard<Store> const& board, BasicSolver<Store> const& solver, ProbabilityOptions const& options) {
+   ProbabilityGrid grid;
+   grid.width = board.Width();
+   grid.height = board.Height();
+   grid.mine.assign(std::size_t(grid.width) * grid.height, 0.0f);
+
+   auto isNumber = [&board](int x, int y) {
+      auto cell = board.At(x, y);
+      return cell.IsOpened() && !cell.IsMined() && cell.MinesNear() > 0;
+   };
+   // mines the player knows of: proven ones and the one that ended the game
+   auto isMine = [&board, &solver](int x, int y) {
+      auto cell = board.At(x, y);
+      return cell.IsOpened() ? cell.IsMined() : solver.At(x, y) == Knowledge::Mine;
+   };
+
+   // known cells first
+   auto minesLeft = std::int64_t(board.Mines());
+   std::vector<char> unknown(grid.mine.size(), 0);
+   auto unknownCount = std::size_t(0);
+   for (auto y = 0; y < grid.height; y++) {
+      for (auto x = 0; x < grid.width; x++) {
+         auto at = std::size_t(y) * grid.width + x;
+         if (isMine(x, y)) {
+            grid.mine[at] = 1;
+            minesLeft--;
+         }
+         else if (!board.At(x, y).IsOpened() && solver.At(x, y) == Knowledge::Unknown) {
+            unknown[at] = 1;
+            unknownCount++;
+         }
+      }
+   }
+
+   // then the numbers, which give their unknown neighbours frontier ids
+   std::vector<int> frontierId(grid.mine.size(), -1);
+   std::vector<Pos> frontier;
+   std::vector<Number> numbers;
+   for (auto y = 0; y < grid.height; y++) {
+      for (auto x = 0; x < grid.width; x++) {
+         if (!isNumber(x, y)) continue;
+         Number number = { {}, 0, board.At(x, y).MinesNear() };
+         for (auto nearY = std::max(0, y - 1); nearY <= std::min(grid.height - 1, y + 1); nearY++) {
+            for (auto nearX = std::max(0, x - 1); nearX <= std::min(grid.width - 1, x + 1); nearX++) {
+               auto at = std::size_t(nearY) * grid.width + nearX;
+               if (unknown[at]) {
+                  if (frontierId[at] < 0) {
+                     frontierId[at] = int(frontier.size());
+                     frontier.push_back({ nearX, nearY });
+                  }
+                  number.cells[number.count++] = frontierId[at];
+               }
+               else if (grid.mine[at] == 1) {
+                  number.need--;
+               }
+            }
+         }
+         if (number.count > 0) numbers.push_back(number);
+      }
+   }
+   grid.frontier = frontier.size();
+   grid.interior = unknownCount - frontier.size();
+
+   auto components = BuildComponents(frontier, numbers);
+   grid.components = components.size();
+   // a single thread needs no pool
+   auto pool = options.pool;
+   if (!pool && options.threads != 1) pool = &SharedPool();
+   auto threads = options.threads ? options.threads : pool->Threads();
+   for (std::size_t c = 0; c < components.size(); c++) {
+      auto& component = components[c];
+      if (component.Size() <= options.exactCells && Enumerate(component, options.exactNodes)) {
+         // one factor for both keeps their ratios
+         auto top = *std::max_element(component.ways.begin(), component.ways.end());
+         if (top > 0) {
+            for (auto& ways : component.ways) ways /= top;
+            for (auto& ways : component.cellWays) ways /= top;
+         }
+         continue;
+      }
+      component.sampled = true;
+      component.cellWays.clear();
+      grid.sampled++;
+      SampleWays(component, c, options, pool, threads);
+      Normalize(component.ways);
+   }
+
+   auto span = frontier.size() + 1;
+   auto exact = components.size() * span <= EXACT_COMBINE_ENTRIES && span * (span + components.size()) <= EXACT_COMBINE_STEPS;
+   grid.interiorMine = exact ?
+      CombineExact(components, grid.interior, minesLeft, frontier.size()) :
+      CombineMeanField(components, grid.interior, minesLeft, frontier.size());
+
+   for (std::size_t c = 0; c < components.size(); c++) {
+      auto& component = components[c];
+      auto size = component.Size();
+      std::vector<double> chance;
+      if (component.sampled) {
+         chance = SampleCells(component, c, options, pool, threads);
+      }
+      else {
+         chance.assign(size, 0.0);
+         auto total = 0.0;
+         for (std::size_t k = 0; k <= size; k++) {
+            total += component.ways[k] * component.weight[k];
+            for (std::size_t i = 0; i < size; i++) {
+               chance[i] += component.cellWays[k * size + i] * component.weight[k];
+            }
+         }
+         if (total > 0) {
+            for (auto& value : chance) value /= total;
+         }
+      }
+      for (std::size_t i = 0; i < size; i++) {
+         auto pos = component.cells[i];
+         grid.mine[std::size_t(pos.y) * grid.width + pos.x] = float(chance[i]);
+      }
+   }
+
+   for (std::size_t at = 0; at < grid.mine.size(); at++) {
+      if (unknown[at] && frontierId[at] < 0) grid.mine[at] = float(grid.interiorMine);
+   }
+   return grid;
+}
+
+template ProbabilityGrid MineProbabilities(BasicBoard<CellStore> const&, BasicSolver<CellStore> const&, ProbabilityOptions const&);
+template ProbabilityGrid MineProbabilities(BasicBoard<BitStore> const&, BasicSolver<BitStore> const&, ProbabilityOptions const&);
@@ -0,0 +1,54 @@
+#pragma once
+//
+// Probability.h
+// Chance of a mine under every covered cell, given what a player can see.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Board.h"
+#include "Solver.h"
+#include "TaskPool.h"
+
+struct ProbabilityOptions {
+   // Components up to this many cells are enumerated exactly, unless the
+   // search visits more than `exactNodes` nodes; larger ones are sampled.
+   std::size_t exactCells = 64;
+   std::size_t exactNodes = 1 << 22;
+   // Random walks per sampled component and pass, split into `threads`
+   // parts that run on `pool`.
+   std::size_t samples = 1 << 16;
+   unsigned threads = 0; // 0 for one per worker of the pool
+   TaskPool* pool = nullptr; // null for one shared by every call
+   std::uint64_t seed = 1;
+};
+
+struct ProbabilityGrid {
+   int width = 0;
+   int height = 0;
+   std::vector<float> mine; // row-major; 0 on opened cells, 1 on proven mines
+
+   // covered unknown cells next to a number, and the rest of them
+   std::size_t frontier = 0;
+   std::size_t interior = 0;
+   std::size_t components = 0;
+   std::size_t sampled = 0;
+   // the same mine chance for every interior cell
+   double interiorMine = 0;
+
+   float At(int x, int y) const { return mine[std::size_t(y) * width + x]; }
+};
+
+// The covered cells the solver could not settle split into the frontier,
+// which touches a number, and the interior, which does not. Frontier cells
+// linked through shared numbers form independent components; each is counted
+// exactly by a backtracking search, or estimated with Knuth's random-walk
+// estimator when too large. The counts by mine number are then combined with
+// the binomial count of ways to spread the remaining mines over the interior.
+//
+// Pass a solver that has been brought up to date with Solve: proven cells are
+// taken as known and the remaining mines are the board total less the proven ones.
+template <typename Store>
+ProbabilityGrid MineProbabilities(BasicBoard<Store> const& board, BasicSolver<Store> const& solver, ProbabilityOptions const& options = {});
@@ -0,0 +1,105 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+namespace {
+   // Rings live until exit, so a trace written at the end still holds the
+   // events of threads that are gone.
+   struct Registry {
+      std::mutex mutex;
+      std::vector<std::unique_ptr<Profile::EventRing>> rings;
+   };
+
+   Registry& Rings() {
+      static Registry registry;
+      return registry;
+   }
+
+   void WriteName(std::ostream& out, char const* name) {
+      out << '"';
+      for (auto c = name; *c; c++) {
+         if (*c == '"' || *c == '\\') out << '\\';
+         out << *c;
+      }
+      out << '"';
+   }
+
+   // Chrome traces count in microseconds.
+   void WriteMicroseconds(std::ostream& out, std::int64_t nanoseconds) {
+      out << nanoseconds / 1000 << '.';
+      auto fraction = nanoseconds % 1000;
+      out << char('0' + fraction / 100) << char('0' + fraction / 10 % 10) << char('0' + fraction % 10);
+   }
+}
+
+namespace Profile {
+   std::vector<Event> EventRing::Snapshot() const {
+      auto end = written_.load(std::memory_order_acquire);
+      auto begin = end > CAPACITY ? end - CAPACITY : 0;
+      std::vector<Event> events;
+      events.reserve(end - begin);
+      for (auto i = begin; i < end; i++) events.push_back(events_[i & (CAPACITY - 1)]);
+
+      auto after = written_.load(std::memory_order_acquire);
+      auto kept = after > CAPACITY ? after - CAPACITY : 0;
+      if (kept > begin) events.erase(events.begin(), events.begin() + std::min(kept - begin, events.size()));
+      return events;
+   }
+
+   std::size_t EventRing::Dropped() const {
+      auto written = written_.load(std::memory_order_acquire);
+      return written > CAPACITY ? written - CAPACITY : 0;
+   }
+
+   Clock::time_point Epoch() {
+      static auto const epoch = Clock::now();
+      return epoch;
+   }
+
+   EventRing& RegisterThread() {
+      Epoch();
+      auto& registry = Rings();
+      std::lock_guard lock(registry.mutex);
+      registry.rings.push_back(std::make_unique<EventRing>(std::uint32_t(registry.rings.size() + 1)));
+      return *registry.rings.back();
+   }
+
+   TraceStats WriteChromeTrace(std::ostream& out) {
+      auto& registry = Rings();
+      std::lock_guard lock(registry.mutex);
+      TraceStats stats = { registry.rings.size(), 0, 0 };
+      auto first = true;
+      out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+      for (auto& ring : registry.rings) {
+         stats.dropped += ring->Dropped();
+         for (auto& event : ring->Snapshot()) {
+            out << (first ? "\n" : ",\n");
+            first = false;
+            out << "{\"name\":";
+            WriteName(out, event.name);
+            out << ",\"pid\":1,\"tid\":" << ring->Thread() << ",\"ts\":";
+            WriteMicroseconds(out, event.start);
+            if (event.kind == EventKind::Scope) {
+               out << ",\"ph\":\"X\",\"dur\":";
+               WriteMicroseconds(out, event.value);
+               out << '}';
+            }
+            else {
+               out << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value << "}}";
+            }
+            stats.events++;
+         }
+      }
+      out << "\n]}\n";
+      return stats;
+   }
+
+   void Reset() {
+      auto& registry = Rings();
+      std::lock_guard lock(registry.mutex);
+      for (auto& ring : registry.rings) ring->Clear();
+   }
+}
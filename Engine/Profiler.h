@@ -0,0 +1,116 @@
+#pragma once
+//
+// Profiler.h
+// Scoped timers and counters recorded into a lock-free ring per thread, and
+// written out as a Chrome trace (chrome://tracing, Perfetto).
+//
+// The PROFILE_ macros record only when MINESWEEPER_PROFILE is defined, as in
+// Debug builds; otherwise they expand to nothing, arguments included.
+//
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace Profile {
+   using Clock = std::chrono::steady_clock;
+
+   enum class EventKind : std::uint8_t {
+      Scope,   // `value` is the duration in nanoseconds
+      Counter, // `value` is the count
+   };
+
+   // `name` must outlive the trace; string literals do.
+   struct Event {
+      char const* name;
+      std::int64_t start; // nanoseconds since Epoch()
+      std::int64_t value;
+      EventKind kind;
+   };
+
+   // Written by its own thread only and read by whoever writes the trace. A
+   // full ring overwrites its oldest events, so recording never blocks or
+   // allocates.
+   class EventRing {
+   public:
+      static auto constexpr CAPACITY = std::size_t(1) << 14;
+
+      explicit EventRing(std::uint32_t thread) : thread_(thread) {}
+
+      void Push(Event const& event) {
+         auto written = written_.load(std::memory_order_relaxed);
+         events_[written & (CAPACITY - 1)] = event;
+         written_.store(written + 1, std::memory_order_release);
+      }
+
+      std::uint32_t Thread() const { return thread_; }
+      // The events still held, oldest first. Events the owner overwrote
+      // while they were copied are left out.
+      std::vector<Event> Snapshot() const;
+      // Events lost to overwriting.
+      std::size_t Dropped() const;
+      // Owner only, or while the owner records nothing.
+      void Clear() { written_.store(0, std::memory_order_release); }
+
+   private:
+      std::uint32_t thread_;
+      std::array<Event, CAPACITY> events_;
+      std::atomic<std::size_t> written_ = 0;
+   };
+
+   Clock::time_point Epoch();
+   inline std::int64_t Now() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - Epoch()).count();
+   }
+
+   // The calling thread's ring, registered on first use and kept until exit.
+   EventRing& RegisterThread();
+   inline EventRing& ThisThread() {
+      thread_local EventRing* ring = &RegisterThread();
+      return *ring;
+   }
+
+   class ScopedTimer {
+   public:
+      explicit ScopedTimer(char const* name) : name_(name), start_(Now()) {}
+      ~ScopedTimer() { ThisThread().Push({ name_, start_, Now() - start_, EventKind::Scope }); }
+
+      ScopedTimer(ScopedTimer const&) = delete;
+      ScopedTimer& operator=(ScopedTimer const&) = delete;
+
+   private:
+      char const* name_;
+      std::int64_t start_;
+   };
+
+   inline void Count(char const* name, std::int64_t value) {
+      ThisThread().Push({ name, Now(), value, EventKind::Counter });
+   }
+
+   struct TraceStats {
+      std::size_t threads;
+      std::size_t events;
+      std::size_t dropped;
+   };
+
+   // Every thread's events as Chrome trace JSON: scopes as complete events,
+   // counters as counter events.
+   TraceStats WriteChromeTrace(std::ostream& out);
+   // Empties every ring; only while no other thread records.
+   void Reset();
+}
+
+#define PROFILE_JOIN_(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN_(a, b)
+
+#ifdef MINESWEEPER_PROFILE
+#define PROFILE_SCOPE(name) ::Profile::ScopedTimer PROFILE_JOIN(profileScope, __LINE__)(name)
+#define PROFILE_COUNT(name, value) ::Profile::Count(name, std::int64_t(value))
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_COUNT(name, value) ((void)0)
+#endif
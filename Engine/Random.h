@@ -0,0 +1,90 @@
+#pragma once
+//
+// Random.h
+// Small, fast generators for board generation. Both satisfy
+// UniformRandomBitGenerator, so any standard engine can be used instead.
+//
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+class SplitMix64 {
+public:
+   using result_type = std::uint64_t;
+
+   explicit SplitMix64(std::uint64_t seed) : state_(seed) {}
+
+   static constexpr result_type min() { return 0; }
+   static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+   result_type operator()() {
+      auto z = (state_ += 0x9E3779B97F4A7C15ull);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      return z ^ (z >> 31);
+   }
+
+private:
+   std::uint64_t state_;
+};
+
+// xoshiro256** by Blackman and Vigna, seeded through SplitMix64.
+class Xoshiro256 {
+public:
+   using result_type = std::uint64_t;
+
+   explicit Xoshiro256(std::uint64_t seed) {
+      SplitMix64 mix(seed);
+      for (auto& word : state_) {
+         word = mix();
+      }
+   }
+
+   static constexpr result_type min() { return 0; }
+   static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+   result_type operator()() {
+      auto result = std::rotl(state_[1] * 5, 7) * 9;
+      auto t = state_[1] << 17;
+      state_[2] ^= state_[0];
+      state_[3] ^= state_[1];
+      state_[1] ^= state_[2];
+      state_[0] ^= state_[3];
+      state_[2] ^= t;
+      state_[3] = std::rotl(state_[3], 45);
+      return result;
+   }
+
+private:
+   std::uint64_t state_[4];
+};
+
+// Uniform value in [0, range) without modulo bias. Full 64-bit generators and
+// ranges below 2^32 take Lemire's multiply-shift; anything else goes through
+// std::uniform_int_distribution.
+template <typename Rng>
+std::uint64_t Bounded(Rng& rng, std::uint64_t range) {
+   if constexpr (Rng::min() == 0 && Rng::max() == std::numeric_limits<std::uint64_t>::max()) {
+      if (range <= 0xFFFFFFFFull) {
+         auto product = (rng() >> 32) * range;
+         auto low = std::uint32_t(product);
+         if (low < range) {
+            auto threshold = std::uint32_t(-std::uint32_t(range)) % std::uint32_t(range);
+            while (low < threshold) {
+               product = (rng() >> 32) * range;
+               low = std::uint32_t(product);
+            }
+         }
+         return product >> 32;
+      }
+   }
+   return std::uniform_int_distribution<std::uint64_t>(0, range - 1)(rng);
+}
+
+// A seed from the system entropy source, for boards nobody asked to reproduce.
+inline std::uint64_t RandomSeed() {
+   std::random_device dev;
+   return (std::uint64_t(dev()) << 32) | dev();
+}
@@ -0,0 +1,155 @@
+#include "Replay.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+   char constexpr MAGIC[4] = { 'M', 'S', 'R', 'P' };
+   // 2: mines are placed around the centre, then moved to the first click
+   auto constexpr VERSION = std::uint8_t(2);
+   // larger than any board the game makes, small enough to allocate
+   auto constexpr MAX_CELLS = std::uint64_t(1) << 28;
+}
+
+ReplayWriter::ReplayWriter(std::ostream& out, ReplayHeader const& header) :
+   out_(out) {
+   out_.write(MAGIC, sizeof(MAGIC));
+   Put(VERSION);
+   PutFixed(std::uint32_t(header.size.width), 4);
+   PutFixed(std::uint32_t(header.size.height), 4);
+   PutFixed(std::uint32_t(header.size.mines), 4);
+   Put(std::uint8_t(header.safeZone));
+   PutFixed(header.seed, 8);
+}
+
+void ReplayWriter::Record(ReplayAction action, Pos pos, std::uint64_t time) {
+   Put(std::uint8_t(action));
+   PutTime(time);
+   PutVarint(std::uint32_t(pos.x));
+   PutVarint(std::uint32_t(pos.y));
+}
+
+void ReplayWriter::Finish(ReplayEnd const& end, std::uint64_t time) {
+   Put(std::uint8_t(ReplayAction::End));
+   PutTime(time);
+   Put(std::uint8_t(end.state));
+   PutVarint(end.opened);
+   PutVarint(end.flagged);
+   PutFixed(end.fingerprint, 8);
+   out_.flush();
+}
+
+void ReplayWriter::Put(std::uint8_t byte) {
+   out_.put(char(byte));
+}
+
+// LEB128: seven bits per byte, high bit set on all but the last
+void ReplayWriter::PutVarint(std::uint64_t value) {
+   while (value >= 0x80) {
+      Put(std::uint8_t(value | 0x80));
+      value >>= 7;
+   }
+   Put(std::uint8_t(value));
+}
+
+void ReplayWriter::PutFixed(std::uint64_t value, int bytes) {
+   for (auto i = 0; i < bytes; i++) {
+      Put(std::uint8_t(value >> (8 * i)));
+   }
+}
+
+// clocks that step back are clamped rather than wrapped
+void ReplayWriter::PutTime(std::uint64_t time) {
+   if (time < lastTime_) time = lastTime_;
+   PutVarint(time - lastTime_);
+   lastTime_ = time;
+}
+
+ReplayReader::ReplayReader(std::istream& in) :
+   in_(in) {
+   char magic[sizeof(MAGIC)] = {};
+   in_.read(magic, sizeof(magic));
+   if (!in_ || !std::equal(magic, magic + sizeof(magic), MAGIC)) throw std::runtime_error("Not a replay");
+   if (Get() != VERSION) throw std::runtime_error("Unsupported replay version");
+   auto width = GetFixed(4);
+   auto height = GetFixed(4);
+   auto mines = GetFixed(4);
+   auto safeZone = Get();
+   // the board would throw too, but not the error this promises
+   if (width < 1 || height < 1 || width * height > MAX_CELLS) throw std::runtime_error("Bad replay board size");
+   if (mines >= width * height) throw std::runtime_error("Too many mines in replay");
+   if (safeZone > std::uint8_t(SafeZone::Block)) throw std::runtime_error("Bad replay safe zone");
+   header_.size = { int(width), int(height), int(mines) };
+   header_.safeZone = SafeZone(safeZone);
+   header_.seed = GetFixed(8);
+}
+
+bool ReplayReader::Next(ReplayEvent& event) {
+   if (end_) return false;
+   auto kind = in_.get();
+   if (kind == std::istream::traits_type::eof()) return false;
+   if (kind > int(ReplayAction::End)) throw std::runtime_error("Bad replay action");
+
+   time_ += GetVarint();
+   if (ReplayAction(kind) == ReplayAction::End) {
+      ReplayEnd end;
+      end.state = GameState(Get());
+      end.opened = GetVarint();
+      end.flagged = GetVarint();
+      end.fingerprint = GetFixed(8);
+      end_ = end;
+      return false;
+   }
+
+   event.action = ReplayAction(kind);
+   event.time = time_;
+   event.pos.x = int(GetVarint());
+   event.pos.y = int(GetVarint());
+   return true;
+}
+
+std::uint8_t ReplayReader::Get() {
+   auto byte = in_.get();
+   if (byte == std::istream::traits_type::eof()) throw std::runtime_error("Replay cut short");
+   return std::uint8_t(byte);
+}
+
+std::uint64_t ReplayReader::GetVarint() {
+   auto value = std::uint64_t(0);
+   for (auto shift = 0; shift < 64; shift += 7) {
+      auto byte = Get();
+      value |= std::uint64_t(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) return value;
+   }
+   throw std::runtime_error("Bad replay varint");
+}
+
+std::uint64_t ReplayReader::GetFixed(int bytes) {
+   auto value = std::uint64_t(0);
+   for (auto i = 0; i < bytes; i++) {
+      value |= std::uint64_t(Get()) << (8 * i);
+   }
+   return value;
+}
+
+ReplayCheck PlayReplay(std::istream& in) {
+   ReplayReader reader(in);
+   auto& header = reader.Header();
+   Board board(header.size, header.safeZone, header.seed);
+
+   ReplayCheck check = {};
+   ReplayEvent event;
+   while (reader.Next(event)) {
+      if (!board.Contains(event.pos.x, event.pos.y)) throw std::runtime_error("Replay action outside the board");
+      switch (event.action) {
+      case ReplayAction::Click: board.Click(event.pos.x, event.pos.y); break;
+      case ReplayAction::Flag: board.Flag(event.pos.x, event.pos.y); break;
+      case ReplayAction::Chord: board.Chord(event.pos.x, event.pos.y); break;
+      default: break;
+      }
+      check.actions++;
+   }
+   check.expected = reader.End();
+   check.actual = EndOf(board);
+   return check;
+}
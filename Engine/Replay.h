@@ -0,0 +1,120 @@
+#pragma once
+//
+// Replay.h
+// Compact binary log of a game: the board it was played on and every action
+// with its time, enough to play the game again and check it ends the same way.
+//
+// Layout, little endian:
+//    "MSRP" version:u8 width:u32 height:u32 mines:u32 safeZone:u8 seed:u64
+//    then per action:  kind:u8 time:varint x:varint y:varint
+//    then at the end:  kind:u8 time:varint state:u8 opened:varint flagged:varint fingerprint:u64
+// Times are microseconds since the previous record, so a typical action takes
+// five or six bytes.
+//
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+
+#include "Board.h"
+
+enum class ReplayAction : std::uint8_t {
+   Click,
+   Flag,
+   Chord,
+   End,
+};
+
+struct ReplayHeader {
+   BoardSize size;
+   SafeZone safeZone;
+   std::uint64_t seed;
+};
+
+struct ReplayEvent {
+   ReplayAction action;
+   std::uint64_t time; // microseconds since the game started
+   Pos pos;
+};
+
+// How the game ended, compared by the player.
+struct ReplayEnd {
+   GameState state;
+   std::uint64_t opened;
+   std::uint64_t flagged;
+   std::uint64_t fingerprint;
+
+   bool operator==(ReplayEnd const&) const = default;
+};
+
+// FNV-1a over the cell bytes in row order, the same for both cell stores.
+template <typename Store>
+std::uint64_t Fingerprint(BasicBoard<Store> const& board) {
+   auto hash = 0xCBF29CE484222325ull;
+   for (auto y = 0; y < board.Height(); y++) {
+      for (auto x = 0; x < board.Width(); x++) {
+         hash = (hash ^ board.At(x, y).bits) * 0x100000001B3ull;
+      }
+   }
+   return hash;
+}
+
+template <typename Store>
+ReplayEnd EndOf(BasicBoard<Store> const& board) {
+   return { board.State(), board.Opened(), board.Flagged(), Fingerprint(board) };
+}
+
+// Writes each action as it happens; the stream's own buffer batches the writes.
+class ReplayWriter {
+public:
+   ReplayWriter(std::ostream& out, ReplayHeader const& header);
+
+   void Record(ReplayAction action, Pos pos, std::uint64_t time);
+   // Writes the end record and flushes. Nothing may be recorded afterwards.
+   void Finish(ReplayEnd const& end, std::uint64_t time);
+
+private:
+   void Put(std::uint8_t byte);
+   void PutVarint(std::uint64_t value);
+   void PutFixed(std::uint64_t value, int bytes);
+   void PutTime(std::uint64_t time);
+
+   std::ostream& out_;
+   std::uint64_t lastTime_ = 0;
+};
+
+// Reads a replay back. Throws std::runtime_error on a malformed stream,
+// including a header with a board that cannot be made.
+class ReplayReader {
+public:
+   explicit ReplayReader(std::istream& in);
+
+   ReplayHeader const& Header() const { return header_; }
+   // Reads the next action; false once the end record or the end of a
+   // truncated stream is reached.
+   bool Next(ReplayEvent& event);
+   // Set after Next has read the end record.
+   std::optional<ReplayEnd> const& End() const { return end_; }
+
+private:
+   std::uint8_t Get();
+   std::uint64_t GetVarint();
+   std::uint64_t GetFixed(int bytes);
+
+   std::istream& in_;
+   ReplayHeader header_;
+   std::uint64_t time_ = 0;
+   std::optional<ReplayEnd> end_;
+};
+
+struct ReplayCheck {
+   std::size_t actions;
+   std::optional<ReplayEnd> expected; // missing if the replay was cut short
+   ReplayEnd actual;
+
+   bool Matched() const { return expected && *expected == actual; }
+};
+
+// Plays a replay on a fresh board as fast as possible.
+ReplayCheck PlayReplay(std::istream& in);
@@ -0,0 +1,63 @@
+#pragma once
+//
+// RingQueue.h
+// FIFO over a power of two ring that keeps its memory between uses.
+//
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+template <typename T>
+class RingQueue {
+public:
+   bool Empty() const { return size_ == 0; }
+   std::size_t Size() const { return size_; }
+
+   // Drops the items but keeps the capacity for the next use.
+   void Clear() {
+      head_ = 0;
+      size_ = 0;
+   }
+
+   // Makes room for `capacity` items, so pushing that many does not allocate.
+   void Reserve(std::size_t capacity) {
+      if (capacity > items_.size()) Grow(std::bit_ceil(std::max(capacity, MIN_CAPACITY)));
+   }
+
+   void Push(T value) {
+      if (size_ == items_.size()) Grow(std::max(MIN_CAPACITY, items_.size() * 2));
+      items_[(head_ + size_) & (items_.size() - 1)] = value;
+      size_++;
+   }
+
+   // The newest item; the queue must not be empty.
+   T& Back() {
+      return items_[(head_ + size_ - 1) & (items_.size() - 1)];
+   }
+
+   T Pop() {
+      auto value = items_[head_];
+      head_ = (head_ + 1) & (items_.size() - 1);
+      size_--;
+      return value;
+   }
+
+private:
+   // `capacity` is a power of two.
+   void Grow(std::size_t capacity) {
+      std::vector<T> items(capacity);
+      for (std::size_t i = 0; i < size_; i++) {
+         items[i] = items_[(head_ + i) & (items_.size() - 1)];
+      }
+      items_.swap(items);
+      head_ = 0;
+   }
+
+   static auto constexpr MIN_CAPACITY = std::size_t(256);
+
+   std::vector<T> items_;
+   std::size_t head_ = 0;
+   std::size_t size_ = 0;
+};
@@ -0,0 +1,186 @@
+#include "Solver.h"
+
+#include <bit>
+
+namespace {
+   auto constexpr WINDOW = 7;
+   auto constexpr WINDOW_CENTRE = 3;
+}
+
+template <typename Store>
+BasicSolver<Store>::BasicSolver(BasicBoard<Store> const& board) :
+   cells_(board.Cells()),
+   width_(board.Width()),
+   height_(board.Height()),
+   stride_(std::size_t(board.Width()) + 2),
+   known_(stride_ * (std::size_t(board.Height()) + 2), std::uint8_t(Knowledge::Unknown)),
+   minesLeft_(board.Mines()) {
+   for (auto y = 0; y < height_; y++) {
+      for (auto x = 0; x < width_; x++) {
+         auto index = Index(x, y);
+         if (!cells_.IsOpened(index)) unknown_++;
+         else if (IsNumber(index)) Enqueue({ x, y });
+      }
+   }
+}
+
+template <typename Store>
+void BasicSolver<Store>::Update(std::span<Pos const> changed) {
+   for (auto pos : changed) {
+      auto index = Index(pos.x, pos.y);
+      if (!cells_.IsOpened(index)) continue;
+      // a guess the solver had not proven
+      if ((known_[index] & KNOWLEDGE_MASK) == std::uint8_t(Knowledge::Unknown)) {
+         known_[index] = (known_[index] & ~KNOWLEDGE_MASK) | std::uint8_t(Knowledge::Safe);
+         unknown_--;
+      }
+      EnqueueAround(pos);
+   }
+}
+
+template <typename Store>
+SolveResult BasicSolver<Store>::Solve() {
+   safe_.clear();
+   mines_.clear();
+   do {
+      while (!queue_.Empty()) {
+         auto pos = queue_.Pop();
+         known_[Index(pos.x, pos.y)] &= ~QUEUED_BIT;
+         Process(pos);
+      }
+      SettleByCount();
+   } while (!queue_.Empty());
+   return { safe_, mines_ };
+}
+
+template <typename Store>
+bool BasicSolver<Store>::IsNumber(std::size_t index) const {
+   return cells_.IsOpened(index) && !cells_.IsMined(index) && cells_.MinesNear(index) > 0;
+}
+
+template <typename Store>
+bool BasicSolver<Store>::IsUnknown(std::size_t index) const {
+   return !cells_.IsOpened(index) && (known_[index] & KNOWLEDGE_MASK) == std::uint8_t(Knowledge::Unknown);
+}
+
+template <typename Store>
+void BasicSolver<Store>::Enqueue(Pos pos) {
+   auto index = Index(pos.x, pos.y);
+   if ((known_[index] & QUEUED_BIT) || !IsNumber(index)) return;
+   known_[index] |= QUEUED_BIT;
+   queue_.Push(pos);
+}
+
+template <typename Store>
+void BasicSolver<Store>::EnqueueAround(Pos pos) {
+   for (auto y = pos.y - 1; y <= pos.y + 1; y++) {
+      for (auto x = pos.x - 1; x <= pos.x + 1; x++) {
+         if (Contains(x, y)) Enqueue({ x, y });
+      }
+   }
+}
+
+template <typename Store>
+void BasicSolver<Store>::Mark(Pos pos, Knowledge knowledge) {
+   auto index = Index(pos.x, pos.y);
+   if (!IsUnknown(index)) return;
+   known_[index] = (known_[index] & ~KNOWLEDGE_MASK) | std::uint8_t(knowledge);
+   unknown_--;
+   if (knowledge == Knowledge::Mine) {
+      minesLeft_--;
+      mines_.push_back(pos);
+   }
+   else {
+      safe_.push_back(pos);
+   }
+   EnqueueAround(pos);
+}
+
+template <typename Store>
+void BasicSolver<Store>::MarkWindow(Pos centre, std::uint64_t cells, Knowledge knowledge) {
+   while (cells) {
+      auto bit = std::countr_zero(cells);
+      cells &= cells - 1;
+      Mark({ centre.x + bit % WINDOW - WINDOW_CENTRE, centre.y + bit / WINDOW - WINDOW_CENTRE }, knowledge);
+   }
+}
+
+// Neighbours of the number at centre + (dx, dy), in the window around centre.
+template <typename Store>
+typename BasicSolver<Store>::Constraint BasicSolver<Store>::Read(Pos centre, int dx, int dy) const {
+   Constraint constraint = { 0, cells_.MinesNear(Index(centre.x + dx, centre.y + dy)) };
+   for (auto ny = -1; ny <= 1; ny++) {
+      for (auto nx = -1; nx <= 1; nx++) {
+         auto x = centre.x + dx + nx;
+         auto y = centre.y + dy + ny;
+         if ((nx == 0 && ny == 0) || !Contains(x, y)) continue;
+         auto index = Index(x, y);
+         if (IsUnknown(index)) {
+            constraint.cells |= std::uint64_t(1) << ((dy + ny + WINDOW_CENTRE) * WINDOW + dx + nx + WINDOW_CENTRE);
+         }
+         else if ((known_[index] & KNOWLEDGE_MASK) == std::uint8_t(Knowledge::Mine)) {
+            constraint.mines--;
+         }
+      }
+   }
+   return constraint;
+}
+
+template <typename Store>
+void BasicSolver<Store>::Process(Pos pos) {
+   auto a = Read(pos, 0, 0);
+   if (!a.cells) return;
+
+   auto count = std::popcount(a.cells);
+   if (a.mines == 0) {
+      MarkWindow(pos, a.cells, Knowledge::Safe);
+      return;
+   }
+   if (a.mines == count) {
+      MarkWindow(pos, a.cells, Knowledge::Mine);
+      return;
+   }
+
+   for (auto dy = -2; dy <= 2; dy++) {
+      for (auto dx = -2; dx <= 2; dx++) {
+         if ((dx == 0 && dy == 0) || !Contains(pos.x + dx, pos.y + dy)) continue;
+         if (!IsNumber(Index(pos.x + dx, pos.y + dy))) continue;
+         auto b = Read(pos, dx, dy);
+         if (!(a.cells & b.cells)) continue;
+
+         auto onlyA = a.cells & ~b.cells;
+         auto onlyB = b.cells & ~a.cells;
+         if (b.mines - a.mines == std::popcount(onlyB)) {
+            MarkWindow(pos, onlyB, Knowledge::Mine);
+            MarkWindow(pos, onlyA, Knowledge::Safe);
+         }
+         else if (a.mines - b.mines == std::popcount(onlyA)) {
+            MarkWindow(pos, onlyA, Knowledge::Mine);
+            MarkWindow(pos, onlyB, Knowledge::Safe);
+         }
+         else {
+            continue;
+         }
+         // a's own cells may have changed; look at it again with fresh masks
+         if (onlyA | onlyB) {
+            Enqueue(pos);
+            return;
+         }
+      }
+   }
+}
+
+// One pass over the board, and only when it settles every unknown cell.
+template <typename Store>
+void BasicSolver<Store>::SettleByCount() {
+   if (unknown_ == 0 || (minesLeft_ != 0 && std::uint64_t(minesLeft_) != unknown_)) return;
+   auto knowledge = minesLeft_ == 0 ? Knowledge::Safe : Knowledge::Mine;
+   for (auto y = 0; y < height_ && unknown_ > 0; y++) {
+      for (auto x = 0; x < width_; x++) {
+         Mark({ x, y }, knowledge);
+      }
+   }
+}
+
+template class BasicSolver<CellStore>;
+template class BasicSolver<BitStore>;
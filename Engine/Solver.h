@@ -0,0 +1,92 @@
+#pragma once
+//
+// Solver.h
+// Deductions from what a player can see: the opened cells, their counts and
+// the total number of mines. Player flags are not trusted.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Board.h"
+#include "RingQueue.h"
+
+enum class Knowledge : std::uint8_t {
+   Unknown,
+   Safe,
+   Mine,
+};
+
+// Cells proven by one Solve call. Both spans stay valid until the next Solve.
+struct SolveResult {
+   std::span<Pos const> safe;
+   std::span<Pos const> mines;
+};
+
+// Keeps a worklist of the numbers whose neighbourhood changed, so the work per
+// Solve follows what changed on the board rather than its size. After opening
+// cells on the board, pass the action's changed list to Update.
+//
+// Rules, in order:
+//  - a number whose mines are all known clears its other covered neighbours,
+//    and one with as many covered neighbours as missing mines mines them all;
+//  - for two numbers within two cells of each other, if B needs exactly as many
+//    more mines than A as it has cells A does not touch, those cells are mines
+//    and A's own cells are safe (this contains the subset rule);
+//  - once the worklist is empty, the global mine count settles the rest when no
+//    mines or only mines remain.
+template <typename Store>
+class BasicSolver {
+public:
+   explicit BasicSolver(BasicBoard<Store> const& board);
+
+   // Queues the numbers around cells the board opened since the last call.
+   void Update(std::span<Pos const> changed);
+   // Applies the rules until nothing new follows.
+   SolveResult Solve();
+
+   Knowledge At(int x, int y) const { return Knowledge(known_[Index(x, y)] & KNOWLEDGE_MASK); }
+   // Covered cells whose content is still unknown.
+   std::size_t Unknown() const { return unknown_; }
+
+private:
+   static auto constexpr KNOWLEDGE_MASK = std::uint8_t(0x03);
+   static auto constexpr QUEUED_BIT = std::uint8_t(0x04);
+
+   // Unknown neighbours of a number as a mask over a 7x7 window, and the mines
+   // among them.
+   struct Constraint {
+      std::uint64_t cells;
+      int mines;
+   };
+
+   std::size_t Index(int x, int y) const { return (std::size_t(y) + 1) * stride_ + x + 1; }
+   bool Contains(int x, int y) const { return x >= 0 && x < width_ && y >= 0 && y < height_; }
+   bool IsNumber(std::size_t index) const;
+   bool IsUnknown(std::size_t index) const;
+
+   void Enqueue(Pos pos);
+   void EnqueueAround(Pos pos);
+   void Mark(Pos pos, Knowledge knowledge);
+   void MarkWindow(Pos centre, std::uint64_t cells, Knowledge knowledge);
+   Constraint Read(Pos centre, int dx, int dy) const;
+   void Process(Pos pos);
+   void SettleByCount();
+
+   Store const& cells_;
+   int width_;
+   int height_;
+   std::size_t stride_;
+   std::vector<std::uint8_t> known_;
+   RingQueue<Pos> queue_;
+   std::size_t unknown_ = 0;
+   std::int64_t minesLeft_;
+
+   std::vector<Pos> safe_;
+   std::vector<Pos> mines_;
+};
+
+using Solver = BasicSolver<CellStore>;
+using BitSolver = BasicSolver<BitStore>;
@@ -0,0 +1,57 @@
+#pragma once
+//
+// SpscQueue.h
+// Bounded lock-free queue between exactly one producer and one consumer thread.
+//
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+template <typename T>
+class SpscQueue {
+public:
+   // Capacity is rounded up to a power of two.
+   explicit SpscQueue(std::size_t capacity) {
+      auto size = std::size_t(1);
+      while (size < capacity) size <<= 1;
+      slots_.resize(size);
+      mask_ = size - 1;
+   }
+
+   SpscQueue(SpscQueue const&) = delete;
+   SpscQueue& operator=(SpscQueue const&) = delete;
+
+   // Producer only. Leaves `item` alone and returns false when full.
+   bool TryPush(T& item) {
+      auto tail = tail_.load(std::memory_order_relaxed);
+      if (tail - head_.load(std::memory_order_acquire) > mask_) return false;
+      slots_[tail & mask_] = std::move(item);
+      tail_.store(tail + 1, std::memory_order_release);
+      return true;
+   }
+
+   // Consumer only. Returns false when empty.
+   bool TryPop(T& item) {
+      auto head = head_.load(std::memory_order_relaxed);
+      if (head == tail_.load(std::memory_order_acquire)) return false;
+      item = std::move(slots_[head & mask_]);
+      head_.store(head + 1, std::memory_order_release);
+      return true;
+   }
+
+   // A snapshot: the other end may move meanwhile.
+   std::size_t Size() const {
+      // head first, so the tail read after it can never be behind it
+      auto head = head_.load(std::memory_order_acquire);
+      return tail_.load(std::memory_order_acquire) - head;
+   }
+   std::size_t Capacity() const { return mask_ + 1; }
+
+private:
+   std::vector<T> slots_;
+   std::size_t mask_;
+   // on their own cache lines, so the two threads do not share one
+   alignas(64) std::atomic<std::size_t> head_ = 0;
+   alignas(64) std::atomic<std::size_t> tail_ = 0;
+};
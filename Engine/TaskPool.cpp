@@ -0,0 +1,102 @@
+#include "TaskPool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+   // which deque the current thread owns, if it is a worker of `owner`
+   thread_local TaskPool const* owner = nullptr;
+   thread_local std::size_t ownDeque = 0;
+}
+
+TaskPool::TaskPool(unsigned threads) {
+   if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+   for (unsigned i = 0; i <= threads; i++) {
+      deques_.push_back(std::make_unique<Deque>());
+   }
+   for (unsigned i = 0; i < threads; i++) {
+      threads_.emplace_back([this, i] { Loop(i); });
+   }
+}
+
+TaskPool::~TaskPool() {
+   // an error nobody waited for has nowhere to go
+   try {
+      Wait();
+   }
+   catch (...) {
+   }
+   stop_ = true;
+   submitted_.fetch_add(1);
+   submitted_.notify_all();
+   for (auto& thread : threads_) thread.join();
+}
+
+void TaskPool::Submit(std::function<void()> task) {
+   auto self = owner == this ? ownDeque : threads_.size();
+   pending_.fetch_add(1);
+   {
+      std::lock_guard lock(deques_[self]->mutex);
+      deques_[self]->tasks.push_back(std::move(task));
+   }
+   submitted_.fetch_add(1, std::memory_order_release);
+   submitted_.notify_one();
+}
+
+void TaskPool::Wait() {
+   auto self = owner == this ? ownDeque : threads_.size();
+   while (pending_.load() != 0) {
+      if (!RunOne(self)) std::this_thread::yield();
+   }
+   std::exception_ptr error;
+   {
+      std::lock_guard lock(errorMutex_);
+      error = std::exchange(error_, nullptr);
+   }
+   if (error) std::rethrow_exception(error);
+}
+
+// Own deque from the back, then the others from the front, starting after
+// our own so thieves spread over the victims.
+bool TaskPool::RunOne(std::size_t self) {
+   std::function<void()> task;
+   {
+      std::lock_guard lock(deques_[self]->mutex);
+      if (!deques_[self]->tasks.empty()) {
+         task = std::move(deques_[self]->tasks.back());
+         deques_[self]->tasks.pop_back();
+      }
+   }
+   for (std::size_t i = 1; !task && i < deques_.size(); i++) {
+      auto& victim = *deques_[(self + i) % deques_.size()];
+      std::lock_guard lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+         task = std::move(victim.tasks.front());
+         victim.tasks.pop_front();
+      }
+   }
+   if (!task) return false;
+   // done however the task ends, or Wait would spin for good
+   struct Done {
+      std::atomic<std::size_t>& pending;
+      ~Done() { pending.fetch_sub(1); }
+   } done = { pending_ };
+   try {
+      task();
+   }
+   catch (...) {
+      std::lock_guard lock(errorMutex_);
+      if (!error_) error_ = std::current_exception();
+   }
+   return true;
+}
+
+void TaskPool::Loop(std::size_t self) {
+   owner = this;
+   ownDeque = self;
+   while (!stop_) {
+      auto seen = submitted_.load(std::memory_order_acquire);
+      if (RunOne(self)) continue;
+      submitted_.wait(seen, std::memory_order_acquire);
+   }
+}
@@ -0,0 +1,80 @@
+#pragma once
+//
+// TaskPool.h
+// Work-stealing thread pool: every worker keeps its own deque, runs its newest
+// task first and, when out of work, steals the oldest task of another worker.
+//
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskPool {
+public:
+   // 0 threads means one per hardware thread.
+   explicit TaskPool(unsigned threads = 0);
+   ~TaskPool();
+
+   TaskPool(TaskPool const&) = delete;
+   TaskPool& operator=(TaskPool const&) = delete;
+
+   unsigned Threads() const { return unsigned(threads_.size()); }
+
+   // Tasks submitted from a worker go to that worker's own deque, all others
+   // to a shared one the workers steal from.
+   void Submit(std::function<void()> task);
+   // Runs tasks on the calling thread as well until every submitted task is
+   // done, then rethrows the first exception a task has thrown since the
+   // last Wait. Not for use inside a task, which would wait for itself.
+   void Wait();
+
+private:
+   struct Deque {
+      std::mutex mutex;
+      std::deque<std::function<void()>> tasks;
+   };
+
+   bool RunOne(std::size_t self);
+   void Loop(std::size_t self);
+
+   // one per worker, then the shared one at the end
+   std::vector<std::unique_ptr<Deque>> deques_;
+   std::vector<std::thread> threads_;
+   std::atomic<std::size_t> pending_ = 0;
+   std::atomic<std::uint32_t> submitted_ = 0;
+   std::atomic<bool> stop_ = false;
+   std::mutex errorMutex_;
+   std::exception_ptr error_;
+};
+
+// Runs body(begin, end) over [0, count) in chunks of at most `grain`. Ranges
+// are halved on the thread that owns them, so idle workers steal big halves
+// rather than single chunks.
+template <typename Body>
+void ParallelFor(TaskPool& pool, std::size_t count, std::size_t grain, Body const& body) {
+   struct Split {
+      TaskPool& pool;
+      Body const& body;
+      std::size_t grain;
+
+      void operator()(std::size_t begin, std::size_t end) const {
+         while (end - begin > grain) {
+            auto middle = begin + (end - begin) / 2;
+            pool.Submit([split = *this, middle, end] { split(middle, end); });
+            end = middle;
+         }
+         body(begin, end);
+      }
+   };
+   if (count == 0) return;
+   Split split = { pool, body, grain > 0 ? grain : 1 };
+   pool.Submit([split, count] { split(0, count); });
+   pool.Wait();
+}
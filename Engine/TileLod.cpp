@@ -0,0 +1,132 @@
+#include "TileLod.h"
+
+#include <algorithm>
+
+namespace {
+   std::uint8_t Share(std::uint32_t part, std::uint32_t whole) {
+      return std::uint8_t((part * 255 + whole / 2) / whole);
+   }
+}
+
+TileLod::TileLod(int width, int height) {
+   auto most = std::size_t(0);
+   for (auto level = 1; level <= MAX_LEVEL; level++) {
+      auto block = 1 << level;
+      auto w = (width + block - 1) / block;
+      auto h = (height + block - 1) / block;
+      auto size = std::size_t(w) * h;
+      levels_.push_back({ w, h, std::vector<Counts>(size), std::vector<LodInstance>(size), {}, std::vector<std::uint8_t>(size) });
+      levels_.back().changed.reserve(std::min(size, CHANGED_CAPACITY));
+      most = std::max(most, std::min(size, CHANGED_CAPACITY));
+      if (w == 1 && h == 1) break;
+   }
+   // no more ranges than changed blocks
+   ranges_.reserve(std::max(most, std::size_t(1)));
+}
+
+void TileLod::Build(TileMap const& tiles) {
+   for (auto level = 1; level <= Levels(); level++) {
+      auto const& current = levels_[level - 1];
+      for (auto y = 0; y < current.height; y++) {
+         for (auto x = 0; x < current.width; x++) Store(level, x, y, Gather(tiles, level, x, y));
+      }
+   }
+   ForgetChanged();
+   allChanged_ = true;
+}
+
+void TileLod::Update(TileMap const& tiles, std::span<Pos const> cells) {
+   for (auto pos : cells) {
+      for (auto level = 1; level <= Levels(); level++) {
+         auto x = pos.x >> level;
+         auto y = pos.y >> level;
+         Store(level, x, y, Gather(tiles, level, x, y));
+         if (!allChanged_) MarkChanged(levels_[level - 1], std::size_t(y) * Width(level) + x);
+      }
+   }
+}
+
+// Sums the up to four cells, or blocks of the level below, making up a block.
+TileLod::Counts TileLod::Gather(TileMap const& tiles, int level, int x, int y) const {
+   Counts sum = {};
+   auto below = level - 1;
+   auto width = below == 0 ? tiles.Width() : Width(below);
+   auto height = below == 0 ? tiles.Height() : Height(below);
+   for (auto dy = 0; dy < 2; dy++) {
+      for (auto dx = 0; dx < 2; dx++) {
+         auto cx = x * 2 + dx;
+         auto cy = y * 2 + dy;
+         if (cx >= width || cy >= height) continue;
+         if (below > 0) {
+            auto part = levels_[below - 1].counts[std::size_t(cy) * width + cx];
+            sum.cells += part.cells;
+            sum.opened += part.opened;
+            sum.flagged += part.flagged;
+            sum.mines += part.mines;
+            continue;
+         }
+         auto tile = tiles.At(cx, cy);
+         sum.cells++;
+         if (tile.tile == Tile::Mine || tile.tile == Tile::Empty || tile.tile == Tile::Number) sum.opened++;
+         if (tile.tile == Tile::Flagged) sum.flagged++;
+         if (tile.tile == Tile::Mine || (tile.flags & TileFlags::MINE_SHOWN)) sum.mines++;
+      }
+   }
+   return sum;
+}
+
+void TileLod::Store(int level, int x, int y, Counts counts) {
+   auto& current = levels_[level - 1];
+   auto index = std::size_t(y) * current.width + x;
+   current.counts[index] = counts;
+   current.instances[index] = {
+      Share(counts.opened, counts.cells),
+      Share(counts.flagged, counts.cells),
+      Share(counts.mines, counts.cells),
+      0,
+   };
+}
+
+void TileLod::MarkChanged(Level& level, std::size_t index) {
+   if (level.listed[index]) return;
+   if (level.changed.size() == level.changed.capacity()) {
+      // a full list would grow, and past this many blocks whole levels are
+      // about as cheap to upload
+      ForgetChanged();
+      allChanged_ = true;
+      return;
+   }
+   level.listed[index] = 1;
+   level.changed.push_back(index);
+}
+
+void TileLod::ForgetChanged() {
+   for (auto& level : levels_) {
+      for (auto index : level.changed) level.listed[index] = 0;
+      level.changed.clear();
+   }
+}
+
+std::span<InstanceRange const> TileLod::Changed(int level) {
+   auto& current = levels_[level - 1];
+   ranges_.clear();
+   if (allChanged_) {
+      ranges_.push_back({ 0, current.instances.size() });
+      return ranges_;
+   }
+   std::sort(current.changed.begin(), current.changed.end());
+   for (auto index : current.changed) {
+      if (!ranges_.empty() && index < ranges_.back().last + TileMap::RANGE_GAP) {
+         ranges_.back().last = std::max(ranges_.back().last, index + 1);
+      }
+      else {
+         ranges_.push_back({ index, index + 1 });
+      }
+   }
+   return ranges_;
+}
+
+void TileLod::ClearChanged() {
+   allChanged_ = false;
+   ForgetChanged();
+}
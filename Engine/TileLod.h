@@ -0,0 +1,82 @@
+#pragma once
+//
+// TileLod.h
+// Coarser copies of a TileMap for a camera zoomed out too far to draw cells:
+// at level k one instance stands for a block of 2^k x 2^k cells.
+//
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "TileMap.h"
+
+// Four bytes, read by the shader as one uint: how much of the block is
+// opened, flagged and shown mines, 0-255 each, from the lowest byte up.
+struct LodInstance {
+   std::uint8_t opened;
+   std::uint8_t flagged;
+   std::uint8_t mines;
+   std::uint8_t unused;
+
+   bool operator==(LodInstance const& other) const = default;
+};
+static_assert(sizeof(LodInstance) == 4);
+
+// Each level keeps exact counts as well as the instances, and a changed cell
+// updates one block per level from the four below it, so keeping the levels
+// current costs a few steps per changed cell whatever the board size. Levels
+// go up to MAX_LEVEL or until a single block covers the board.
+//
+// Changed blocks are listed once each, in lists reserved up front, so
+// tracking them never allocates; past CHANGED_CAPACITY blocks in a level
+// everything counts as changed instead.
+class TileLod {
+public:
+   static auto constexpr MAX_LEVEL = 10;
+   static auto constexpr CHANGED_CAPACITY = std::size_t(1) << 16;
+
+   TileLod(int width, int height);
+
+   // Rebuilds every level from the tiles.
+   void Build(TileMap const& tiles);
+   // Rebuilds the blocks holding `cells`, which must already be updated in `tiles`.
+   void Update(TileMap const& tiles, std::span<Pos const> cells);
+
+   // Levels 1 to Levels() exist.
+   int Levels() const { return int(levels_.size()); }
+   int Width(int level) const { return levels_[level - 1].width; }
+   int Height(int level) const { return levels_[level - 1].height; }
+   std::span<LodInstance const> Instances(int level) const { return levels_[level - 1].instances; }
+
+   // Blocks changed at a level since the last ClearChanged, see TileMap::Changed.
+   std::span<InstanceRange const> Changed(int level);
+   void ClearChanged();
+
+private:
+   struct Counts {
+      std::uint32_t cells;
+      std::uint32_t opened;
+      std::uint32_t flagged;
+      std::uint32_t mines;
+   };
+
+   struct Level {
+      int width;
+      int height;
+      std::vector<Counts> counts;
+      std::vector<LodInstance> instances;
+      std::vector<std::size_t> changed;
+      // one per block, set while the block is in `changed`
+      std::vector<std::uint8_t> listed;
+   };
+
+   Counts Gather(TileMap const& tiles, int level, int x, int y) const;
+   void Store(int level, int x, int y, Counts counts);
+   void MarkChanged(Level& level, std::size_t index);
+   void ForgetChanged();
+
+   std::vector<Level> levels_;
+   bool allChanged_ = false;
+   std::vector<InstanceRange> ranges_;
+};
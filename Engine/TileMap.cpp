@@ -0,0 +1,106 @@
+#include "TileMap.h"
+
+#include <algorithm>
+
+namespace {
+   template <typename Store>
+   TileInstance TileOf(BasicBoard<Store> const& board, int x, int y, ProbabilityGrid const* odds) {
+      auto cell = board.At(x, y);
+      TileInstance instance = { Tile::Covered, 0, 0, 0 };
+      if (cell.IsOpened()) {
+         if (cell.IsMined()) instance.tile = Tile::Mine;
+         else if (cell.MinesNear() == 0) instance.tile = Tile::Empty;
+         else {
+            instance.tile = Tile::Number;
+            instance.tint = std::uint8_t(cell.MinesNear());
+         }
+         return instance;
+      }
+
+      if (cell.State() == RCellState::Flagged) instance.tile = Tile::Flagged;
+      if (cell.State() == RCellState::Questioned) instance.tile = Tile::Questioned;
+      if (board.State() == GameState::Defeat && cell.IsMined()) instance.flags |= TileFlags::MINE_SHOWN;
+      if (odds && board.State() == GameState::Play && !cell.IsMarked()) {
+         instance.flags |= TileFlags::ODDS_SHOWN;
+         instance.odds = std::uint8_t(std::clamp(odds->At(x, y), 0.0f, 1.0f) * 255 + .5f);
+      }
+      return instance;
+   }
+}
+
+TileMap::TileMap(int width, int height) :
+   width_(width),
+   height_(height),
+   instances_(std::size_t(width) * height, TileInstance{ Tile::Covered, 0, 0, 0 }) {
+   auto most = std::max(std::min(instances_.size(), CHANGED_CAPACITY), std::size_t(1));
+   changed_.reserve(most);
+   // no more ranges than changes
+   ranges_.reserve(most);
+}
+
+template <typename Store>
+void TileMap::Build(BasicBoard<Store> const& board, TileView const& view) {
+   auto index = std::size_t(0);
+   for (auto y = 0; y < height_; y++) {
+      for (auto x = 0; x < width_; x++) {
+         instances_[index++] = TileOf(board, x, y, view.odds);
+      }
+   }
+   for (auto pos : view.pressed) {
+      if (!board.At(pos.x, pos.y).IsOpened()) instances_[std::size_t(pos.y) * width_ + pos.x].flags |= TileFlags::PRESSED;
+   }
+   allChanged_ = true;
+   changed_.clear();
+}
+
+template <typename Store>
+void TileMap::Update(BasicBoard<Store> const& board, std::span<Pos const> cells, TileView const& view) {
+   for (auto pos : cells) Set(board, pos, view);
+}
+
+template <typename Store>
+void TileMap::Set(BasicBoard<Store> const& board, Pos pos, TileView const& view) {
+   auto instance = TileOf(board, pos.x, pos.y, view.odds);
+   auto pressed = std::any_of(view.pressed.begin(), view.pressed.end(), [pos](Pos other) {
+      return other.x == pos.x && other.y == pos.y;
+      });
+   if (pressed && !board.At(pos.x, pos.y).IsOpened()) instance.flags |= TileFlags::PRESSED;
+
+   auto index = std::size_t(pos.y) * width_ + pos.x;
+   instances_[index] = instance;
+   if (allChanged_) return;
+   if (changed_.size() == changed_.capacity()) {
+      allChanged_ = true;
+      changed_.clear();
+      return;
+   }
+   changed_.push_back(index);
+}
+
+std::span<InstanceRange const> TileMap::Changed() {
+   ranges_.clear();
+   if (allChanged_) {
+      ranges_.push_back({ 0, instances_.size() });
+      return ranges_;
+   }
+   std::sort(changed_.begin(), changed_.end());
+   for (auto index : changed_) {
+      if (!ranges_.empty() && index < ranges_.back().last + RANGE_GAP) {
+         ranges_.back().last = std::max(ranges_.back().last, index + 1);
+      }
+      else {
+         ranges_.push_back({ index, index + 1 });
+      }
+   }
+   return ranges_;
+}
+
+void TileMap::ClearChanged() {
+   allChanged_ = false;
+   changed_.clear();
+}
+
+template void TileMap::Build(BasicBoard<CellStore> const&, TileView const&);
+template void TileMap::Build(BasicBoard<BitStore> const&, TileView const&);
+template void TileMap::Update(BasicBoard<CellStore> const&, std::span<Pos const>, TileView const&);
+template void TileMap::Update(BasicBoard<BitStore> const&, std::span<Pos const>, TileView const&);
@@ -0,0 +1,99 @@
+#pragma once
+//
+// TileMap.h
+// The board packed into one small instance per cell, for a renderer that
+// draws the whole field in a single instanced call.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Board.h"
+#include "Probability.h"
+
+// Main picture of a cell.
+enum class Tile : std::uint8_t {
+   Covered,
+   Flagged,
+   Questioned,
+   Mine,   // opened mine
+   Empty,  // opened, no mines around
+   Number, // opened, `tint` holds the number
+};
+
+namespace TileFlags {
+   auto constexpr PRESSED = std::uint8_t(1 << 0);
+   // a covered mine shown once the game is lost
+   auto constexpr MINE_SHOWN = std::uint8_t(1 << 1);
+   // `odds` holds the mine chance, 0-255
+   auto constexpr ODDS_SHOWN = std::uint8_t(1 << 2);
+}
+
+// Four bytes, read by the shader as one uint: tile, tint, odds, flags from
+// the lowest byte up. The tint is the number 1-8, indexing NUMBER_TINTS.
+struct TileInstance {
+   Tile tile;
+   std::uint8_t tint;
+   std::uint8_t odds;
+   std::uint8_t flags;
+
+   bool operator==(TileInstance const& other) const = default;
+};
+static_assert(sizeof(TileInstance) == 4);
+
+// What is shown besides the board itself.
+struct TileView {
+   std::span<Pos const> pressed;
+   // the mine chances, when the overlay is on
+   ProbabilityGrid const* odds = nullptr;
+};
+
+// A run of instances, [first, last).
+struct InstanceRange {
+   std::size_t first;
+   std::size_t last;
+};
+
+// Instances are row-major, so a cell's position follows from its instance
+// index and only the tile data is stored. Changed instances are tracked, so
+// an upload copies the ranges around them rather than the board. The list is
+// reserved up front; past CHANGED_CAPACITY changes everything counts as
+// changed rather than the list growing.
+class TileMap {
+public:
+   TileMap(int width, int height);
+
+   // Rebuilds every instance.
+   template <typename Store>
+   void Build(BasicBoard<Store> const& board, TileView const& view);
+   // Rebuilds the instances of `cells` only.
+   template <typename Store>
+   void Update(BasicBoard<Store> const& board, std::span<Pos const> cells, TileView const& view);
+
+   int Width() const { return width_; }
+   int Height() const { return height_; }
+   std::span<TileInstance const> Instances() const { return instances_; }
+   TileInstance At(int x, int y) const { return instances_[std::size_t(y) * width_ + x]; }
+
+   // Instances changed since the last ClearChanged, as sorted, disjoint
+   // ranges. Changes less than RANGE_GAP apart share a range, trading a few
+   // unchanged instances for fewer copies.
+   std::span<InstanceRange const> Changed();
+   void ClearChanged();
+
+   static auto constexpr RANGE_GAP = std::size_t(64);
+   static auto constexpr CHANGED_CAPACITY = std::size_t(1) << 16;
+
+private:
+   template <typename Store>
+   void Set(BasicBoard<Store> const& board, Pos pos, TileView const& view);
+
+   int width_;
+   int height_;
+   std::vector<TileInstance> instances_;
+   bool allChanged_ = false;
+   std::vector<std::size_t> changed_;
+   std::vector<InstanceRange> ranges_;
+};
@@ -0,0 +1,159 @@
+#pragma once
+//
+// Topology.h
+// Which cells neighbour which. Boards take a topology as a template
+// parameter, see Board.h, so the neighbour loops are compiled for it rather
+// than dispatched at run time:
+//   Moore      the classic eight cells around
+//   Torus      the same eight, with the edges wrapping around
+//   VonNeumann the four cells sharing a side
+//   Hex        the six cells of a hexagonal board, odd rows shifted right
+//              by half a cell
+//
+// Each is sized at run time, as Moore<>, or at compile time, as Moore<30, 16>,
+// which makes the stride and every neighbour offset a constant. Both go
+// through the same code.
+//
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Cells are indexed row-major with a one cell border, as the board stores
+// them; the border holds every neighbour of the topologies that do not wrap.
+class DynamicExtent {
+public:
+   DynamicExtent(int width, int height) : width_(width), height_(height) {}
+
+   int Width() const { return width_; }
+   int Height() const { return height_; }
+   std::size_t Stride() const { return std::size_t(width_) + 2; }
+
+private:
+   int width_;
+   int height_;
+};
+
+template <int W, int H>
+class FixedExtent {
+public:
+   static_assert(W > 0 && H > 0, "A fixed extent has cells");
+
+   FixedExtent(int width, int height) {
+      if (width != W || height != H) throw std::invalid_argument("Board size does not match the size it was compiled for");
+   }
+
+   static constexpr int Width() { return W; }
+   static constexpr int Height() { return H; }
+   static constexpr std::size_t Stride() { return std::size_t(W) + 2; }
+};
+
+// Zero by zero stands for sized at run time.
+template <int W, int H>
+using Extent = std::conditional_t<W == 0 && H == 0, DynamicExtent, FixedExtent<W, H>>;
+
+namespace Topologies {
+   struct Step {
+      int dx;
+      int dy;
+   };
+
+   // Calls `visit(index, x, y)` for the cell `step` away from (x, y), one
+   // call per step written out rather than looped over.
+   template <auto const& Steps, typename Visit, std::size_t... I>
+   void Unrolled(std::index_sequence<I...>, std::size_t index, int x, int y, std::ptrdiff_t stride, Visit&& visit) {
+      (visit(std::size_t(std::ptrdiff_t(index) + Steps[I].dy * stride + Steps[I].dx), x + Steps[I].dx, y + Steps[I].dy), ...);
+   }
+
+   template <auto const& Steps, typename Visit>
+   void Walk(std::size_t index, int x, int y, std::ptrdiff_t stride, Visit&& visit) {
+      Unrolled<Steps>(std::make_index_sequence<Steps.size()>(), index, x, y, stride, visit);
+   }
+
+   // row-major, as Board has always opened them
+   inline constexpr std::array<Step, 8> BOX = { { { -1, -1 }, { 0, -1 }, { 1, -1 }, { -1, 0 }, { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } } };
+   inline constexpr std::array<Step, 4> SIDES = { { { 0, -1 }, { -1, 0 }, { 1, 0 }, { 0, 1 } } };
+   inline constexpr std::array<Step, 6> HEX_EVEN = { { { -1, -1 }, { 0, -1 }, { -1, 0 }, { 1, 0 }, { -1, 1 }, { 0, 1 } } };
+   inline constexpr std::array<Step, 6> HEX_ODD = { { { 0, -1 }, { 1, -1 }, { -1, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } } };
+}
+
+// Each topology calls `visit(index, x, y)` from ForEachNear for every
+// neighbour of the cell at (x, y) and `index`. Those that do not wrap visit
+// border cells too, which are opened and outside the board. BOX is set
+// when the neighbours are exactly the 3x3 block around the cell, which is
+// what the stores count mines over on their own.
+template <int W = 0, int H = 0>
+class Moore : public Extent<W, H> {
+public:
+   static auto constexpr NEAR = 8;
+   static auto constexpr BOX = true;
+
+   using Extent<W, H>::Extent;
+
+   template <typename Visit>
+   void ForEachNear(std::size_t index, int x, int y, Visit&& visit) const {
+      Topologies::Walk<Topologies::BOX>(index, x, y, std::ptrdiff_t(this->Stride()), visit);
+   }
+};
+
+template <int W = 0, int H = 0>
+class Torus : public Extent<W, H> {
+public:
+   static auto constexpr NEAR = 8;
+   static auto constexpr BOX = false;
+
+   Torus(int width, int height) : Extent<W, H>(width, height) {
+      // narrower, a cell would be its own neighbour or one counted twice
+      if (width < 3 || height < 3) throw std::invalid_argument("A torus needs at least 3 by 3 cells");
+   }
+
+   template <typename Visit>
+   void ForEachNear(std::size_t, int x, int y, Visit&& visit) const {
+      auto left = x == 0 ? this->Width() - 1 : x - 1;
+      auto right = x == this->Width() - 1 ? 0 : x + 1;
+      auto up = y == 0 ? this->Height() - 1 : y - 1;
+      auto down = y == this->Height() - 1 ? 0 : y + 1;
+      auto stride = this->Stride();
+      auto at = [stride](int cellX, int cellY) { return (std::size_t(cellY) + 1) * stride + cellX + 1; };
+      visit(at(left, up), left, up);
+      visit(at(x, up), x, up);
+      visit(at(right, up), right, up);
+      visit(at(left, y), left, y);
+      visit(at(right, y), right, y);
+      visit(at(left, down), left, down);
+      visit(at(x, down), x, down);
+      visit(at(right, down), right, down);
+   }
+};
+
+template <int W = 0, int H = 0>
+class VonNeumann : public Extent<W, H> {
+public:
+   static auto constexpr NEAR = 4;
+   static auto constexpr BOX = false;
+
+   using Extent<W, H>::Extent;
+
+   template <typename Visit>
+   void ForEachNear(std::size_t index, int x, int y, Visit&& visit) const {
+      Topologies::Walk<Topologies::SIDES>(index, x, y, std::ptrdiff_t(this->Stride()), visit);
+   }
+};
+
+template <int W = 0, int H = 0>
+class Hex : public Extent<W, H> {
+public:
+   static auto constexpr NEAR = 6;
+   static auto constexpr BOX = false;
+
+   using Extent<W, H>::Extent;
+
+   template <typename Visit>
+   void ForEachNear(std::size_t index, int x, int y, Visit&& visit) const {
+      auto stride = std::ptrdiff_t(this->Stride());
+      if (y & 1) Topologies::Walk<Topologies::HEX_ODD>(index, x, y, stride, visit);
+      else Topologies::Walk<Topologies::HEX_EVEN>(index, x, y, stride, visit);
+   }
+};
@@ -0,0 +1,61 @@
+#include "Wave.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+   std::uint32_t Read32(std::uint8_t const* at) {
+      return std::uint32_t(at[0]) | std::uint32_t(at[1]) << 8 | std::uint32_t(at[2]) << 16 | std::uint32_t(at[3]) << 24;
+   }
+
+   std::uint16_t Read16(std::uint8_t const* at) {
+      return std::uint16_t(at[0] | at[1] << 8);
+   }
+
+   bool Is(std::uint8_t const* at, char const (&tag)[5]) {
+      return std::memcmp(at, tag, 4) == 0;
+   }
+}
+
+WaveFile ParseWave(std::unique_ptr<std::uint8_t[]> data, std::size_t size) {
+   auto bytes = data.get();
+   if (size < 12 || !Is(bytes, "RIFF") || !Is(bytes + 8, "WAVE")) throw std::runtime_error("Not a WAVE file");
+
+   WaveFile wave;
+   auto foundFormat = false;
+   auto foundSamples = false;
+   // chunks are padded to an even size
+   for (std::size_t at = 12; at + 8 <= size; at += 8 + ((Read32(bytes + at + 4) + 1) & ~std::size_t(1))) {
+      auto chunkSize = std::size_t(Read32(bytes + at + 4));
+      auto body = at + 8;
+      if (Is(bytes + at, "fmt ")) {
+         if (chunkSize < 16 || body + chunkSize > size) throw std::runtime_error("WAVE format cut short");
+         wave.format = { Read16(bytes + body), Read16(bytes + body + 2), Read32(bytes + body + 4),
+            Read32(bytes + body + 8), Read16(bytes + body + 12), Read16(bytes + body + 14) };
+         wave.formatOffset = body;
+         foundFormat = true;
+      }
+      else if (Is(bytes + at, "data")) {
+         // some writers leave the size too large; take what is there
+         wave.samplesOffset = body;
+         wave.samplesSize = std::min(chunkSize, size - std::min(body, size));
+         foundSamples = true;
+      }
+      if (foundFormat && foundSamples) break;
+   }
+   if (!foundFormat || !foundSamples) throw std::runtime_error("WAVE file without format or samples");
+
+   auto const& format = wave.format;
+   if (format.formatTag != WaveFile::FORMAT_PCM && format.formatTag != WaveFile::FORMAT_FLOAT) {
+      throw std::runtime_error("Unsupported WAVE encoding");
+   }
+   if (format.channels == 0 || format.blockAlign != format.channels * format.bitsPerSample / 8) {
+      throw std::runtime_error("Bad WAVE format");
+   }
+   wave.samplesSize -= wave.samplesSize % format.blockAlign;
+
+   wave.data = std::move(data);
+   wave.size = size;
+   return wave;
+}
@@ -0,0 +1,41 @@
+#pragma once
+//
+// Wave.h
+// RIFF WAVE parsing in place: the format and the samples are found in the
+// file's own buffer, so a sound is handed to the audio engine without a copy.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// The "fmt " chunk as stored, the same layout as WAVEFORMATEX without cbSize.
+struct WaveFormat {
+   std::uint16_t formatTag;
+   std::uint16_t channels;
+   std::uint32_t sampleRate;
+   std::uint32_t bytesPerSecond;
+   std::uint16_t blockAlign;
+   std::uint16_t bitsPerSample;
+};
+
+struct WaveFile {
+   static auto constexpr FORMAT_PCM = std::uint16_t(1);
+   static auto constexpr FORMAT_FLOAT = std::uint16_t(3);
+
+   std::unique_ptr<std::uint8_t[]> data;
+   std::size_t size = 0;
+   WaveFormat format = {};
+   // where the "fmt " chunk and the samples are in `data`
+   std::size_t formatOffset = 0;
+   std::size_t samplesOffset = 0;
+   std::size_t samplesSize = 0;
+
+   std::uint8_t const* Format() const { return data.get() + formatOffset; }
+   std::uint8_t const* Samples() const { return data.get() + samplesOffset; }
+   double Seconds() const { return format.bytesPerSecond ? double(samplesSize) / format.bytesPerSecond : 0; }
+};
+
+// Takes the whole file. Throws std::runtime_error if it is not a PCM or
+// float WAVE file or is cut short.
+WaveFile ParseWave(std::unique_ptr<std::uint8_t[]> data, std::size_t size);
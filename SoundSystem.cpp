@@ -3,6 +3,13 @@
 
 namespace {
    auto constexpr PIG_SOUNDS_NUMBER = 9;
+
+   // defeat, win, then the pigs
+   std::vector<std::string> SoundFiles() {
+      std::vector<std::string> files = { "sounds/defeat.wav", "sounds/win.wav" };
+      for (auto i = 1; i <= PIG_SOUNDS_NUMBER; i++) files.push_back(std::format("sounds/pig{}.wav", i));
+      return files;
+   }
 }
 
 SoundSystem::~SoundSystem() {
@@ -18,14 +25,6 @@ bool SoundSystem::Init() {
 #endif
    try {
       audioEngine_ = std::make_unique<DirectX::AudioEngine>(eflags);
-
-      defeat = std::make_unique<DirectX::SoundEffect>(audioEngine_.get(), L"sounds/defeat.wav");
-      win = std::make_unique<DirectX::SoundEffect>(audioEngine_.get(), L"sounds/win.wav");
-      for (auto i = 1; i <= PIG_SOUNDS_NUMBER; i++) {
-         wchar_t buf[100];
-         swprintf_s(buf, L"sounds/pig%i.wav", i);
-         pigSounds_.push_back(std::make_unique<DirectX::SoundEffect>(audioEngine_.get(), buf));
-      }
       return true;
    }
    catch (const std::exception& exc) {
@@ -34,9 +33,78 @@ bool SoundSystem::Init() {
    }
 }
 
+void SoundSystem::Load(AssetLoader& loader) {
+   auto files = SoundFiles();
+   waves_.resize(files.size());
+   for (std::size_t i = 0; i < files.size(); i++) {
+      loader.Load(files[i], files[i], AssetPriority::Deferred, [&wave = waves_[i]](FileBytes&& file) {
+         wave = ParseWave(std::move(file.data), file.size);
+         });
+   }
+}
+
+void SoundSystem::Load(AssetPack const& pack) {
+   loaded_ = true;
+   auto create = [this, &pack](std::string const& name) -> std::unique_ptr<DirectX::SoundEffect> {
+      auto entry = pack.Find(name);
+      if (!entry || entry->kind != PackKind::Sound) {
+         Log::Write(LogLevel::Error, "{} is not in the asset pack", name);
+         return nullptr;
+      }
+      // SoundEffect insists on owning a buffer, but the samples and their
+      // format stay in the pack's mapping
+      auto owner = std::make_unique<std::uint8_t[]>(1);
+      auto format = reinterpret_cast<WAVEFORMATEX const*>(pack.At(entry->waveFormat));
+      return std::make_unique<DirectX::SoundEffect>(audioEngine_.get(), owner, format, pack.At(entry->offset), std::size_t(entry->size));
+   };
+   try {
+      auto files = SoundFiles();
+      defeat_ = create(files[0]);
+      win_ = create(files[1]);
+      for (std::size_t i = 2; i < files.size(); i++) {
+         if (auto pig = create(files[i])) pigSounds_.push_back(std::move(pig));
+      }
+   }
+   catch (const std::exception& exc) {
+      Log::Error(exc.what());
+   }
+}
+
+void SoundSystem::Poll(AssetLoader const& loader) {
+   // nothing was queued when the sounds come from the pack
+   if (loaded_ || waves_.empty() || !loader.Ready(AssetPriority::Deferred)) return;
+   loaded_ = true;
+   try {
+      // a sound that failed to load stays silent
+      defeat_ = Create(waves_[0]);
+      win_ = Create(waves_[1]);
+      for (std::size_t i = 2; i < waves_.size(); i++) {
+         if (auto pig = Create(waves_[i])) pigSounds_.push_back(std::move(pig));
+      }
+   }
+   catch (const std::exception& exc) {
+      Log::Error(exc.what());
+   }
+   waves_.clear();
+}
+
+std::unique_ptr<DirectX::SoundEffect> SoundSystem::Create(WaveFile& wave) {
+   if (!wave.data || !audioEngine_) return nullptr;
+   // the samples stay where they are in the file, now owned by the effect
+   auto format = reinterpret_cast<WAVEFORMATEX const*>(wave.Format());
+   auto samples = wave.Samples();
+   return std::make_unique<DirectX::SoundEffect>(audioEngine_.get(), wave.data, format, samples, wave.samplesSize);
+}
+
+void SoundSystem::PlayDefeat() {
+   if (defeat_) defeat_->Play();
+}
+
+void SoundSystem::PlayWin() {
+   if (win_) win_->Play();
+}
+
 void SoundSystem::PlayPig() {
-   std::random_device dev;
-   std::mt19937 rng(dev());
-   std::uniform_int_distribution<std::mt19937::result_type> dist(0, PIG_SOUNDS_NUMBER - 1);
-   pigSounds_[dist(rng)]->Play();
+   if (pigSounds_.empty()) return;
+   pigSounds_[Bounded(rng_, pigSounds_.size())]->Play();
 }
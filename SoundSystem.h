@@ -1,15 +1,33 @@
 #pragma once
 
+#include "Engine/AssetLoader.h"
+#include "Engine/AssetPack.h"
+#include "Engine/Random.h"
+#include "Engine/Wave.h"
+
 class SoundSystem {
 private:
    std::unique_ptr<DirectX::AudioEngine> audioEngine_;
    std::vector<std::unique_ptr<DirectX::SoundEffect>> pigSounds_ = {};
+   std::unique_ptr<DirectX::SoundEffect> defeat_;
+   std::unique_ptr<DirectX::SoundEffect> win_;
+   // decoded on the loader's threads: defeat, win, then the pigs
+   std::vector<WaveFile> waves_;
+   bool loaded_ = false;
+   Xoshiro256 rng_{ RandomSeed() };
 
-public:
-   std::unique_ptr<DirectX::SoundEffect> defeat;
-   std::unique_ptr<DirectX::SoundEffect> win;
+   std::unique_ptr<DirectX::SoundEffect> Create(WaveFile& wave);
 
+public:
    ~SoundSystem();
    bool Init();
+   // Queues the sound files on `loader`; none is needed for the first frame.
+   void Load(AssetLoader& loader);
+   // Plays the sounds from `pack`, which must outlive them. After Init.
+   void Load(AssetPack const& pack);
+   // Makes the sounds once the loader has them. Until then nothing plays.
+   void Poll(AssetLoader const& loader);
+   void PlayDefeat();
+   void PlayWin();
    void PlayPig();
-};
\ No newline at end of file
+};
@@ -4,7 +4,7 @@
 #include "Game.h"
 
 namespace Texture {
-   auto constexpr FILENAME = L"img/texture.png";
+   auto constexpr FILENAME = "img/texture.png";
    auto constexpr CELL_WIDTH = 64;
    auto constexpr CELL_HEIGHT = 64;
    auto constexpr NUMBER_WIDTH = 48;
@@ -34,9 +34,88 @@ auto constexpr CELL_HEIGHT = Texture::CELL_HEIGHT * Texture::SCALING;
 auto constexpr NUMBER_WIDTH_HALF = CELL_WIDTH / 2 * Texture::SCALING;
 auto constexpr NUMBER_HEIGHT_HALF = CELL_HEIGHT / 2 * Texture::SCALING;
 
+namespace Assets {
+   // made by the cooker at build time; without it the loose files are loaded
+   auto constexpr PACK_FILENAME = "assets.pack";
+}
+
+namespace Generation {
+   // bounds the wait on the first click of a large no-guess board, searched
+   // for by the pool or, when it cannot take the request, on the spot
+   auto constexpr NO_GUESS_ATTEMPTS = BoardPool::MAX_NO_GUESS_ATTEMPTS;
+   // how often a first click waiting for its no-guess board looks for it
+   auto constexpr NO_GUESS_POLL = std::chrono::milliseconds(5);
+}
+
+namespace Shaders {
+   auto constexpr TILE_MAP = L"shaders/TileMap.hlsl";
+
+   // matches the cbuffer in TileMap.hlsl
+   struct TileConstants {
+      DirectX::XMFLOAT2 viewportSize;
+      DirectX::XMFLOAT2 cellSize;
+      DirectX::XMFLOAT2 atlasSize;
+      float numberScale;
+      float markScale;
+      DirectX::XMFLOAT4 cellRect;
+      DirectX::XMFLOAT4 flagRect;
+      DirectX::XMFLOAT4 questionRect;
+      DirectX::XMFLOAT4 mineRect;
+      DirectX::XMFLOAT4 digitRect;
+      DirectX::XMFLOAT4 offsets;
+      DirectX::XMFLOAT4 background;
+      DirectX::XMFLOAT4 lodCovered;
+      DirectX::XMFLOAT4 lodFlagged;
+      DirectX::XMFLOAT4 lodMine;
+      std::array<DirectX::XMFLOAT4, 8> tints;
+   };
+   static_assert(sizeof(TileConstants) % 16 == 0);
+
+   // matches the camera cbuffer in TileMap.hlsl, written every frame
+   struct CameraConstants {
+      DirectX::XMFLOAT2 fieldOrigin;
+      float blockSize;
+      std::uint32_t levelWidth;
+      DirectX::XMUINT2 rangeOrigin;
+      std::uint32_t rangeWidth;
+      float padding;
+   };
+   static_assert(sizeof(CameraConstants) % 16 == 0);
+
+   Microsoft::WRL::ComPtr<ID3DBlob> Compile(LPCWSTR path, LPCSTR entry, LPCSTR target) {
+      Microsoft::WRL::ComPtr<ID3DBlob> code;
+      Microsoft::WRL::ComPtr<ID3DBlob> errors;
+      auto hr = D3DCompileFromFile(path, nullptr, nullptr, entry, target, D3DCOMPILE_OPTIMIZATION_LEVEL3, 0,
+         code.GetAddressOf(), errors.GetAddressOf());
+      if (errors) Log::Error(static_cast<char const*>(errors->GetBufferPointer()));
+      DX::ThrowIfFailed(hr, "Failed to compile a shader");
+      return code;
+   }
+}
+
+namespace Logging {
+   // the previous runs' logs are kept as log.1.txt and on, see Engine/Logger.h
+   auto constexpr FILENAME = "log.txt";
+}
+
+namespace Profiling {
+   // written on exit when profiling, see Engine/Profiler.h
+   auto constexpr TRACE_FILENAME = "trace.json";
+}
+
+namespace Replays {
+   auto constexpr DIRECTORY = "replays";
+}
+
 namespace UI {
    auto constexpr MINES_COUNT_CHAR_NUMBER = 3;
-   auto constexpr TOP_PANEL_WIDTH = CELLS_X * CELL_WIDTH;
+   // the counters show what fits, a minus taking a place
+   auto constexpr MAX_SHOWN = [] {
+      auto shown = 1;
+      for (auto i = 0; i < MINES_COUNT_CHAR_NUMBER; i++) shown *= 10;
+      return shown - 1;
+   }();
+   auto constexpr MIN_SHOWN = -(MAX_SHOWN / 10);
    auto constexpr TOP_PANEL_HEIGHT = Texture::CELL_HEIGHT * 2;
    RECT TOP_LEFT_CORNER = { 0, 0, 5, 5 };
    RECT TOP_RIGHT_CORNER = { 59, 0, 64, 5 };
@@ -47,15 +126,46 @@ namespace UI {
    RECT LEFT_VERTICAL_LINE = { 0, 5, 5, 6 };
    RECT RIGHT_VERTICAL_LINE = { 59, 5, 64, 6 };
    RECT BACKGROUND_RECT = { 5,5, 6,6 };
+   // a larger board gets a window this size and is scrolled, see Camera.h
+   auto constexpr MAX_FIELD_WIDTH = 1280L;
+   auto constexpr MAX_FIELD_HEIGHT = 800L;
+   // zoom per wheel notch
+   auto constexpr ZOOM_STEP = 1.25f;
+   // arrow key scrolling, in pixels per second; a longer step is cut short
+   // rather than jumping after the loop slept
+   auto constexpr PAN_SPEED = 800.0f;
+   auto constexpr PAN_STEP_LIMIT = GameClock::Duration(50'000);
+}
+
+Game::Game(BoardSize size, bool noGuess, FrameScheduler frames) :
+   frames_(frames),
+   size_(size),
+   noGuess_(noGuess),
+   data_{ Board(size) },
+   boards_({ PoolKey{ size, SafeZone::Cell } }, 1),
+   dirtyCells_(size.width, size.height),
+   tiles_(size.width, size.height),
+   lod_(size.width, size.height),
+   camera_(size.width, size.height, CELL_WIDTH, size.width * CELL_WIDTH, size.height * CELL_HEIGHT) {
 }
 
 Game::~Game() {
-   Log::file.close();
+   EndReplay();
+   auto& stats = frames_.Stats();
+   Log::Write(LogLevel::Info, "Frames: {} drawn, {} turns idle, {:.1f} sprites and {:.3f} ms CPU per frame, {:.1f}% of a core",
+      stats.frames, stats.skipped, stats.SpritesPerFrame(), stats.CpuPerFrameMs(), 100 * stats.CpuShare());
+   Log::Write(LogLevel::Info, "Input: {} events, {} merged, {} clicks and marks applied {:.3f} ms after input on average, {:.3f} ms at most",
+      input_.Pushed(), input_.Coalesced(), inputLatency_.count, inputLatency_.MeanMs(), inputLatency_.MaxMs());
+   Log::Close();
+#ifdef MINESWEEPER_PROFILE
+   std::ofstream trace(Profiling::TRACE_FILENAME, std::ios::binary | std::ios::trunc);
+   Profile::WriteChromeTrace(trace);
+#endif
 }
 
 void Game::GetDefaultSize(long& width, long& height) {
-   width = CELLS_X * CELL_WIDTH;
-   height = CELLS_Y * CELL_HEIGHT + UI::TOP_PANEL_HEIGHT;
+   width = std::min(long(size_.width * CELL_WIDTH), UI::MAX_FIELD_WIDTH);
+   height = std::min(long(size_.height * CELL_HEIGHT), UI::MAX_FIELD_HEIGHT) + UI::TOP_PANEL_HEIGHT;
 }
 
 bool Game::ExitGame() {
@@ -63,13 +173,22 @@ bool Game::ExitGame() {
    return true;
 }
 
-void Game::OnMouseMove() {
-   if (data_.gameState != GameState::Play) return;
-   auto mouse = mouse_->GetState();
-   int x = mouse.x / CELL_WIDTH;
-   int y = std::floor((mouse.y - UI::TOP_PANEL_HEIGHT) / CELL_HEIGHT);
-   selectedCell_.x = x;
-   selectedCell_.y = y;
+void Game::OnInput(InputEvent const& event) {
+   input_.Push(event);
+}
+
+// Selects the cell under the pointer at (x, y).
+void Game::Select(int x, int y) {
+   if (data_.board.State() != GameState::Play) return;
+   // the field scrolls under the panel, so cells can be mapped there too
+   auto cell = y < UI::TOP_PANEL_HEIGHT ? Pos{ -1, -1 } :
+      camera_.CellAt(float(x), float(y - UI::TOP_PANEL_HEIGHT));
+   if (selectedCell_.x != cell.x || selectedCell_.y != cell.y) frames_.Invalidate(Dirty::HoverChanged);
+   selectedCell_ = cell;
+}
+
+void Game::OnPaint() {
+   frames_.Invalidate(Dirty::AllChanged);
 }
 
 bool Game::Init(HINSTANCE hInstance, HWND hwnd) {
@@ -81,200 +200,189 @@ bool Game::Init(HINSTANCE hInstance, HWND hwnd) {
 
    width_ = dimensions.right - dimensions.left;
    height_ = dimensions.bottom - dimensions.top;
+   camera_.Resize(float(width_), float(height_ - UI::TOP_PANEL_HEIGHT));
 
-   Log::file.open("log.txt");
+   Log::Open(LoggerOptions{ .path = Logging::FILENAME });
 
    auto d3dSuccess = d3d_.Init(hwnd, width_, height_);
+   OpenPack();
+   if (!pack_) {
+      // the texture first, as the pool takes loads in order; the sounds are
+      // read while the audio engine starts and may come after the first frame
+      if (d3dSuccess) LoadTexture();
+      sound_.Load(assets_);
+   }
    auto soundSuccess = sound_.Init();
-
-   keyboard_ = std::make_unique<DirectX::Keyboard>();
-   mouse_ = std::make_unique<DirectX::Mouse>();
-   mouse_->SetWindow(hwnd);
-
-   InitCells();
+   if (pack_ && soundSuccess) sound_.Load(*pack_);
 
    return d3dSuccess && soundSuccess && LoadContent();
 }
 
-void Game::InitCells() {
-   for (auto x = 0; x < CELLS_X; x++) {
-      for (auto y = 0; y < CELLS_Y; y++) {
-         data_.cells[x][y] = Cell();
-      }
-   }
-}
-
-void Game::InitMines(int originX, int originY) {
-   std::random_device dev;
-   std::mt19937 rng(dev());
-   std::uniform_int_distribution<std::mt19937::result_type> distX(0,
-      CELLS_X - 1);
-   std::uniform_int_distribution<std::mt19937::result_type> distY(0,
-      CELLS_Y - 1);
-
-   auto i = 0;
-   while (i < MINES_COUNT) {
-      auto x = distX(rng);
-      auto y = distY(rng);
-      auto cell = GetCell(x, y);
-      if (cell->mined || (originX == x && originY == y)) continue;
-      cell->mined = true;
-      i++;
+void Game::PressedAround(int originX, int originY) {
+   auto cell = data_.board.At(originX, originY);
+   if (!cell.IsMarked()) data_.pressed.push_back({ originX, originY });
+   if (cell.IsOpened() && cell.MinesNear() > 0) {
+      data_.board.IterateNear(originX, originY, [this](int x, int y) {
+         if (!data_.board.At(x, y).IsMarked()) data_.pressed.push_back({ x, y });
+         });
    }
 }
 
-Cell* Game::GetCell(int x, int y) {
-   return &data_.cells[x][y];
+void Game::UnpressedAll() {
+   data_.pressed.clear();
 }
 
-void Game::OpenAt(int x, int y) {
-   auto cell = GetCell(x, y);
-   if (cell->IsMarked() || cell->opened) return;
-
-   cell->opened = true;
-
-   if (!data_.started) {
-      Start(x, y);
-   }
-
-   if (cell->mined) {
-      Defeat();
-      return;
-   }
-
-   auto mines = 0;
-   IterateNear(x, y, [this, &mines](int x, int y) {
-      auto cell = GetCell(x, y);
-      mines += cell->mined ? 1 : 0;
+bool Game::IsPressed(int x, int y) {
+   return std::any_of(data_.pressed.begin(), data_.pressed.end(), [x, y](Pos const& pos) {
+      return pos.x == x && pos.y == y;
       });
-   cell->minesNear = mines;
-
-   data_.opened++;
-   if (data_.opened == NEED_TO_OPEN) Win();
-}
-
-void Game::IterateAll(std::function<void(Cell* cell)> cb) {
-   for (auto begin = &data_.cells[0][0]; begin <= &data_.cells[CELLS_X - 1][CELLS_Y - 1]; begin++) {
-      cb(begin);
-   }
 }
 
-void Game::IterateNear(int originX, int originY, std::function<void(int, int)> cb) {
-   auto minX = std::max(0, originX - 1);
-   auto minY = std::max(0, originY - 1);
-   auto maxX = std::min(CELLS_X - 1, originX + 1);
-   auto maxY = std::min(CELLS_Y - 1, originY + 1);
-   auto mines = 0;
-   for (auto x = minX; x <= maxX; x++) {
-      for (auto y = minY; y <= maxY; y++) {
-         cb(x, y);
+void Game::ClickAt(int x, int y) {
+   if (noGuess_ && !data_.board.Started()) {
+      // still waiting for the board of the first click
+      if (noGuessClick_) return;
+      // the search runs on the pool's worker, usually since the button went
+      // down, and the click is played once it is done; see PollNoGuess
+      if (boards_.RequestNoGuess(size_, { x, y }, Generation::NO_GUESS_ATTEMPTS)) {
+         noGuessClick_ = Pos{ x, y };
+         PollNoGuess();
+         return;
       }
+      // the worker is not taking requests, so search here after all
+      auto found = FindNoGuessSeed(size_, { x, y }, data_.board.Seed(), Generation::NO_GUESS_ATTEMPTS);
+      if (found.seed) data_.board = Board(size_, NO_GUESS_ZONE, *found.seed);
+      else Log::Error("No board without guesses found, playing a random one");
    }
+   OpenAt(x, y);
 }
 
-void Game::ExploreMap(int originX, int originY) {
-   auto cell = GetCell(originX, originY);
-   if (data_.gameState != GameState::Play || cell->opened || cell->IsMarked()) return;
-   OpenAt(originX, originY);
-   if (cell->minesNear == 0) {
-      IterateNear(originX, originY, [this](int x, int y) {
-         ExploreMap(x, y);
-         });
+void Game::PollNoGuess() {
+   if (!noGuessClick_) return;
+   auto found = boards_.TakeNoGuess();
+   if (!found) {
+      frames_.WakeAt(FrameScheduler::Clock::now() + Generation::NO_GUESS_POLL);
+      return;
    }
-}
-
-void Game::OpenNearForced(int originX, int originY) {
-   auto cell = GetCell(originX, originY);
-   if (!(cell->opened && cell->minesNear > 0)) return;
-   auto flagged = 0;
-   IterateNear(originX, originY, [this, &flagged](int x, int y) {
-      auto cell = GetCell(x, y);
-      flagged += cell->state == RCellState::Flagged ? 1 : 0;
-      });
-   if (cell->minesNear == flagged) {
-      IterateNear(originX, originY, [this](int x, int y) {
-         ExploreMap(x, y);
-         });
+   auto first = *noGuessClick_;
+   noGuessClick_.reset();
+   if (*found) {
+      // swapped, so the random board is freed by the pool's worker
+      std::swap(data_.board, **found);
+      boards_.Recycle(std::move(*found));
    }
-}
-
-void Game::PressedAround(int originX, int originY) {
-   auto cell = GetCell(originX, originY);
-   cell->pressed = cell->IsMarked() ? false : true;
-   if (cell->minesNear > 0) {
-      IterateNear(originX, originY, [this](int x, int y) {
-         auto cell = GetCell(x, y);
-         cell->pressed = cell->IsMarked() ? false : true;
-         });
+   else {
+      Log::Error("No board without guesses found, playing a random one");
    }
+   OpenAt(first.x, first.y);
 }
 
-void Game::UnpressedAll() {
-   IterateAll([](Cell* cell) {
-      cell->pressed = false;
-      });
-}
-
-void Game::ClickAt(int x, int y) {
-   auto cell = GetCell(x, y);
-   if (cell->opened && cell->minesNear > 0) {
-      return OpenNearForced(x, y);
-   }
-   ExploreMap(x, y);
+void Game::OpenAt(int x, int y) {
+   if (!data_.board.Started()) data_.clock.Start();
+   Record(ReplayAction::Click, x, y);
+   auto result = data_.board.Click(x, y);
+   PROFILE_COUNT("cells opened", result.changed.size());
+   OnAction(result);
 }
 
 void Game::MarkAt(int x, int y) {
-   auto cell = GetCell(x, y);
-   if (!cell->opened) {
-      cell->ToggleState();
-      if (cell->state == RCellState::Flagged) data_.flagged++;
-      if (cell->state == RCellState::Questioned) data_.flagged--;
+   // the board of a no-guess game is not chosen yet
+   if (noGuess_ && !data_.board.Started()) return;
+   Record(ReplayAction::Flag, x, y);
+   OnAction(data_.board.Flag(x, y));
+}
+
+void Game::OnAction(ActionResult const& result) {
+   if (result.state != GameState::Play) {
+      data_.clock.Stop();
+      EndReplay();
+      // the mines are shown once the game is lost
+      dirtyCells_.MarkAll();
    }
+   if (result.changed.empty()) return;
+   dirtyCells_.Mark(result.changed);
+   frames_.Invalidate(Dirty::BoardChanged | Dirty::PanelChanged);
+   if (showOdds_) UpdateOdds();
+   if (result.state == GameState::Defeat) sound_.PlayDefeat();
+   if (result.state == GameState::Win) sound_.PlayWin();
 }
 
-bool Game::IsCellSelected(int x, int y) {
-   auto cell = GetCell(x, y);
-   return selectedCell_.x == x && selectedCell_.y == y && !cell->IsMarked();
+void Game::UpdateOdds() {
+   Solver solver(data_.board);
+   solver.Solve();
+   odds_ = MineProbabilities(data_.board, solver);
+   dirtyCells_.MarkAll();
 }
 
-void Game::Start(int x, int y) {
-   data_.started = true;
-
-   InitMines(x, y);
+bool Game::IsCellSelected(int x, int y) {
+   auto cell = data_.board.At(x, y);
+   return selectedCell_.x == x && selectedCell_.y == y && !cell.IsMarked();
 }
 
-void Game::Defeat() {
-   data_.gameState = GameState::Defeat;
-   sound_.defeat->Play();
+void Game::Restart() {
+   sound_.PlayPig();
+   EndReplay();
+   // a first click still waiting for its board belongs to the old game
+   noGuessClick_.reset();
+   // swapped rather than assigned, so the old board is freed by the pool's worker
+   auto board = boards_.Take({ size_, SafeZone::Cell });
+   if (!board) board = std::make_unique<Board>(size_);
+   auto fresh = GameData{ std::move(*board) };
+   std::swap(data_, fresh);
+   // the pressed cells keep their memory, as the board its scratch
+   std::swap(data_.pressed, fresh.pressed);
+   data_.pressed.clear();
+   *board = std::move(fresh.board);
+   boards_.Recycle(std::move(board));
+   recording_ = false;
+   dirtyCells_.MarkAll();
+   frames_.Invalidate(Dirty::AllChanged);
+   if (showOdds_) UpdateOdds();
+}
+
+// The replay file is opened on the first action, so games restarted
+// untouched leave nothing behind.
+void Game::Record(ReplayAction action, int x, int y) {
+   if (!recording_) {
+      recording_ = true;
+      std::error_code error;
+      std::filesystem::create_directories(Replays::DIRECTORY, error);
+      replayPath_ = std::format("{}/{:016x}.msrp", Replays::DIRECTORY, data_.board.Seed());
+      replayFile_.open(replayPath_, std::ios::binary | std::ios::trunc);
+      if (replayFile_) {
+         replay_.emplace(replayFile_, ReplayHeader{ size_, data_.board.Zone(), data_.board.Seed() });
+      }
+      else {
+         Log::Error("Failed to open a replay file");
+      }
+   }
+   auto split = data_.clock.Split();
+   if (replay_) replay_->Record(action, { x, y }, split);
 }
 
-void Game::Win() {
-   data_.gameState = GameState::Win;
-   sound_.win->Play();
-}
+void Game::EndReplay() {
+   if (!replay_) return;
+   replay_->Finish(EndOf(data_.board), data_.clock.Elapsed());
+   replay_.reset();
+   replayFile_.close();
 
-void Game::Restart() {
-   sound_.PlayPig();
-   data_ = GameData();
+   auto first = data_.board.FirstClick();
+   auto elapsed = data_.clock.Elapsed();
+   Log::Write(LogLevel::Info, "Game {}x{} {} mines seed {:016x} first click {},{} in {}.{:06}s recorded to {}",
+      size_.width, size_.height, size_.mines, data_.board.Seed(), first.x, first.y,
+      elapsed / 1'000'000, elapsed % 1'000'000, replayPath_.string());
 }
 
-std::vector<char> Game::GetDigits(int number) {
-   std::vector<char> digits;
-   int rest = number >= std::pow(10, UI::MINES_COUNT_CHAR_NUMBER) ?
-      std::pow(10, UI::MINES_COUNT_CHAR_NUMBER) - 1 :
-      number <= -std::pow(10, UI::MINES_COUNT_CHAR_NUMBER - 1) ?
-      std::pow(10, UI::MINES_COUNT_CHAR_NUMBER - 1) - 1 :
-      number;
-   auto i = 0;
+// Written from the end of `buffer` back; returns the part written.
+std::span<char const> Game::GetDigits(int number, std::span<char> buffer) {
+   auto rest = std::clamp(number, UI::MIN_SHOWN, UI::MAX_SHOWN);
+   auto at = buffer.size();
    do {
-      auto digit = std::abs(rest % 10);
-      digits.push_back(digit);
+      buffer[--at] = char(std::abs(rest % 10));
       rest /= 10;
-      i++;
    } while (rest != 0);
-   if (number < 0) digits.push_back('-');
-   std::reverse(digits.begin(), digits.end());
-   return digits;
+   if (number < 0) buffer[--at] = '-';
+   return buffer.subspan(at);
 }
 
 bool Game::LoadContent() {
@@ -283,9 +391,10 @@ bool Game::LoadContent() {
    textureSpriteBatch_ = std::make_unique<DirectX::DX11::SpriteBatch>(d3d_.ctx_.Get());
    states_ = std::make_unique<DirectX::DX11::CommonStates>(d3d_.device_.Get());
 
+   if (pack_) CreatePackedTexture();
+   else assets_.Wait(AssetPriority::Critical);
    Microsoft::WRL::ComPtr<ID3D11Resource> resource;
-   DX::ThrowIfFailed(DirectX::CreateWICTextureFromFile(d3d_.device_.Get(),
-      Texture::FILENAME, resource.GetAddressOf(), texture_.ReleaseAndGetAddressOf()), "Failed to create a texture from a file");
+   texture_->GetResource(resource.GetAddressOf());
 
    Microsoft::WRL::ComPtr<ID3D11Texture2D> cell;
    DX::ThrowIfFailed(resource.As(&cell), "Failed to set a resource");
@@ -296,53 +405,146 @@ bool Game::LoadContent() {
    origin_.x = 0;
    origin_.y = 0;
 
+   CreateTileMap(cellDesc.Width, cellDesc.Height);
+
    Log::Info("Game::LoadContent end");
 
    return true;
 }
 
-void Game::Update(float dt) {
-   auto kb = keyboard_->GetState();
-   auto mouseState = mouse_->GetState();
-   keyTracker_.Update(kb);
-   mouseTracker_.Update(mouseState);
-
-   if (keyTracker_.IsKeyReleased(DirectX::Keyboard::Escape)) {
-      ExitGame();
+// A pack that cannot be read, or lacks the texture, is passed over for the
+// loose files.
+void Game::OpenPack() {
+   if (!std::filesystem::exists(Assets::PACK_FILENAME)) return;
+   auto start = std::chrono::steady_clock::now();
+   try {
+      auto pack = std::make_unique<AssetPack>(Assets::PACK_FILENAME);
+      if (!pack->Find(Texture::FILENAME)) throw std::runtime_error("no texture in it");
+      pack_ = std::move(pack);
+      Log::Write(LogLevel::Info, "Mapped {}: {} assets, {} KiB in {:.2f} ms", Assets::PACK_FILENAME, pack_->Entries().size(), pack_->Size() / 1024,
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
    }
+   catch (std::exception const& exc) {
+      Log::Write(LogLevel::Error, "Not using {}: {}", Assets::PACK_FILENAME, exc.what());
+   }
+}
 
-   leftHeld_ = mouseTracker_.leftButton == DirectX::Mouse::ButtonStateTracker::HELD;
-
-   UnpressedAll();
+// The device copies the levels straight out of the mapping.
+void Game::CreatePackedTexture() {
+   auto const& entry = *pack_->Find(Texture::FILENAME);
+   CD3D11_TEXTURE2D_DESC desc(entry.format == PackFormat::Rgba8Srgb ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM,
+      entry.width, entry.height, 1, entry.levels, D3D11_BIND_SHADER_RESOURCE, D3D11_USAGE_IMMUTABLE);
+   std::vector<D3D11_SUBRESOURCE_DATA> levels(entry.levels);
+   auto at = pack_->At(entry.offset);
+   for (std::uint32_t level = 0; level < entry.levels; level++) {
+      levels[level] = { at, std::max(entry.width >> level, 1u) * 4, 0 };
+      at += LevelSize(entry, level);
+   }
+   Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+   DX::ThrowIfFailed(d3d_.device_->CreateTexture2D(&desc, levels.data(), texture.GetAddressOf()), "Failed to create the packed texture");
+   DX::ThrowIfFailed(d3d_.device_->CreateShaderResourceView(texture.Get(), nullptr, texture_.ReleaseAndGetAddressOf()),
+      "Failed to create a view of the packed texture");
+}
+
+// Decoded on a pool thread: WIC needs COM there, and creating resources on
+// the device is free-threaded.
+void Game::LoadTexture() {
+   assets_.Load(Texture::FILENAME, Texture::FILENAME, AssetPriority::Critical, [this](FileBytes&& file) {
+      auto com = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+      auto result = DirectX::CreateWICTextureFromMemory(d3d_.device_.Get(), file.data.get(), file.size,
+         nullptr, texture_.ReleaseAndGetAddressOf());
+      if (SUCCEEDED(com)) CoUninitialize();
+      DX::ThrowIfFailed(result, "Failed to create a texture from a file");
+      });
+}
 
-   if (leftHeld_) {
-      if (data_.gameState == GameState::Play && selectedCell_.IsInBounds()) PressedAround(selectedCell_.x, selectedCell_.y);
-      restartButtonPressed_ = PtInRect(&restartButtonRect_, POINT(mouseState.x, mouseState.y));
+void Game::LogAssetTimings() {
+   auto ms = [](AssetTiming::Duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+   for (auto const& timing : assets_.Timings()) {
+      if (!timing.error.empty()) {
+         Log::Write(LogLevel::Error, "Asset {} failed: {}", timing.name, timing.error);
+         continue;
+      }
+      Log::Write(LogLevel::Info, "Asset {}: {} KiB, queued {:.2f} ms, read in {:.2f} ms, decoded in {:.2f} ms, ready {:.2f} ms after start",
+         timing.name, timing.bytes / 1024, ms(timing.waited), ms(timing.read), ms(timing.decoded), ms(timing.done));
    }
+}
 
-   if (mouseTracker_.leftButton == DirectX::Mouse::ButtonStateTracker::RELEASED) {
-      if (data_.gameState == GameState::Play && selectedCell_.IsInBounds()) ClickAt(selectedCell_.x, selectedCell_.y);
-      if (PtInRect(&restartButtonRect_, POINT(mouseState.x, mouseState.y))) Restart();
-      restartButtonPressed_ = false;
+void Game::Update(GameClock::Duration dt) {
+   PROFILE_SCOPE("Game::Update");
+   // zero in steady state; starting or ending a game allocates
+   PROFILE_ALLOCATIONS("allocations in Game::Update");
+   // the sounds are picked up once they are all in, see Init
+   if (!assetsReady_ && assets_.Ready(AssetPriority::Deferred)) {
+      assetsReady_ = true;
+      sound_.Poll(assets_);
+      LogAssetTimings();
+   }
+   auto seconds = data_.clock.Seconds();
+   data_.clock.Advance(dt);
+   if (data_.clock.Seconds() != seconds) frames_.Invalidate(Dirty::TimerChanged);
+   if (data_.clock.Running()) {
+      auto untilNextSecond = GameClock::Duration(1'000'000 - data_.clock.Elapsed() % 1'000'000);
+      frames_.WakeAt(FrameScheduler::Clock::now() + untilNextSecond);
    }
 
-   if (mouseTracker_.rightButton == DirectX::Mouse::ButtonStateTracker::RELEASED) {
-      if (data_.gameState == GameState::Play && selectedCell_.IsInBounds()) MarkAt(selectedCell_.x, selectedCell_.y);
+   pressedBefore_.assign(data_.pressed.begin(), data_.pressed.end());
+   auto restartPressedBefore = restartButtonPressed_;
+   auto zoom = camera_.Zoom();
+   auto originX = camera_.OriginX();
+   auto originY = camera_.OriginY();
+
+   // everything since the last update, in the order it came
+   actions_.clear();
+   InputEvent event;
+   while (input_.Pop(event)) dispatcher_.Apply(event, actions_);
+   for (auto const& action : actions_) ApplyInput(action);
+   PollNoGuess();
+   ScrollWithKeys(dt);
+
+   if (camera_.Zoom() != zoom || camera_.OriginX() != originX || camera_.OriginY() != originY) {
+      frames_.Invalidate(Dirty::BoardChanged);
+      // the pointer may be over another cell now
+      Select(dispatcher_.X(), dispatcher_.Y());
    }
-}
 
-void Game::Thread() {
-   if (data_.gameState == GameState::Play && data_.started) data_.timer++;
+   // what the held button presses, as of the last event
+   UnpressedAll();
+   auto leftHeld = dispatcher_.Held(MouseButton::Left);
+   if (leftHeld && data_.board.State() == GameState::Play && data_.board.Contains(selectedCell_.x, selectedCell_.y)) {
+      PressedAround(selectedCell_.x, selectedCell_.y);
+      // the first click of a no-guess game most likely lands here, so the
+      // search for its board starts now rather than on the release
+      if (noGuess_ && !data_.board.Started() && !noGuessClick_) {
+         boards_.RequestNoGuess(size_, selectedCell_, Generation::NO_GUESS_ATTEMPTS);
+      }
+   }
+   restartButtonPressed_ = leftHeld && PtInRect(&restartButtonRect_, POINT(dispatcher_.X(), dispatcher_.Y()));
+
+   auto samePressed = std::equal(pressedBefore_.begin(), pressedBefore_.end(), data_.pressed.begin(), data_.pressed.end(),
+      [](Pos const& a, Pos const& b) { return a.x == b.x && a.y == b.y; });
+   if (!samePressed) {
+      dirtyCells_.Mark(pressedBefore_);
+      dirtyCells_.Mark(data_.pressed);
+      frames_.Invalidate(Dirty::BoardChanged);
+   }
+   if (restartButtonPressed_ != restartPressedBefore) frames_.Invalidate(Dirty::PanelChanged);
 }
 
 void Game::Draw(DirectX::XMFLOAT2 const& pos, RECT const* sourceRectangle, DirectX::FXMVECTOR color = DirectX::Colors::White, float scaling = 1, DirectX::SpriteEffects effects = DirectX::SpriteEffects_None) {
    textureSpriteBatch_->Draw(texture_.Get(), pos, sourceRectangle, color, .0f, origin_, scaling, effects);
+   sprites_++;
 }
 
 void Game::Draw(DirectX::XMFLOAT2 const& pos, RECT const* sourceRectangle, DirectX::SpriteEffects effects) {
    Draw(pos, sourceRectangle, DirectX::Colors::White, 1.0f, effects);
 }
 
+void Game::Stretch(RECT const& destination, RECT const* sourceRectangle, DirectX::SpriteEffects effects = DirectX::SpriteEffects_None) {
+   textureSpriteBatch_->Draw(texture_.Get(), destination, sourceRectangle, DirectX::Colors::White, .0f, origin_, effects);
+   sprites_++;
+}
+
 void Game::RenderPanel(RECT rect, PanelState state = PanelState::Out) {
    auto width = rect.right - rect.left;
    auto height = rect.bottom - rect.top;
@@ -388,35 +590,25 @@ void Game::RenderPanel(RECT rect, PanelState state = PanelState::Out) {
    DirectX::XMFLOAT2 brcAt = { rect.left + float(width - brcWidth), rect.top + float(height - brcHeight) };
    Draw(brcAt, brc, brcFlip);
 
-   for (auto x = tlcWidth; x <= width - trcWidth; x++) { // horizontally
-      DirectX::XMFLOAT2 at = { rect.left + float(x), float(rect.top) };
-      Draw(at, topHorizLine, topHorizLineFlip);
-      at.y = rect.top + height - blcHeight;
-      Draw(at, bottomHorizLine, bottomHorizLineFlip);
-   }
-
-   for (auto y = tlcHeight; y <= height - blcHeight; y++) { // vertically
-      DirectX::XMFLOAT2 at = { float(rect.left), rect.top + float(y) };
-      Draw(at, leftVertLine, leftVertLineFlip);
-      at.x = rect.left + width - trcWidth;
-      Draw(at, rightVertLine, rightVertLineFlip);
-   }
-
-   for (auto x = tlcWidth; x <= width - trcWidth - 1; x++) { // fill center
-      for (auto y = tlcHeight; y <= height - blcHeight - 1; y++) {
-         DirectX::XMFLOAT2 at = { rect.left + float(x), rect.top + float(y) };
-         Draw(at, &UI::BACKGROUND_RECT);
-      }
-   }
+   // edges and centre: the sources are one texel wide or high, so stretching
+   // them under the point sampler repeats that texel exactly
+   auto lineHeight = UI::TOP_HORIZONTAL_LINE.bottom - UI::TOP_HORIZONTAL_LINE.top;
+   auto lineWidth = UI::LEFT_VERTICAL_LINE.right - UI::LEFT_VERTICAL_LINE.left;
+   Stretch({ rect.left + tlcWidth, rect.top, rect.right - trcWidth, rect.top + lineHeight }, topHorizLine, topHorizLineFlip);
+   Stretch({ rect.left + tlcWidth, rect.bottom - blcHeight, rect.right - trcWidth, rect.bottom - blcHeight + lineHeight }, bottomHorizLine, bottomHorizLineFlip);
+   Stretch({ rect.left, rect.top + tlcHeight, rect.left + lineWidth, rect.bottom - blcHeight }, leftVertLine, leftVertLineFlip);
+   Stretch({ rect.right - trcWidth, rect.top + tlcHeight, rect.right - trcWidth + lineWidth, rect.bottom - blcHeight }, rightVertLine, rightVertLineFlip);
+   Stretch({ rect.left + tlcWidth, rect.top + tlcHeight, rect.right - trcWidth, rect.bottom - blcHeight }, &UI::BACKGROUND_RECT);
 }
 
 void Game::RenderTopPanel() {
+   PROFILE_SCOPE("Game::RenderTopPanel");
    long width, height;
    GetDefaultSize(width, height);
 
    textureSpriteBatch_->Begin(
       DirectX::DX11::SpriteSortMode::SpriteSortMode_Deferred,
-      states_->NonPremultiplied(), states_->LinearWrap());
+      states_->NonPremultiplied(), states_->PointClamp());
 
    RECT size = { 0, 0, width, UI::TOP_PANEL_HEIGHT };
    RenderPanel(size);
@@ -429,13 +621,11 @@ void Game::RenderTopPanel() {
 }
 
 void Game::RenderNumber(DirectX::XMFLOAT2& pos, int number) {
-   auto digits = GetDigits(number);
+   std::array<char, UI::MINES_COUNT_CHAR_NUMBER> buffer;
+   auto digits = GetDigits(number, buffer);
 
    // indent
-   auto indentNumber = UI::MINES_COUNT_CHAR_NUMBER - digits.size();
-   for (auto i = 0; i < indentNumber; i++) {
-      pos.x += Texture::NUMBER_WIDTH;
-   }
+   pos.x += Texture::NUMBER_WIDTH * float(buffer.size() - digits.size());
    // digits
    for (auto digit : digits) {
       if (digit == '-') {
@@ -451,7 +641,7 @@ void Game::RenderNumber(DirectX::XMFLOAT2& pos, int number) {
 }
 
 void Game::RenderMinesNumber() {
-   int minesAndFlagged = MINES_COUNT - data_.flagged;
+   int minesAndFlagged = data_.board.Mines() - int(data_.board.Flagged());
    DirectX::XMFLOAT2 at = { 10, 40 };
    RECT size = { at.x, at.y - 10, at.x + Texture::NUMBER_WIDTH * UI::MINES_COUNT_CHAR_NUMBER + 10, at.y + Texture::NUMBER_HEIGHT + 10 };
    RenderPanel(size, PanelState::In);
@@ -480,54 +670,225 @@ void Game::RenderTimer() {
    DirectX::XMFLOAT2 at = { float(width - timerWidth) - marginRight, 40 };
    RECT size = { at.x, at.y - 10, at.x + timerWidth, at.y + Texture::NUMBER_HEIGHT + 10 };
    RenderPanel(size, PanelState::In);
-   RenderNumber(at, data_.timer);
+   RenderNumber(at, int(data_.clock.Seconds()));
+}
+
+void Game::CreateTileMap(UINT atlasWidth, UINT atlasHeight) {
+   auto vertexCode = Shaders::Compile(Shaders::TILE_MAP, "VSMain", "vs_5_0");
+   auto pixelCode = Shaders::Compile(Shaders::TILE_MAP, "PSMain", "ps_5_0");
+   auto lodCode = Shaders::Compile(Shaders::TILE_MAP, "PSLod", "ps_5_0");
+   DX::ThrowIfFailed(d3d_.device_->CreateVertexShader(vertexCode->GetBufferPointer(), vertexCode->GetBufferSize(), nullptr,
+      tileVertexShader_.ReleaseAndGetAddressOf()), "Failed to create the tile vertex shader");
+   DX::ThrowIfFailed(d3d_.device_->CreatePixelShader(pixelCode->GetBufferPointer(), pixelCode->GetBufferSize(), nullptr,
+      tilePixelShader_.ReleaseAndGetAddressOf()), "Failed to create the tile pixel shader");
+   DX::ThrowIfFailed(d3d_.device_->CreatePixelShader(lodCode->GetBufferPointer(), lodCode->GetBufferSize(), nullptr,
+      lodPixelShader_.ReleaseAndGetAddressOf()), "Failed to create the block pixel shader");
+
+   auto cells = UINT(tiles_.Instances().size());
+   CD3D11_BUFFER_DESC bufferDesc(cells * sizeof(TileInstance), D3D11_BIND_SHADER_RESOURCE);
+   DX::ThrowIfFailed(d3d_.device_->CreateBuffer(&bufferDesc, nullptr, tileBuffer_.ReleaseAndGetAddressOf()), "Failed to create the tile buffer");
+   CD3D11_SHADER_RESOURCE_VIEW_DESC viewDesc(tileBuffer_.Get(), DXGI_FORMAT_R32_UINT, 0, cells);
+   DX::ThrowIfFailed(d3d_.device_->CreateShaderResourceView(tileBuffer_.Get(), &viewDesc, tileView_.ReleaseAndGetAddressOf()), "Failed to create the tile view");
+
+   lodBuffers_.resize(lod_.Levels());
+   lodViews_.resize(lod_.Levels());
+   for (auto level = 1; level <= lod_.Levels(); level++) {
+      auto blocks = UINT(lod_.Instances(level).size());
+      CD3D11_BUFFER_DESC lodDesc(blocks * sizeof(LodInstance), D3D11_BIND_SHADER_RESOURCE);
+      DX::ThrowIfFailed(d3d_.device_->CreateBuffer(&lodDesc, nullptr, lodBuffers_[level - 1].ReleaseAndGetAddressOf()), "Failed to create a block buffer");
+      CD3D11_SHADER_RESOURCE_VIEW_DESC lodViewDesc(lodBuffers_[level - 1].Get(), DXGI_FORMAT_R32_UINT, 0, blocks);
+      DX::ThrowIfFailed(d3d_.device_->CreateShaderResourceView(lodBuffers_[level - 1].Get(), &lodViewDesc, lodViews_[level - 1].ReleaseAndGetAddressOf()), "Failed to create a block view");
+   }
+
+   auto rectOf = [](RECT const& rect) {
+      return DirectX::XMFLOAT4(float(rect.left), float(rect.top), float(rect.right - rect.left), float(rect.bottom - rect.top));
+   };
+   auto colorOf = [](DirectX::XMVECTORF32 const& color) {
+      return DirectX::XMFLOAT4(color.f[0], color.f[1], color.f[2], color.f[3]);
+   };
+   Shaders::TileConstants constants = {};
+   constants.viewportSize = { float(width_), float(height_) };
+   constants.cellSize = { CELL_WIDTH, CELL_HEIGHT };
+   constants.atlasSize = { float(atlasWidth), float(atlasHeight) };
+   constants.numberScale = Texture::SCALING * Texture::SCALING;
+   constants.markScale = Texture::SCALING;
+   constants.cellRect = rectOf(Texture::CELL_RECT);
+   constants.flagRect = rectOf(Texture::FLAG_RECT);
+   constants.questionRect = rectOf(Texture::QUESTION_MARK_RECT);
+   constants.mineRect = rectOf(Texture::MINE_RECT);
+   constants.digitRect = rectOf(Texture::GetDigitRect(0));
+   constants.offsets = { 6, 2, NUMBER_WIDTH_HALF, NUMBER_HEIGHT_HALF };
+   constants.background = colorOf(DirectX::Colors::Gray);
+   constants.lodCovered = colorOf(DirectX::Colors::LightGray);
+   constants.lodFlagged = colorOf(DirectX::Colors::Red);
+   constants.lodMine = colorOf(DirectX::Colors::Black);
+   for (std::size_t i = 0; i < NUMBER_TINTS.size(); i++) {
+      constants.tints[i] = colorOf(NUMBER_TINTS[i]);
+   }
+   CD3D11_BUFFER_DESC constantsDesc(sizeof(constants), D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_IMMUTABLE);
+   D3D11_SUBRESOURCE_DATA constantsData = { &constants, 0, 0 };
+   DX::ThrowIfFailed(d3d_.device_->CreateBuffer(&constantsDesc, &constantsData, tileConstants_.ReleaseAndGetAddressOf()), "Failed to create the tile constants");
+   CD3D11_BUFFER_DESC cameraDesc(sizeof(Shaders::CameraConstants), D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE);
+   DX::ThrowIfFailed(d3d_.device_->CreateBuffer(&cameraDesc, nullptr, cameraConstants_.ReleaseAndGetAddressOf()), "Failed to create the camera constants");
+
+   dirtyCells_.MarkAll();
 }
 
-void Game::RenderGameField() {
-   textureSpriteBatch_->Begin(
-      DirectX::DX11::SpriteSortMode::SpriteSortMode_Deferred,
-      states_->NonPremultiplied(), states_->LinearWrap());
-
-   for (auto x = 0; x < CELLS_X; x++) {
-      for (auto y = 0; y < CELLS_Y; y++) {
-         DirectX::XMFLOAT2 at = { float(x * CELL_WIDTH), float(y * CELL_HEIGHT) + UI::TOP_PANEL_HEIGHT };
-         auto cell = GetCell(x, y);
-         if (!cell->opened) {
-            auto color = cell->pressed ? DirectX::Colors::Red : DirectX::Colors::White;
-            Draw(at, &Texture::CELL_RECT, color, Texture::SCALING);
-            if (data_.gameState == GameState::Defeat && cell->mined) {
-               Draw(at, &Texture::MINE_RECT, DirectX::Colors::White, Texture::SCALING);
-            }
-            if (cell->IsMarked()) {
-               DirectX::XMFLOAT2 at = { float(x * CELL_WIDTH) + 6,
-                                       float(y * CELL_HEIGHT) + 2 + UI::TOP_PANEL_HEIGHT };
-               auto texture = cell->state == RCellState::Flagged ? &Texture::FLAG_RECT : &Texture::QUESTION_MARK_RECT;
-               Draw(at, texture, DirectX::Colors::White, Texture::SCALING);
-            }
-         }
-         else if (cell->mined) {
-            Draw(at, &Texture::MINE_RECT, DirectX::Colors::White, Texture::SCALING);
-         }
-         else if (cell->minesNear > 0) {
-            DirectX::XMFLOAT2 at = { float(x * CELL_WIDTH) + NUMBER_WIDTH_HALF,
-                                    float(y * CELL_HEIGHT) + NUMBER_HEIGHT_HALF + UI::TOP_PANEL_HEIGHT };
-            auto rect = Texture::GetDigitRect(cell->minesNear);
-            Draw(at, &rect, NUMBER_TINTS[cell->minesNear - 1], Texture::SCALING * Texture::SCALING);
-         }
+// Rebuilds the tiles and blocks of the dirty cells and uploads the ranges
+// around them.
+void Game::UpdateTileMap() {
+   if (dirtyCells_.Empty()) return;
+   PROFILE_SCOPE("Game::UpdateTileMap");
+
+   TileView view = { data_.pressed, showOdds_ ? &odds_ : nullptr };
+   if (dirtyCells_.All()) {
+      tiles_.Build(data_.board, view);
+      lod_.Build(tiles_);
+   }
+   else {
+      tiles_.Update(data_.board, dirtyCells_.Cells(), view);
+      lod_.Update(tiles_, dirtyCells_.Cells());
+   }
+   dirtyCells_.Clear();
+
+   auto upload = [this](ID3D11Buffer* buffer, std::span<InstanceRange const> ranges, auto const* instances) {
+      auto stride = sizeof(*instances);
+      for (auto range : ranges) {
+         D3D11_BOX box = { UINT(range.first * stride), 0, 0, UINT(range.last * stride), 1, 1 };
+         d3d_.ctx_->UpdateSubresource(buffer, 0, &box, instances + range.first, 0, 0);
+      }
+   };
+   upload(tileBuffer_.Get(), tiles_.Changed(), tiles_.Instances().data());
+   tiles_.ClearChanged();
+   for (auto level = 1; level <= lod_.Levels(); level++) {
+      upload(lodBuffers_[level - 1].Get(), lod_.Changed(level), lod_.Instances(level).data());
+   }
+   lod_.ClearChanged();
+}
+
+// Clicks and marks go to the cell under the release. The wheel zooms about
+// the pointer and dragging with the middle button scrolls.
+void Game::ApplyInput(InputAction const& action) {
+   auto playing = data_.board.State() == GameState::Play;
+   switch (action.kind) {
+   case InputActionKind::Hover:
+      Select(action.x, action.y);
+      break;
+   case InputActionKind::Press:
+      // drawn from the held button once the events are applied
+      break;
+   case InputActionKind::Click:
+      if (playing && data_.board.Contains(selectedCell_.x, selectedCell_.y)) {
+         ClickAt(selectedCell_.x, selectedCell_.y);
+         inputLatency_.Add(InputEvent::Clock::now() - action.time);
       }
+      if (PtInRect(&restartButtonRect_, POINT(action.x, action.y))) Restart();
+      break;
+   case InputActionKind::Mark:
+      if (playing && data_.board.Contains(selectedCell_.x, selectedCell_.y)) {
+         MarkAt(selectedCell_.x, selectedCell_.y);
+         inputLatency_.Add(InputEvent::Clock::now() - action.time);
+      }
+      break;
+   case InputActionKind::Pan:
+      camera_.Pan(float(action.dx), float(action.dy));
+      break;
+   case InputActionKind::Zoom:
+      if (action.y >= UI::TOP_PANEL_HEIGHT) {
+         camera_.ZoomAt(std::pow(UI::ZOOM_STEP, action.notches), float(action.x), float(action.y - UI::TOP_PANEL_HEIGHT));
+      }
+      break;
+   case InputActionKind::Key:
+      if (action.key == VK_ESCAPE) ExitGame();
+      if (action.key == 'P') {
+         showOdds_ = !showOdds_;
+         if (showOdds_) UpdateOdds();
+         dirtyCells_.MarkAll();
+         frames_.Invalidate(Dirty::BoardChanged);
+      }
+      break;
    }
+}
 
-   textureSpriteBatch_->End();
+// Held arrow keys scroll at a steady speed.
+void Game::ScrollWithKeys(GameClock::Duration dt) {
+   auto horizontal = int(dispatcher_.KeyHeld(VK_LEFT)) - int(dispatcher_.KeyHeld(VK_RIGHT));
+   auto vertical = int(dispatcher_.KeyHeld(VK_UP)) - int(dispatcher_.KeyHeld(VK_DOWN));
+   if (horizontal == 0 && vertical == 0) return;
+   auto step = UI::PAN_SPEED * std::min(dt, UI::PAN_STEP_LIMIT).count() / 1e6f;
+   camera_.Pan(horizontal * step, vertical * step);
+   // keep scrolling while the key is held, as no messages come
+   frames_.WakeAt(FrameScheduler::Clock::now() + frames_.Interval());
+}
+
+// Four vertices per cell, generated in the vertex shader, so no vertex buffer
+// or input layout is bound. Only the cells in view are drawn, so the cost
+// follows the window rather than the board; zoomed far out they are drawn
+// as blocks of a TileLod level.
+void Game::RenderGameField() {
+   PROFILE_SCOPE("Game::RenderGameField");
+   auto level = camera_.LodLevel(lod_.Levels());
+   auto block = 1 << level;
+   auto visible = camera_.Visible(block);
+   if (visible.Empty()) return;
+
+   auto ctx = d3d_.ctx_.Get();
+   Shaders::CameraConstants camera = {
+      { camera_.OriginX(), UI::TOP_PANEL_HEIGHT + camera_.OriginY() },
+      camera_.CellPixels() * block,
+      std::uint32_t(level == 0 ? tiles_.Width() : lod_.Width(level)),
+      { std::uint32_t(visible.x0), std::uint32_t(visible.y0) },
+      std::uint32_t(visible.Width()),
+      0,
+   };
+   D3D11_MAPPED_SUBRESOURCE mapped;
+   DX::ThrowIfFailed(ctx->Map(cameraConstants_.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped), "Failed to map the camera constants");
+   std::memcpy(mapped.pData, &camera, sizeof(camera));
+   ctx->Unmap(cameraConstants_.Get(), 0);
+
+   ID3D11Buffer* constants[] = { tileConstants_.Get(), cameraConstants_.Get() };
+   ctx->IASetInputLayout(nullptr);
+   ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+   ctx->VSSetShader(tileVertexShader_.Get(), nullptr, 0);
+   ctx->VSSetConstantBuffers(0, 2, constants);
+   ctx->VSSetShaderResources(1, 1, level == 0 ? tileView_.GetAddressOf() : lodViews_[level - 1].GetAddressOf());
+   ctx->PSSetShader(level == 0 ? tilePixelShader_.Get() : lodPixelShader_.Get(), nullptr, 0);
+   ctx->PSSetConstantBuffers(0, 1, tileConstants_.GetAddressOf());
+   ctx->PSSetShaderResources(0, 1, texture_.GetAddressOf());
+   auto sampler = states_->LinearClamp();
+   ctx->PSSetSamplers(0, 1, &sampler);
+   ctx->OMSetBlendState(states_->Opaque(), nullptr, 0xFFFFFFFF);
+   ctx->OMSetDepthStencilState(states_->DepthNone(), 0);
+   ctx->RSSetState(states_->CullNone());
+   ctx->DrawInstanced(4, UINT(visible.Width() * visible.Height()), 0, 0);
 }
 
 void Game::Render() {
    if (d3d_.ctx_ == 0) return;
+   frames_.Frame(*this, FrameScheduler::Clock::now());
+}
+
+FrameScheduler::Clock::duration Game::Idle() const {
+   return frames_.Idle(FrameScheduler::Clock::now());
+}
+
+std::size_t Game::RenderFrame(std::uint32_t dirty) {
+   UNREFERENCED_PARAMETER(dirty);
+   PROFILE_SCOPE("Game::Render");
+   PROFILE_ALLOCATIONS("allocations in Game::Render");
 
+   sprites_ = 0;
+   UpdateTileMap();
    d3d_.ctx_->ClearRenderTargetView(d3d_.renderTargetView_.Get(),
       DirectX::Colors::Gray);
 
-   RenderTopPanel();
+   // the field first, so cells scrolled under the panel are covered
    RenderGameField();
+   RenderTopPanel();
+   PROFILE_COUNT("sprites", sprites_);
+   return sprites_;
+}
 
-   d3d_.swapChain_->Present(1, 0);
+void Game::PresentFrame(bool vsync) {
+   d3d_.swapChain_->Present(vsync ? 1 : 0, 0);
 }
\ No newline at end of file
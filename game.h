@@ -2,26 +2,24 @@
 
 #include "DeviceManager.h"
 #include "SoundSystem.h"
-#include "Cell.h"
+#include "Engine/Allocations.h"
+#include "Engine/AssetLoader.h"
+#include "Engine/AssetPack.h"
+#include "Engine/Board.h"
+#include "Engine/BoardPool.h"
+#include "Engine/Camera.h"
+#include "Engine/DirtyCells.h"
+#include "Engine/FrameScheduler.h"
+#include "Engine/GameClock.h"
+#include "Engine/Input.h"
+#include "Engine/NoGuess.h"
+#include "Engine/Probability.h"
+#include "Engine/Profiler.h"
+#include "Engine/Replay.h"
+#include "Engine/TileLod.h"
+#include "Engine/TileMap.h"
 
 
-// percentage of mines
-enum Difficulty {
-   Easy = 10,
-   Medium = 15,
-   Hard = 20,
-   Impossible = 25
-};
-
-enum GameState {
-   Play, Win, Defeat
-};
-
-auto constexpr CELLS_X = 40;
-auto constexpr CELLS_Y = 20;
-int constexpr MINES_COUNT = CELLS_X * CELLS_Y / 100.0f * Difficulty::Hard;
-auto constexpr NEED_TO_OPEN = CELLS_X * CELLS_Y - MINES_COUNT;
-
 const std::array<DirectX::XMVECTORF32, 8> NUMBER_TINTS = {
    DirectX::Colors::Black,
    DirectX::Colors::Magenta,
@@ -33,72 +31,79 @@ const std::array<DirectX::XMVECTORF32, 8> NUMBER_TINTS = {
    DirectX::Colors::Honeydew,
 };
 
-struct Pos {
-   int x;
-   int y;
-
-   bool IsInBounds() {
-      return (x >= 0 && x < CELLS_X && y >= 0 && y < CELLS_Y);
-   }
-};
-
 struct GameData {
-   std::array<std::array<Cell, CELLS_Y>, CELLS_X> cells = {};
+   Board board;
+   std::vector<Pos> pressed = {};
 
-   GameState gameState = GameState::Play;
-   UINT opened = 0;
-   UINT flagged = 0;
-   bool started = false;
-   UINT timer = 0;
+   // runs from the first click to the end of the game
+   GameClock clock = {};
 };
 
 enum PanelState : BYTE {
    In, Out
 };
 
-class Game {
+class Game : public FrameRenderer {
 public:
+   // No-guess games pick their board at the first click, see NoGuess.h.
+   explicit Game(BoardSize size = DEFAULT_SIZE, bool noGuess = false, FrameScheduler frames = FrameScheduler());
    ~Game();
    void GetDefaultSize(long& width, long& height);
    bool ExitGame();
 
-   void OnMouseMove();
+   // Queued from the window procedure and applied in order by Update.
+   void OnInput(InputEvent const& event);
+   void OnPaint();
 
    bool Init(HINSTANCE hInstance, HWND hwnd);
    bool LoadContent();
-   void Update(float dt);
-   void Thread();
+   void OpenPack();
+   void LoadTexture();
+   void CreatePackedTexture();
+   void LogAssetTimings();
+   // `dt` is the time since the last update; it drives the game clock.
+   void Update(GameClock::Duration dt);
+   // Draws a frame only when the scheduler says one is due.
    void Render();
+   // How long the main loop may wait for input, see FrameScheduler::Idle.
+   FrameScheduler::Clock::duration Idle() const;
+
+   std::size_t RenderFrame(std::uint32_t dirty) override;
+   void PresentFrame(bool vsync) override;
 
 private:
-   void InitCells();
-   void InitMines(int x, int y);
-   Cell* GetCell(int x, int y);
-   void OpenAt(int x, int y);
-   void IterateAll(std::function<void(Cell* cell)> cb);
-   void IterateNear(int originX, int originY, std::function<void(int, int)> cb);
-   void ExploreMap(int originX, int originY);
-   void OpenNearForced(int originX, int originY);
    void PressedAround(int originX, int originY);
    void UnpressedAll();
+   bool IsPressed(int x, int y);
    void ClickAt(int x, int y);
+   // Opens (x, y) on the current board, which is chosen by now.
+   void OpenAt(int x, int y);
+   // Plays the waiting first click of a no-guess game once its board is found.
+   void PollNoGuess();
    void MarkAt(int x, int y);
+   void OnAction(ActionResult const& result);
+   void UpdateOdds();
    bool IsCellSelected(int x, int y);
-   void Start(int x, int y);
-   void Defeat();
-   void Win();
    void Restart();
+   void Record(ReplayAction action, int x, int y);
+   void EndReplay();
 
-   std::vector<char> GetDigits(int number);
+   std::span<char const> GetDigits(int number, std::span<char> buffer);
 
    void Draw(DirectX::XMFLOAT2 const& pos, RECT const* sourceRectangle, DirectX::FXMVECTOR color, float scaling, DirectX::SpriteEffects effects);
    void Draw(DirectX::XMFLOAT2 const& pos, RECT const* sourceRectangle, DirectX::SpriteEffects effects);
+   void Stretch(RECT const& destination, RECT const* sourceRectangle, DirectX::SpriteEffects effects);
    void RenderPanel(RECT size, PanelState state);
    void RenderTopPanel();
    void RenderNumber(DirectX::XMFLOAT2& pos, int number);
    void RenderMinesNumber();
    void RenderRestartButton();
    void RenderTimer();
+   void CreateTileMap(UINT atlasWidth, UINT atlasHeight);
+   void UpdateTileMap();
+   void Select(int x, int y);
+   void ApplyInput(InputAction const& action);
+   void ScrollWithKeys(GameClock::Duration dt);
    void RenderGameField();
 
    HINSTANCE hInstance_;
@@ -107,25 +112,67 @@ private:
    long height_;
 
    DeviceManager d3d_ = {};
+   // the cooked assets, mapped; the sounds play straight from it
+   std::unique_ptr<AssetPack> pack_;
    SoundSystem sound_ = {};
 
-   std::unique_ptr<DirectX::Keyboard> keyboard_;
-   DirectX::Keyboard::KeyboardStateTracker keyTracker_;
-
-   std::unique_ptr<DirectX::Mouse> mouse_;
-   DirectX::Mouse::Mouse::ButtonStateTracker mouseTracker_;
-   bool leftHeld_ = false;
+   InputQueue input_;
+   InputDispatcher dispatcher_;
+   std::vector<InputAction> actions_;
+   // from a click or mark reaching the window to the board changing
+   LatencyStats inputLatency_;
 
    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> texture_;
+   // after the sounds and the texture, as its loads store into them
+   TaskPool loadPool_;
+   AssetLoader assets_{ loadPool_ };
+   bool assetsReady_ = false;
+   // The field is one instanced draw over a tile per cell, see TileMap.h;
+   // only the tiles of dirty cells are rebuilt and uploaded.
+   Microsoft::WRL::ComPtr<ID3D11Buffer> tileBuffer_;
+   Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> tileView_;
+   Microsoft::WRL::ComPtr<ID3D11Buffer> tileConstants_;
+   Microsoft::WRL::ComPtr<ID3D11Buffer> cameraConstants_;
+   Microsoft::WRL::ComPtr<ID3D11VertexShader> tileVertexShader_;
+   Microsoft::WRL::ComPtr<ID3D11PixelShader> tilePixelShader_;
+   // zoomed out, the blocks of a TileLod level are drawn instead of the cells
+   std::vector<Microsoft::WRL::ComPtr<ID3D11Buffer>> lodBuffers_;
+   std::vector<Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>> lodViews_;
+   Microsoft::WRL::ComPtr<ID3D11PixelShader> lodPixelShader_;
    std::unique_ptr<DirectX::SpriteBatch> textureSpriteBatch_;
    std::unique_ptr<DirectX::CommonStates> states_;
    DirectX::SimpleMath::Vector2 origin_;
+   // sprites submitted in the current frame
+   std::size_t sprites_ = 0;
 
    RECT restartButtonRect_ = {};
    bool restartButtonPressed_ = false;
    Pos selectedCell_ = {};
-
+   // what was pressed last update, to tell whether the pressed cells changed
+   std::vector<Pos> pressedBefore_;
+   FrameScheduler frames_;
+   // mine chances tinted over the covered cells, toggled with P
+   bool showOdds_ = false;
+   ProbabilityGrid odds_ = {};
+
+   BoardSize size_;
+   bool noGuess_;
+   // the first click of a no-guess game, while the pool searches for its board
+   std::optional<Pos> noGuessClick_;
    GameData data_;
+   // the next board is ready before Restart asks for it
+   BoardPool boards_;
+   DirtyCells dirtyCells_;
+   TileMap tiles_;
+   TileLod lod_;
+   // pans and zooms the field under the top panel
+   Camera camera_;
+
+   // the current game is written to disk as it is played, see Replay.h
+   bool recording_ = false;
+   std::filesystem::path replayPath_;
+   std::ofstream replayFile_;
+   std::optional<ReplayWriter> replay_;
 
    unsigned long time;
 };
@@ -6,14 +6,67 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
 
 namespace {
    std::unique_ptr<Game> game;
+
+   // Access violations and other structured exceptions do not reach the
+   // signal handlers FlushOnCrash installs.
+   LONG WINAPI OnUnhandledException(EXCEPTION_POINTERS*) {
+      if (Log::logger) {
+         Log::Error("Crashed: unhandled exception");
+         Log::logger->FlushFromCrash();
+      }
+      return EXCEPTION_CONTINUE_SEARCH;
+   }
+
+   // Stamped here rather than when the game gets to it, so the latency it
+   // measures includes waiting for the next update.
+   InputEvent MakeEvent(InputKind kind, std::uint8_t code, int x = 0, int y = 0, int wheel = 0) {
+      return { kind, code, x, y, wheel, InputEvent::Clock::now() };
+   }
+
+   InputEvent PointerEvent(InputKind kind, std::uint8_t code, LPARAM lParam) {
+      return MakeEvent(kind, code, short(LOWORD(lParam)), short(HIWORD(lParam)));
+   }
+
+   // Held buttons keep reporting to the window when the pointer leaves it,
+   // so their release is not missed.
+   void Capture(HWND hwnd, WPARAM wParam) {
+      if (wParam & (MK_LBUTTON | MK_RBUTTON | MK_MBUTTON)) SetCapture(hwnd);
+      else ReleaseCapture();
+   }
 }
 
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE prevInstance, LPWSTR cmdLine,
    int cmdShow) {
    UNREFERENCED_PARAMETER(prevInstance);
-   UNREFERENCED_PARAMETER(cmdLine);
+   SetUnhandledExceptionFilter(OnUnhandledException);
+
+   // optional board size on the command line: "width height [mines] [--no-guess]"
+   auto size = DEFAULT_SIZE;
+   auto parsed = swscanf_s(cmdLine, L"%d %d %d", &size.width, &size.height, &size.mines);
+   if (parsed == 2) size.mines = MinesFor(size.width, size.height, Difficulty::Hard);
+   auto noGuess = wcsstr(cmdLine, L"--no-guess") != nullptr;
+
+   // frame pacing: vsync by default, "--fps=N" for a fixed cap, "--on-demand"
+   // to draw only when something changes, e.g. on kiosk machines
+   auto frameMode = FrameMode::VSync;
+   auto frameInterval = std::chrono::duration_cast<FrameScheduler::Clock::duration>(FrameScheduler::DEFAULT_INTERVAL);
+   auto fps = 0;
+   if (auto option = wcsstr(cmdLine, L"--fps="); option && swscanf_s(option, L"--fps=%d", &fps) == 1 && fps > 0) {
+      frameMode = FrameMode::Capped;
+      frameInterval = std::chrono::duration_cast<FrameScheduler::Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+   }
+   if (wcsstr(cmdLine, L"--on-demand") != nullptr) frameMode = FrameMode::OnDemand;
 
-   game = std::make_unique<Game>();
+   try {
+      game = std::make_unique<Game>(size, noGuess, FrameScheduler(frameMode, frameInterval));
+   }
+   catch (const std::invalid_argument& exc) {
+      // the log is opened by Init, so tell the player directly
+      auto message = std::string("Cannot start a game of this size: ") + exc.what() +
+         "\n\nUsage: width height [mines] [--no-guess] [--fps=N] [--on-demand]";
+      MessageBoxA(nullptr, message.c_str(), "Minesweeper", MB_OK | MB_ICONERROR);
+      return -1;
+   }
 
    WNDCLASSEX wndClass = { 0 };
    wndClass.cbSize = sizeof(WNDCLASSEX);
@@ -48,13 +101,10 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE prevInstance, LPWSTR cmdLine,
 
    if (result == false) return -1;
 
-   std::thread thread([]() {
-      while (true) {
-         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-         game->Thread();
-      }
-      });
-   thread.detach();
+   // the frame start advances by whole microseconds only, so the remainder
+   // of each step carries over to the next and the game clock cannot drift;
+   // time spent minimised is dropped, pausing the game
+   auto frameStart = std::chrono::steady_clock::now();
 
    MSG msg = {};
    while (msg.message != WM_QUIT) {
@@ -62,10 +112,23 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE prevInstance, LPWSTR cmdLine,
          TranslateMessage(&msg);
          DispatchMessage(&msg);
       }
+      else if (IsIconic(hwnd)) {
+         // nothing to show: sleep until a message comes
+         WaitMessage();
+         frameStart = std::chrono::steady_clock::now();
+      }
       else {
-         if (!IsIconic(hwnd)) {
-            game->Update(0.0f);
-            game->Render();
+         auto dt = std::chrono::duration_cast<GameClock::Duration>(std::chrono::steady_clock::now() - frameStart);
+         frameStart += dt;
+         game->Update(dt);
+         game->Render();
+
+         // sleep until the next frame is due or input arrives
+         auto idle = game->Idle();
+         if (idle > FrameScheduler::Clock::duration::zero()) {
+            auto timeout = idle == FrameScheduler::Clock::duration::max() ? INFINITE :
+               DWORD(std::min<long long>(std::chrono::ceil<std::chrono::milliseconds>(idle).count(), INFINITE - 1));
+            MsgWaitForMultipleObjects(0, nullptr, FALSE, timeout, QS_ALLINPUT);
          }
       }
    }
@@ -80,38 +143,44 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam,
 
    switch (message) {
    case WM_ACTIVATEAPP:
-      DirectX::Keyboard::ProcessMessage(message, wParam, lParam);
-      DirectX::Mouse::ProcessMessage(message, wParam, lParam);
+      if (!wParam && game) game->OnInput(MakeEvent(InputKind::Cancel, 0));
       break;
    case WM_MOUSEMOVE:
-      game->OnMouseMove();
-      DirectX::Mouse::ProcessMessage(message, wParam, lParam);
+      if (game) game->OnInput(PointerEvent(InputKind::PointerMove, 0, lParam));
       break;
-   case WM_ACTIVATE:
-   case WM_INPUT:
-   case WM_LBUTTONUP:
    case WM_LBUTTONDOWN:
    case WM_RBUTTONDOWN:
-   case WM_RBUTTONUP:
    case WM_MBUTTONDOWN:
-   case WM_MBUTTONUP:
-   case WM_MOUSEWHEEL:
-   case WM_XBUTTONDOWN:
-   case WM_XBUTTONUP:
-   case WM_MOUSEHOVER:
-      DirectX::Mouse::ProcessMessage(message, wParam, lParam);
+   case WM_LBUTTONUP:
+   case WM_RBUTTONUP:
+   case WM_MBUTTONUP: {
+      auto down = message == WM_LBUTTONDOWN || message == WM_RBUTTONDOWN || message == WM_MBUTTONDOWN;
+      auto button = message == WM_LBUTTONDOWN || message == WM_LBUTTONUP ? MouseButton::Left :
+         message == WM_RBUTTONDOWN || message == WM_RBUTTONUP ? MouseButton::Right : MouseButton::Middle;
+      Capture(hwnd, wParam);
+      if (game) game->OnInput(PointerEvent(down ? InputKind::ButtonDown : InputKind::ButtonUp, std::uint8_t(button), lParam));
+      break;
+   }
+   case WM_MOUSEWHEEL: {
+      // in screen coordinates, unlike the other mouse messages
+      POINT point = { short(LOWORD(lParam)), short(HIWORD(lParam)) };
+      ScreenToClient(hwnd, &point);
+      if (game) game->OnInput(MakeEvent(InputKind::Wheel, 0, point.x, point.y, GET_WHEEL_DELTA_WPARAM(wParam)));
       break;
+   }
    case WM_KEYDOWN:
+   case WM_SYSKEYDOWN:
+      // bit 30 is set on auto-repeat
+      if (!(lParam & (1 << 30)) && game) game->OnInput(MakeEvent(InputKind::KeyDown, std::uint8_t(wParam)));
+      break;
    case WM_KEYUP:
    case WM_SYSKEYUP:
-      DirectX::Keyboard::ProcessMessage(message, wParam, lParam);
-      break;
-   case WM_SYSKEYDOWN:
-      DirectX::Keyboard::ProcessMessage(message, wParam, lParam);
+      if (game) game->OnInput(MakeEvent(InputKind::KeyUp, std::uint8_t(wParam)));
       break;
    case WM_PAINT:
       hDC = BeginPaint(hwnd, &paintStruct);
       EndPaint(hwnd, &paintStruct);
+      if (game) game->OnPaint();
       break;
    case WM_DESTROY:
       game->ExitGame();
@@ -37,12 +37,11 @@
 #include <wrl/client.h>
 
 #include <d3d11_1.h>
+#include <d3dcompiler.h>
 #include <dxgi1_2.h>
 #include <DirectXMath.h>
 #include <DirectXColors.h>
 
-#include <Keyboard.h>
-#include <Mouse.h>
 #include <CommonStates.h>
 #include <SimpleMath.h>
 #include <SpriteBatch.h>
@@ -54,9 +53,12 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <exception>
+#include <filesystem>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <tuple>
 #include <array>
@@ -66,13 +68,44 @@
 #include <chrono>
 #include <thread>
 
+#include "Engine/Logger.h"
+
+// Entries are queued and written by a background thread, see Engine/Logger.h.
+// Nothing is kept before Open or after Close.
 namespace Log {
-   inline std::ofstream file;
-   inline void Info(char const* const message) {
-      file << "Info: " << message << std::endl;
+   inline std::unique_ptr<Logger> logger;
+
+   inline void Open(LoggerOptions options) {
+      logger = std::make_unique<Logger>(std::move(options));
+      FlushOnCrash(logger.get());
+   }
+   inline void Close() {
+      logger.reset();
+   }
+   inline void Info(std::string_view message) {
+      if (logger) logger->Write(LogLevel::Info, message);
    }
-   inline void Error(char const* const message) {
-      file << "Error: " << message << std::endl;
+   inline void Error(std::string_view message) {
+      if (logger) logger->Write(LogLevel::Error, message);
+   }
+   // Entries of numbers alone are copied into the queue and formatted by the
+   // writer thread; the rest are formatted straight into the queue, without
+   // a string in between.
+   template <typename... Args>
+   void Write(LogLevel level, std::format_string<Args const&...> format, Args const&... args) {
+      if (!logger || !logger->Enabled(level)) return;
+      if constexpr ((std::is_arithmetic_v<Args> && ...)) {
+         logger->Defer(level, [format, args...](char* buffer, std::size_t size) {
+            auto result = std::format_to_n(buffer, std::ptrdiff_t(size), format, args...);
+            return std::size_t(result.out - buffer);
+            });
+      }
+      else {
+         logger->Emplace(level, [&](char* buffer, std::size_t size) {
+            auto result = std::format_to_n(buffer, std::ptrdiff_t(size), format, args...);
+            return std::size_t(result.out - buffer);
+            });
+      }
    }
 }
 
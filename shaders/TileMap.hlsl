@@ -0,0 +1,125 @@
+//
+// TileMap.hlsl
+// Draws the field in one instanced call: four vertices per cell, with the
+// cell taken from the instance index and its picture from the tile map, see
+// Engine/TileMap.h. The layers SpriteBatch used to draw one by one are
+// blended here, in the pixel shader. Only the cells in view are drawn; zoomed
+// far out, an instance is a block of cells from Engine/TileLod.h instead.
+//
+
+// Tile, see Engine/TileMap.h
+#define TILE_COVERED 0
+#define TILE_FLAGGED 1
+#define TILE_QUESTIONED 2
+#define TILE_MINE 3
+#define TILE_EMPTY 4
+#define TILE_NUMBER 5
+
+#define FLAG_PRESSED 1
+#define FLAG_MINE_SHOWN 2
+#define FLAG_ODDS_SHOWN 4
+
+cbuffer TileConstants : register(b0) {
+   float2 viewportSize;
+   float2 cellSize;
+   float2 atlasSize;
+   float numberScale;
+   float markScale;
+   // atlas rectangles as x, y, width, height in texels
+   float4 cellRect;
+   float4 flagRect;
+   float4 questionRect;
+   float4 mineRect;
+   float4 digitRect; // the digit 0; digit n is n widths to the right
+   // where a layer starts in the cell, in pixels: mark in xy, number in zw
+   float4 offsets;
+   float4 background;
+   // blocks blend these by the share of their cells in each state
+   float4 lodCovered;
+   float4 lodFlagged;
+   float4 lodMine;
+   float4 tints[8];
+};
+
+// Changes with the camera, see Engine/Camera.h.
+cbuffer CameraConstants : register(b1) {
+   float2 fieldOrigin; // where cell 0, 0 is on screen
+   float blockSize;    // on-screen size of an instance, a cell or a block
+   uint levelWidth;    // instances per row of the bound tiles
+   uint2 rangeOrigin;  // the first visible instance
+   uint rangeWidth;    // visible instances per row
+   float padding;
+};
+
+Buffer<uint> tiles : register(t1);
+Texture2D atlas : register(t0);
+SamplerState atlasSampler : register(s0);
+
+struct Vertex {
+   float4 position : SV_Position;
+   float2 local : LOCAL;
+   nointerpolation uint tile : TILE; // a tile, or a block for PSLod
+};
+
+Vertex VSMain(uint vertex : SV_VertexID, uint instance : SV_InstanceID) {
+   float2 corner = float2(vertex & 1, vertex >> 1);
+   uint2 cell = rangeOrigin + uint2(instance % rangeWidth, instance / rangeWidth);
+   float2 pixel = fieldOrigin + (cell + corner) * blockSize;
+
+   Vertex result;
+   result.position = float4(pixel / viewportSize * float2(2, -2) + float2(-1, 1), 0, 1);
+   // layers are placed in unscaled cell pixels whatever the zoom
+   result.local = corner * cellSize;
+   result.tile = tiles[cell.y * levelWidth + cell.x];
+   return result;
+}
+
+// The atlas rectangle `rect` drawn from `offset` at `scale`; clear outside it.
+float4 Layer(float2 local, float4 rect, float2 offset, float scale) {
+   float2 texel = (local - offset) / scale;
+   if (any(texel < 0) || any(texel >= rect.zw)) return float4(0, 0, 0, 0);
+   return atlas.Sample(atlasSampler, (rect.xy + texel) / atlasSize);
+}
+
+float3 Over(float3 below, float4 above) {
+   return lerp(below, above.rgb, above.a);
+}
+
+float4 PSMain(Vertex input) : SV_Target {
+   uint tile = input.tile & 0xFF;
+   uint tint = (input.tile >> 8) & 0xFF;
+   float odds = ((input.tile >> 16) & 0xFF) / 255.0;
+   uint flags = input.tile >> 24;
+   float scale = cellSize.x / cellRect.z;
+
+   float3 color = background.rgb;
+   if (tile == TILE_MINE) {
+      color = Over(color, Layer(input.local, mineRect, float2(0, 0), scale));
+   }
+   else if (tile == TILE_NUMBER) {
+      float4 digit = digitRect + float4(tint * digitRect.z, 0, 0, 0);
+      color = Over(color, Layer(input.local, digit, offsets.zw, numberScale) * tints[tint - 1]);
+   }
+   else if (tile != TILE_EMPTY) {
+      float4 cover = Layer(input.local, cellRect, float2(0, 0), scale);
+      color = Over(color, (flags & FLAG_PRESSED) ? cover * float4(1, 0, 0, 1) : cover);
+      if (flags & FLAG_ODDS_SHOWN) color = Over(color, cover * float4(odds, 1 - odds, 0, .5));
+      if (flags & FLAG_MINE_SHOWN) color = Over(color, Layer(input.local, mineRect, float2(0, 0), scale));
+      if (tile == TILE_FLAGGED) color = Over(color, Layer(input.local, flagRect, offsets.xy, markScale));
+      if (tile == TILE_QUESTIONED) color = Over(color, Layer(input.local, questionRect, offsets.xy, markScale));
+   }
+   return float4(color, 1);
+}
+
+// A block: the shares of opened, flagged and mine cells, 0-255 from the
+// lowest byte up.
+float4 PSLod(Vertex input) : SV_Target {
+   float opened = (input.tile & 0xFF) / 255.0;
+   float flagged = ((input.tile >> 8) & 0xFF) / 255.0;
+   float mines = ((input.tile >> 16) & 0xFF) / 255.0;
+
+   float3 color = lerp(lodCovered.rgb, background.rgb, opened);
+   color = lerp(color, lodFlagged.rgb, flagged);
+   color = lerp(color, lodMine.rgb, mines);
+   return float4(color, 1);
+}
\ No newline at end of file